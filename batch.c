@@ -0,0 +1,567 @@
+/*******************************************************************************
+*  Soubor:   batch.c                                                           *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Dávkový  převod  GIF  na BMP. Úlohy se na začátku rozdělí do front všech   *
+*  vláken, vlákno bere úlohy z konce své fronty a po jejím vyprázdnění krade  *
+*  úlohy ze začátku front ostatních vláken. Jeden velký soubor tak nezdrží    *
+*  úlohy, které byly přiděleny stejnému vláknu.                               *
+*                                                                              *
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "gif2bmp.h"
+#include "batch.h"
+
+/*
+ * Struktura fronty úloh jednoho vlákna
+ *
+ * items - indexy úloh dávky
+ * head  - index první úlohy (odsud kradou ostatní vlákna)
+ * tail  - index za poslední úlohou (odsud bere vlastní vlákno)
+ * lock  - zámek fronty
+ */
+typedef struct {
+    size_t *items;
+    size_t head;
+    size_t tail;
+    pthread_mutex_t lock;
+} tBatchQueue;
+
+/*
+ * Struktura pracovního vlákna
+ *
+ * batch       - převáděná dávka
+ * options     - nastavení převodu
+ * queues      - fronty všech vláken
+ * threadCount - počet vláken
+ * index       - index vlákna (a jeho fronty)
+ * thread      - identifikátor vlákna
+ */
+typedef struct {
+    tBatch *batch;
+    const tGIF2BMPOptions *options;
+    tBatchQueue *queues;
+    unsigned threadCount;
+    unsigned index;
+    pthread_t thread;
+} tBatchWorker;
+
+/*
+ * Funkce pro vytvoření kopie řetězce
+ *
+ * string - kopírovaný řetězec
+ * length - délka kopírované části řetězce
+ *
+ * Návratová hodnota:
+ *     nově alokovaná kopie, NULL při chybě alokace
+ */
+static char *copyString(const char *string, size_t length) {
+    // Alokace kopie včetně ukončující nuly
+    char *copy = (char*)malloc(length + 1);
+    // Kontrola alokace
+    if(copy == NULL) {
+        return NULL;
+    }
+    // Kopírování znaků
+    memcpy(copy, string, length);
+    // Ukončení řetězce
+    copy[length] = '\0';
+    // Navrácení kopie
+    return copy;
+}
+
+/*
+ * Funkce pro přidání úlohy do dávky
+ *
+ * Názvy souborů přebírá dávka (uvolní je freeBatch).
+ *
+ * batch          - dávka
+ * inputFileName  - název vstupního souboru
+ * outputFileName - název výstupního souboru
+ *
+ * Návratová hodnota:
+ *      0 - úloha byla přidána
+ *     -1 - chyba alokace
+ */
+static int addBatchJob(tBatch *batch, char *inputFileName, char *outputFileName) {
+    // Kontrola názvů souborů
+    if(inputFileName == NULL || outputFileName == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: batch job malloc failed.\n");
+        // Uvolnění názvů
+        free(inputFileName);
+        free(outputFileName);
+        return RETURN_FAILURE;
+    }
+
+    // Pokud je pole úloh plné, zvětší se na dvojnásobek
+    if(batch->count == batch->capacity) {
+        // Nová velikost pole
+        size_t capacity = (batch->capacity == 0) ? BATCH_ALLOC_SIZE : batch->capacity * 2;
+        // Realokace pole úloh
+        tBatchJob *jobs = (tBatchJob*)realloc(batch->jobs, capacity * sizeof(tBatchJob));
+        // Kontrola realokace
+        if(jobs == NULL) {
+            // Tisk chyby
+            fprintf(stderr, "ERROR: batch->jobs realloc failed.\n");
+            // Uvolnění názvů
+            free(inputFileName);
+            free(outputFileName);
+            return RETURN_FAILURE;
+        }
+        // Uložení nového pole
+        batch->jobs = jobs;
+        batch->capacity = capacity;
+    }
+
+    // Vynulování nové úlohy
+    memset(&batch->jobs[batch->count], 0, sizeof(tBatchJob));
+    // Uložení názvů souborů
+    batch->jobs[batch->count].inputFileName = inputFileName;
+    batch->jobs[batch->count].outputFileName = outputFileName;
+    // Úloha zatím neproběhla
+    batch->jobs[batch->count].result = RETURN_FAILURE;
+    // Zvýšení počtu úloh
+    batch->count++;
+
+    // Úloha byla přidána
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro načtení dávky ze souboru manifestu
+ */
+int loadBatchManifest(tBatch *batch, const char *manifestFileName) {
+    // Buffer pro jeden řádek manifestu
+    char *line = NULL;
+    // Velikost bufferu řádku
+    size_t lineSize = 0;
+    // Délka načteného řádku
+    ssize_t lineLength = 0;
+    // Číslo aktuálního řádku
+    size_t lineNumber = 0;
+    // Proměnná pro výsledek načtení
+    int result = RETURN_SUCCESS;
+
+    // Otevření manifestu
+    FILE *manifest = fopen(manifestFileName, "r");
+    // Kontrola otevření
+    if(manifest == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "Cannot open manifest file '%s' for read\n", manifestFileName);
+        return RETURN_FAILURE;
+    }
+
+    // Čtení manifestu po řádcích
+    while(result == RETURN_SUCCESS && (lineLength = getline(&line, &lineSize, manifest)) != -1) {
+        // Zvýšení čísla řádku
+        lineNumber++;
+        // Odstranění konce řádku
+        while(lineLength > 0 && (line[lineLength - 1] == '\n' || line[lineLength - 1] == '\r')) {
+            line[--lineLength] = '\0';
+        }
+        // Prázdné řádky a komentáře se přeskakují
+        if(lineLength == 0 || line[0] == '#') {
+            continue;
+        }
+
+        // Hledání oddělovače (pouze tabulátor)
+        char *separator = strchr(line, '\t');
+        // Řádek bez oddělovače nebo bez některého z názvů
+        if(separator == NULL || separator == line || separator[1] == '\0') {
+            // Tisk chyby
+            fprintf(stderr, "ERROR: Invalid manifest line %zu: '%s'.\n", lineNumber, line);
+            result = RETURN_FAILURE;
+            break;
+        }
+
+        // Přidání úlohy
+        result = addBatchJob(batch, copyString(line, (size_t)(separator - line)), copyString(separator + 1, strlen(separator + 1)));
+    }
+
+    // Uvolnění bufferu řádku
+    free(line);
+    // Uzavření manifestu
+    fclose(manifest);
+
+    // Navrácení výsledku načtení
+    return result;
+}
+
+/*
+ * Funkce pro porovnání dvou úloh podle vstupního souboru (pro qsort)
+ */
+static int compareBatchJobs(const void *first, const void *second) {
+    // Porovnání názvů vstupních souborů
+    return strcmp(((const tBatchJob*)first)->inputFileName, ((const tBatchJob*)second)->inputFileName);
+}
+
+/*
+ * Funkce pro složení cesty k souboru v adresáři
+ *
+ * directory  - adresář
+ * name       - název souboru
+ * nameLength - délka použité části názvu
+ * suffix     - přípona přidaná za název
+ *
+ * Návratová hodnota:
+ *     nově alokovaná cesta, NULL při chybě alokace
+ */
+static char *makePath(const char *directory, const char *name, size_t nameLength, const char *suffix) {
+    // Délka adresáře
+    size_t directoryLength = strlen(directory);
+    // Délka přípony
+    size_t suffixLength = strlen(suffix);
+    // Alokace cesty (adresář + '/' + název + přípona + '\0')
+    char *path = (char*)malloc(directoryLength + 1 + nameLength + suffixLength + 1);
+    // Kontrola alokace
+    if(path == NULL) {
+        return NULL;
+    }
+    // Složení cesty
+    memcpy(path, directory, directoryLength);
+    path[directoryLength] = '/';
+    memcpy(path + directoryLength + 1, name, nameLength);
+    memcpy(path + directoryLength + 1 + nameLength, suffix, suffixLength + 1);
+    // Navrácení cesty
+    return path;
+}
+
+/*
+ * Funkce pro načtení dávky z adresáře
+ */
+int loadBatchDirectory(tBatch *batch, const char *inputDirectory, const char *outputDirectory) {
+    // Položka adresáře
+    struct dirent *entry = NULL;
+    // Informace o souboru
+    struct stat fileStat;
+    // Délka přípony vstupních souborů
+    size_t suffixLength = strlen(BATCH_INPUT_SUFFIX);
+    // Index první úlohy z adresáře
+    size_t firstJob = batch->count;
+    // Proměnná pro výsledek načtení
+    int result = RETURN_SUCCESS;
+
+    // Otevření vstupního adresáře
+    DIR *directory = opendir(inputDirectory);
+    // Kontrola otevření
+    if(directory == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "Cannot open input directory '%s' for read\n", inputDirectory);
+        return RETURN_FAILURE;
+    }
+
+    // Procházení položek adresáře
+    while(result == RETURN_SUCCESS && (entry = readdir(directory)) != NULL) {
+        // Délka názvu položky
+        size_t nameLength = strlen(entry->d_name);
+        // Přeskočení položek bez přípony .gif
+        if(nameLength <= suffixLength || strcmp(entry->d_name + nameLength - suffixLength, BATCH_INPUT_SUFFIX) != 0) {
+            continue;
+        }
+
+        // Cesta ke vstupnímu souboru
+        char *inputFileName = makePath(inputDirectory, entry->d_name, nameLength, "");
+        // Přeskočení položek, které nejsou běžné soubory
+        if(inputFileName != NULL && (stat(inputFileName, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))) {
+            free(inputFileName);
+            continue;
+        }
+
+        // Přidání úlohy (výstup má stejný název s příponou .bmp)
+        result = addBatchJob(batch, inputFileName, makePath(outputDirectory, entry->d_name, nameLength - suffixLength, BATCH_OUTPUT_SUFFIX));
+    }
+
+    // Uzavření adresáře
+    closedir(directory);
+
+    // Seřazení úloh z adresáře (pořadí readdir není definované)
+    qsort(batch->jobs + firstJob, batch->count - firstJob, sizeof(tBatchJob), compareBatchJobs);
+
+    // Navrácení výsledku načtení
+    return result;
+}
+
+/*
+ * Funkce pro převod jedné úlohy dávky
+ *
+ * job     - úloha
+ * context - kontext převodu vlákna
+ * options - nastavení převodu
+ */
+static void runBatchJob(tBatchJob *job, tGIF2BMPContext *context, const tGIF2BMPOptions *options) {
+    // Otevření vstupního souboru
+    FILE *inputFile = fopen(job->inputFileName, "rb");
+    // Kontrola otevření
+    if(inputFile == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "Cannot open input file '%s' for read\n", job->inputFileName);
+        return;
+    }
+    // Otevření výstupního souboru
+    FILE *outputFile = fopen(job->outputFileName, "wb");
+    // Kontrola otevření
+    if(outputFile == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "Cannot open output file '%s' for write\n", job->outputFileName);
+        // Uzavření vstupního souboru
+        fclose(inputFile);
+        return;
+    }
+
+    // Převod s kontextem vlákna
+    job->result = gif2bmpContext(context, &job->info, inputFile, outputFile, options);
+
+    // Uzavření souborů (chyba zápisu při uzavření je chybou převodu)
+    fclose(inputFile);
+    if(fclose(outputFile) != 0) {
+        job->result = RETURN_FAILURE;
+    }
+
+    // Tisk informace o neúspěšném převodu
+    if(job->result != RETURN_SUCCESS) {
+        fprintf(stderr, "ERROR: Conversion of '%s' failed.\n", job->inputFileName);
+    }
+}
+
+/*
+ * Funkce pro získání úlohy z vlastní fronty (z konce)
+ *
+ * queue - fronta vlákna
+ * job   - ukazatel pro uložení indexu úlohy
+ *
+ * Návratová hodnota:
+ *     1 - úloha byla získána
+ *     0 - fronta je prázdná
+ */
+static int popBatchJob(tBatchQueue *queue, size_t *job) {
+    // Proměnná pro výsledek
+    int found = 0;
+
+    // Zamčení fronty
+    pthread_mutex_lock(&queue->lock);
+    // Pokud fronta není prázdná, odebere se poslední úloha
+    if(queue->head < queue->tail) {
+        *job = queue->items[--queue->tail];
+        found = 1;
+    }
+    // Odemčení fronty
+    pthread_mutex_unlock(&queue->lock);
+
+    // Navrácení výsledku
+    return found;
+}
+
+/*
+ * Funkce pro ukradení úlohy z cizí fronty (ze začátku)
+ *
+ * queue - fronta jiného vlákna
+ * job   - ukazatel pro uložení indexu úlohy
+ *
+ * Návratová hodnota:
+ *     1 - úloha byla získána
+ *     0 - fronta je prázdná
+ */
+static int stealBatchJob(tBatchQueue *queue, size_t *job) {
+    // Proměnná pro výsledek
+    int found = 0;
+
+    // Zamčení fronty
+    pthread_mutex_lock(&queue->lock);
+    // Pokud fronta není prázdná, odebere se první úloha
+    if(queue->head < queue->tail) {
+        *job = queue->items[queue->head++];
+        found = 1;
+    }
+    // Odemčení fronty
+    pthread_mutex_unlock(&queue->lock);
+
+    // Navrácení výsledku
+    return found;
+}
+
+/*
+ * Funkce pracovního vlákna
+ *
+ * Vlákno zpracovává úlohy své fronty a poté krade úlohy ostatním vláknům.
+ * Nové úlohy během běhu nevznikají, takže vlákno končí, jakmile jsou
+ * všechny fronty prázdné.
+ *
+ * argument - struktura pracovního vlákna (tBatchWorker)
+ */
+static void *batchWorker(void *argument) {
+    // Struktura pracovního vlákna
+    tBatchWorker *worker = (tBatchWorker*)argument;
+    // Index aktuální úlohy
+    size_t job = 0;
+
+    // Kontext převodu vlákna (použije se pro všechny jeho úlohy)
+    tGIF2BMPContext *context = (tGIF2BMPContext*)malloc(sizeof(tGIF2BMPContext));
+    // Kontrola alokace
+    if(context == NULL) {
+        // Tisk chyby (úlohy vlákna převedou ostatní vlákna)
+        fprintf(stderr, "ERROR: context malloc failed.\n");
+        return NULL;
+    }
+
+    // Dokud existuje nějaká úloha
+    for(;;) {
+        // Úloha z vlastní fronty
+        int found = popBatchJob(&worker->queues[worker->index], &job);
+        // Pokud je vlastní fronta prázdná, krade se z ostatních front
+        for(unsigned offset = 1; !found && offset < worker->threadCount; offset++) {
+            found = stealBatchJob(&worker->queues[(worker->index + offset) % worker->threadCount], &job);
+        }
+        // Všechny fronty jsou prázdné
+        if(!found) {
+            break;
+        }
+        // Převod úlohy
+        runBatchJob(&worker->batch->jobs[job], context, worker->options);
+    }
+
+    // Uvolnění kontextu
+    free(context);
+    return NULL;
+}
+
+/*
+ * Funkce pro převod všech úloh dávky
+ */
+int runBatch(tBatch *batch, unsigned threadCount, const tGIF2BMPOptions *options) {
+    // Proměnná pro výsledek dávky
+    int result = RETURN_SUCCESS;
+    // Počet spuštěných vláken
+    unsigned startedCount = 0;
+
+    // Prázdná dávka
+    if(batch->count == 0) {
+        return RETURN_SUCCESS;
+    }
+
+    // Výchozí počet vláken podle počtu procesorů
+    if(threadCount == 0) {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = (processors > 0) ? (unsigned)processors : 1;
+    }
+    // Omezení počtu vláken
+    if(threadCount > BATCH_MAX_THREADS) {
+        threadCount = BATCH_MAX_THREADS;
+    }
+    // Více vláken než úloh nemá smysl
+    if(threadCount > batch->count) {
+        threadCount = (unsigned)batch->count;
+    }
+
+    // Alokace front, vláken a indexů úloh
+    tBatchQueue *queues = (tBatchQueue*)calloc(threadCount, sizeof(tBatchQueue));
+    tBatchWorker *workers = (tBatchWorker*)calloc(threadCount, sizeof(tBatchWorker));
+    size_t *items = (size_t*)malloc(batch->count * sizeof(size_t));
+    // Kontrola alokace
+    if(queues == NULL || workers == NULL || items == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: batch queues malloc failed.\n");
+        free(queues);
+        free(workers);
+        free(items);
+        return RETURN_FAILURE;
+    }
+
+    // Rozdělení úloh do front po souvislých úsecích
+    for(unsigned index = 0; index < threadCount; index++) {
+        // Rozsah úloh fronty
+        size_t first = batch->count * index / threadCount;
+        size_t last = batch->count * (index + 1) / threadCount;
+        // Fronta ukazuje do společného pole indexů
+        queues[index].items = items;
+        queues[index].head = first;
+        // Úlohy se z konce fronty berou pozpátku, proto se ukládají obráceně
+        queues[index].tail = last;
+        for(size_t job = first; job < last; job++) {
+            items[job] = first + last - 1 - job;
+        }
+        // Inicializace zámku
+        pthread_mutex_init(&queues[index].lock, NULL);
+    }
+
+    // Spuštění pracovních vláken
+    for(unsigned index = 0; index < threadCount; index++) {
+        // Nastavení vlákna
+        workers[index].batch = batch;
+        workers[index].options = options;
+        workers[index].queues = queues;
+        workers[index].threadCount = threadCount;
+        workers[index].index = index;
+        // Vytvoření vlákna
+        if(pthread_create(&workers[index].thread, NULL, batchWorker, &workers[index]) != 0) {
+            // Úlohy nespuštěných vláken převedou spuštěná vlákna
+            fprintf(stderr, "ERROR: pthread_create failed.\n");
+            break;
+        }
+        startedCount++;
+    }
+
+    // Pokud se nepodařilo spustit žádné vlákno, převádí se v hlavním vlákně
+    if(startedCount == 0) {
+        workers[0].batch = batch;
+        workers[0].options = options;
+        workers[0].queues = queues;
+        workers[0].threadCount = threadCount;
+        workers[0].index = 0;
+        batchWorker(&workers[0]);
+    }
+
+    // Čekání na dokončení vláken
+    for(unsigned index = 0; index < startedCount; index++) {
+        pthread_join(workers[index].thread, NULL);
+    }
+
+    // Zrušení zámků
+    for(unsigned index = 0; index < threadCount; index++) {
+        pthread_mutex_destroy(&queues[index].lock);
+    }
+
+    // Kontrola výsledků všech úloh
+    for(size_t job = 0; job < batch->count; job++) {
+        if(batch->jobs[job].result != RETURN_SUCCESS) {
+            result = RETURN_FAILURE;
+        }
+    }
+
+    // Uvolnění front a vláken
+    free(queues);
+    free(workers);
+    free(items);
+
+    // Navrácení výsledku dávky
+    return result;
+}
+
+/*
+ * Funkce pro uvolnění dávky
+ */
+void freeBatch(tBatch *batch) {
+    // Uvolnění názvů souborů všech úloh
+    for(size_t job = 0; job < batch->count; job++) {
+        free(batch->jobs[job].inputFileName);
+        free(batch->jobs[job].outputFileName);
+    }
+    // Uvolnění pole úloh
+    free(batch->jobs);
+    // Vynulování dávky
+    memset(batch, 0, sizeof(tBatch));
+}
@@ -0,0 +1,114 @@
+/*******************************************************************************
+*  Soubor:   batch.h                                                           *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Hlavičkový  soubor  dávkového  převodu. Dávka je seznam dvojic vstupní a   *
+*  výstupní soubor (ze souboru manifestu nebo z adresáře), které se převádí   *
+*  na několika vláknech. Každé vlákno má vlastní frontu úloh a po jejím       *
+*  vyprázdnění si úlohy "krade" z front ostatních vláken.                     *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+#include "gif2bmp.h"
+
+// Počáteční počet úloh, pro které se alokuje místo
+#define BATCH_ALLOC_SIZE 64
+// Maximální počet pracovních vláken
+#define BATCH_MAX_THREADS 256
+// Přípona vstupních souborů v adresáři
+#define BATCH_INPUT_SUFFIX ".gif"
+// Přípona výstupních souborů v adresáři
+#define BATCH_OUTPUT_SUFFIX ".bmp"
+
+/*
+ * Struktura jedné úlohy dávky
+ *
+ * inputFileName  - název vstupního souboru (GIF)
+ * outputFileName - název výstupního souboru (BMP)
+ * info           - záznam o převodu
+ * result         - výsledek převodu (0 - v pořádku, -1 - chyba)
+ */
+typedef struct {
+    char *inputFileName;
+    char *outputFileName;
+    tGIF2BMP info;
+    int result;
+} tBatchJob;
+
+/*
+ * Struktura dávky
+ *
+ * jobs     - pole úloh
+ * count    - počet úloh
+ * capacity - počet úloh, pro které je alokováno místo
+ */
+typedef struct {
+    tBatchJob *jobs;
+    size_t count;
+    size_t capacity;
+} tBatch;
+
+/*
+ * Funkce pro načtení dávky ze souboru manifestu
+ *
+ * Každý neprázdný řádek obsahuje vstupní a výstupní soubor oddělené
+ * tabulátorem (názvy tak mohou obsahovat mezery), řádek bez tabulátoru
+ * se ohlásí s číslem řádku jako chybný. Řádky začínající znakem '#' jsou
+ * komentáře.
+ *
+ * batch            - dávka (úlohy se přidají na konec)
+ * manifestFileName - název souboru manifestu
+ *
+ * Návratová hodnota:
+ *      0 - manifest byl načten
+ *     -1 - chyba čtení nebo formátu manifestu
+ */
+int loadBatchManifest(tBatch *batch, const char *manifestFileName);
+
+/*
+ * Funkce pro načtení dávky z adresáře
+ *
+ * Každý soubor s příponou .gif ve vstupním adresáři se převede na soubor
+ * se stejným názvem a příponou .bmp ve výstupním adresáři.
+ *
+ * batch           - dávka (úlohy se přidají na konec)
+ * inputDirectory  - vstupní adresář
+ * outputDirectory - výstupní adresář
+ *
+ * Návratová hodnota:
+ *      0 - adresář byl načten
+ *     -1 - chyba čtení adresáře
+ */
+int loadBatchDirectory(tBatch *batch, const char *inputDirectory, const char *outputDirectory);
+
+/*
+ * Funkce pro převod všech úloh dávky
+ *
+ * batch       - dávka
+ * threadCount - počet pracovních vláken (0 - podle počtu procesorů)
+ * options     - nastavení převodu (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - všechny převody proběhly v pořádku
+ *     -1 - alespoň jeden převod skončil chybou
+ */
+int runBatch(tBatch *batch, unsigned threadCount, const tGIF2BMPOptions *options);
+
+/*
+ * Funkce pro uvolnění dávky
+ *
+ * batch - dávka
+ */
+void freeBatch(tBatch *batch);
+
+#endif
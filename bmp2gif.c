@@ -0,0 +1,143 @@
+/*******************************************************************************
+*  Soubor:   bmp2gif.c                                                         *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Doprovodná  aplikace  kodéru  GIF (gifencode.h). Převádí BMP s nejvýše     *
+*  256 barvami zpět na GIF, např. pro zpětné testy převodu gif2bmp nebo       *
+*  pro generování testovacích souborů s různým nastavením kodéru.             *
+*                                                                              *
+*******************************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <stdint.h>
+#include "gifencode.h"
+
+/*
+ * Funkce pro výpis způsobu použití programu
+ *
+ * programName - název spouštěného programu
+ */
+void printHelp(char *programName) {
+    fprintf(stdout, "Usage: %s [-i input_file] [-o output_file] [-c code_size] [-r clear_interval] [-n frames] [-I] [-h]\n\n", programName);
+    fprintf(stdout, "  -h print help\n");
+    fprintf(stdout, "  -i input file name (BMP, at most 256 colors), default: stdin\n");
+    fprintf(stdout, "  -o output file name (GIF), default: stdout\n");
+    fprintf(stdout, "  -c LZW minimum code size 2-8, default: by palette size\n");
+    fprintf(stdout, "  -r emit a clear code every N codes, default: only when the dictionary is full\n");
+    fprintf(stdout, "  -n write the image N times as animation frames, default: 1\n");
+    fprintf(stdout, "  -I interlaced image blocks\n");
+}
+
+/*
+ * Funkce pro převod číselného argumentu přepínače
+ *
+ * option  - přepínač
+ * value   - text argumentu
+ * minimum - nejmenší povolená hodnota
+ * maximum - největší povolená hodnota
+ *
+ * Návratová hodnota:
+ *     hodnota argumentu (při chybě program končí)
+ */
+unsigned long parseNumber(int option, const char *value, unsigned long minimum, unsigned long maximum) {
+    // Ukazatel za načtené číslo
+    char *end = NULL;
+    // Převod čísla
+    unsigned long number = strtoul(value, &end, 10);
+    // Kontrola čísla
+    if(*value == '\0' || *end != '\0' || number < minimum || number > maximum) {
+        fprintf(stderr, "Invalid value '%s' of option -%c.\n", value, option);
+        exit(EXIT_FAILURE);
+    }
+    return number;
+}
+
+/*
+ * Funkce main - převod BMP na GIF
+ *
+ * Návratová hodnota:
+ *     EXIT_SUCCESS - převod proběhl v pořádku
+ *     EXIT_FAILURE - chyba argumentů nebo převodu
+ */
+int main(int argc, char *argv[]) {
+    // Nastavení kodéru
+    tGIFEncodeOptions options = {0, 0, FLAG_FALSE, 1};
+    // Vstupní a výstupní soubor
+    FILE *inputFile = stdin;
+    FILE *outputFile = stdout;
+    // Aktuální přepínač
+    int actualChar;
+    // Výsledek převodu
+    int result;
+
+    // Procházení vstupních argumentů programu
+    while((actualChar = getopt(argc, argv, "i:o:c:r:n:Ih")) != -1) {
+        switch(actualChar) {
+            // Vstupní soubor
+            case 'i':
+                if(inputFile != stdin) fclose(inputFile);
+                if((inputFile = fopen(optarg, "rb")) == NULL) {
+                    fprintf(stderr, "Cannot open input file '%s' for read\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            // Výstupní soubor
+            case 'o':
+                if(outputFile != stdout) fclose(outputFile);
+                if((outputFile = fopen(optarg, "wb")) == NULL) {
+                    fprintf(stderr, "Cannot open output file '%s' for write\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            // Minimální velikost LZW kódu
+            case 'c':
+                options.minimumCodeSize = (uint8_t)parseNumber(actualChar, optarg, 2, BYTE_BITS);
+                break;
+            // Počet kódů mezi clear kódy
+            case 'r':
+                options.clearInterval = (uint32_t)parseNumber(actualChar, optarg, 1, UINT32_MAX);
+                break;
+            // Počet zápisů obrazu
+            case 'n':
+                options.frameCount = (uint32_t)parseNumber(actualChar, optarg, 1, UINT16_MAX);
+                break;
+            // Prokládání
+            case 'I':
+                options.interlace = FLAG_TRUE;
+                break;
+            // Nápověda
+            case 'h':
+                printHelp(argv[0]);
+                return EXIT_SUCCESS;
+            // Neznámý přepínač nebo chybějící argument (chybu vypsal getopt)
+            default:
+                printHelp(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    // Nezpracované argumenty
+    if(optind < argc) {
+        fprintf(stderr, "Non-option argument '%s'.\n", argv[optind]);
+        printHelp(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Převod
+    result = bmp2gif(inputFile, outputFile, &options);
+
+    // Uzavření souborů
+    if(inputFile != stdin) fclose(inputFile);
+    if(outputFile != stdout && fclose(outputFile) != 0) result = RETURN_FAILURE;
+
+    // Konec programu
+    return result == RETURN_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
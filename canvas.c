@@ -0,0 +1,175 @@
+/*******************************************************************************
+*  Soubor:   canvas.c                                                          *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Obrazová data rozdělená do pásů řádků. Blok, který pokrývá jen malou část  *
+*  velké logické obrazovky, alokuje jen pásy svých řádků, takže paměť převodu *
+*  odpovídá vykresleným řádkům a ne rozměrům logické obrazovky.              *
+*                                                                              *
+*******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include "gif2bmp.h"
+#include "canvas.h"
+
+/*
+ * Funkce pro započtení alokace do rozpočtu paměti
+ *
+ * budget - rozpočet paměti
+ * bytes  - počet alokovaných bajtů
+ *
+ * Návratová hodnota:
+ *      0 - alokace se do rozpočtu vejde
+ *     -1 - alokace by rozpočet překročila (rozpočet se nezmění)
+ */
+static int reserveCanvasMemory(tCanvasBudget *budget, uint64_t bytes) {
+    // Kontrola rozpočtu
+    if(budget->limit > 0 && (bytes > budget->limit || budget->used > budget->limit - bytes)) {
+        budget->exceeded = FLAG_TRUE;
+        return RETURN_FAILURE;
+    }
+    // Započtení alokace a nejvyšší dosažené hodnoty
+    budget->used += bytes;
+    if(budget->used > budget->peak) {
+        budget->peak = budget->used;
+    }
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro inicializaci obrazových dat bez alokovaných pásů
+ */
+int initCanvas(tCanvas *canvas, uint32_t rows, size_t rowBytes, uint8_t fill, tCanvasBudget *budget) {
+    // Počet řádků pásu podle velikosti pásu
+    uint32_t bandRows = (rowBytes > 0 && rowBytes < CANVAS_BAND_SIZE) ? (uint32_t)(CANVAS_BAND_SIZE / rowBytes) : 1;
+
+    // Obrazová data zatím nemají pásy
+    memset(canvas, 0, sizeof(tCanvas));
+    canvas->rows = rows;
+    canvas->rowBytes = rowBytes;
+    canvas->fill = fill;
+    canvas->budget = budget;
+    canvas->bandRows = bandRows;
+    canvas->bandCount = (uint32_t)(((uint64_t)rows + bandRows - 1) / bandRows);
+
+    // Pole ukazatelů na pásy se počítá do rozpočtu
+    if(reserveCanvasMemory(budget, (uint64_t)canvas->bandCount * sizeof(uint8_t*)) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+    // Alokace pole ukazatelů (všechny pásy nealokované)
+    canvas->bands = (uint8_t**)calloc((size_t)canvas->bandCount + 1, sizeof(uint8_t*));
+    // Kontrola alokace
+    if(canvas->bands == NULL) {
+        budget->used -= (uint64_t)canvas->bandCount * sizeof(uint8_t*);
+        return RETURN_FAILURE;
+    }
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro zjištění počtu řádků pásu
+ */
+uint32_t getCanvasBandRows(const tCanvas *canvas, uint32_t band) {
+    // První řádek pásu
+    uint32_t first = band * canvas->bandRows;
+    // Poslední pás končí posledním řádkem
+    return (canvas->rows - first < canvas->bandRows) ? canvas->rows - first : canvas->bandRows;
+}
+
+/*
+ * Funkce pro získání řádku s alokací jeho pásu
+ */
+uint8_t *getCanvasRow(tCanvas *canvas, uint32_t row) {
+    // Pás řádku
+    uint32_t band = row / canvas->bandRows;
+
+    // Alokace pásu při prvním přístupu
+    if(canvas->bands[band] == NULL) {
+        // Velikost pásu
+        size_t size = (size_t)getCanvasBandRows(canvas, band) * canvas->rowBytes;
+        // Kontrola rozpočtu
+        if(reserveCanvasMemory(canvas->budget, size) != RETURN_SUCCESS) {
+            return NULL;
+        }
+        // Alokace pásu
+        canvas->bands[band] = (uint8_t*)malloc(size + 1);
+        // Kontrola alokace
+        if(canvas->bands[band] == NULL) {
+            canvas->budget->used -= size;
+            return NULL;
+        }
+        // Nový pás má výplňovou hodnotu
+        memset(canvas->bands[band], canvas->fill, size);
+    }
+
+    // Řádek uvnitř pásu
+    return canvas->bands[band] + (size_t)(row % canvas->bandRows) * canvas->rowBytes;
+}
+
+/*
+ * Funkce pro získání řádku bez alokace pásu
+ */
+uint8_t *peekCanvasRow(const tCanvas *canvas, uint32_t row) {
+    // Pás řádku
+    uint32_t band = row / canvas->bandRows;
+
+    // Nealokovaný pás
+    if(canvas->bands[band] == NULL) {
+        return NULL;
+    }
+    // Řádek uvnitř pásu
+    return canvas->bands[band] + (size_t)(row % canvas->bandRows) * canvas->rowBytes;
+}
+
+/*
+ * Funkce pro vyplnění všech řádků hodnotou
+ */
+void fillCanvas(tCanvas *canvas, uint8_t fill) {
+    // Nová výplňová hodnota nealokovaných pásů
+    canvas->fill = fill;
+    // Vyplnění alokovaných pásů
+    for(uint32_t band = 0; band < canvas->bandCount; band++) {
+        if(canvas->bands[band] != NULL) {
+            memset(canvas->bands[band], fill, (size_t)getCanvasBandRows(canvas, band) * canvas->rowBytes);
+        }
+    }
+}
+
+/*
+ * Funkce pro uvolnění jednoho pásu
+ */
+void freeCanvasBand(tCanvas *canvas, uint32_t band) {
+    // Nealokovaný pás
+    if(canvas->bands[band] == NULL) {
+        return;
+    }
+    // Uvolnění pásu a odečtení z rozpočtu
+    free(canvas->bands[band]);
+    canvas->bands[band] = NULL;
+    canvas->budget->used -= (uint64_t)getCanvasBandRows(canvas, band) * canvas->rowBytes;
+}
+
+/*
+ * Funkce pro uvolnění všech pásů
+ */
+void freeCanvas(tCanvas *canvas) {
+    // Obrazová data bez pásů
+    if(canvas->bands == NULL) {
+        return;
+    }
+    // Uvolnění všech pásů
+    for(uint32_t band = 0; band < canvas->bandCount; band++) {
+        freeCanvasBand(canvas, band);
+    }
+    // Uvolnění pole ukazatelů
+    free(canvas->bands);
+    canvas->bands = NULL;
+    canvas->budget->used -= (uint64_t)canvas->bandCount * sizeof(uint8_t*);
+}
@@ -0,0 +1,138 @@
+/*******************************************************************************
+*  Soubor:   canvas.h                                                          *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Hlavičkový  soubor  obrazových  dat  rozdělených  do  pásů  řádků. Pás se  *
+*  alokuje až při prvním přístupu k některému jeho řádku, nealokované pásy    *
+*  mají všechny bajty rovny výplňové hodnotě. Alokované bajty všech pásů se   *
+*  počítají do společného rozpočtu paměti, který lze omezit.                  *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CANVAS_H
+#define CANVAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Přibližná velikost jednoho pásu řádků v bajtech (pás má vždy alespoň
+// jeden řádek)
+#define CANVAS_BAND_SIZE 262144
+
+/*
+ * Struktura rozpočtu paměti obrazových dat
+ *
+ * limit    - největší povolený počet alokovaných bajtů (0 - bez omezení)
+ * used     - počet aktuálně alokovaných bajtů
+ * peak     - největší počet současně alokovaných bajtů
+ * exceeded - příznak odmítnuté alokace kvůli překročení rozpočtu
+ */
+typedef struct {
+    uint64_t limit;
+    uint64_t used;
+    uint64_t peak;
+    uint8_t exceeded;
+} tCanvasBudget;
+
+/*
+ * Struktura obrazových dat rozdělených do pásů řádků
+ *
+ * bands     - ukazatele na pásy (NULL - pás není alokován)
+ * bandCount - počet pásů
+ * bandRows  - počet řádků jednoho pásu (poslední pás může být kratší)
+ * rows      - počet všech řádků
+ * rowBytes  - počet bajtů jednoho řádku
+ * fill      - hodnota bajtů nealokovaných pásů
+ * budget    - rozpočet paměti, do kterého se pásy počítají
+ */
+typedef struct {
+    uint8_t **bands;
+    uint32_t bandCount;
+    uint32_t bandRows;
+    uint32_t rows;
+    size_t rowBytes;
+    uint8_t fill;
+    tCanvasBudget *budget;
+} tCanvas;
+
+/*
+ * Funkce pro inicializaci obrazových dat bez alokovaných pásů
+ *
+ * canvas   - obrazová data (obsah se přepíše)
+ * rows     - počet řádků
+ * rowBytes - počet bajtů jednoho řádku
+ * fill     - hodnota bajtů nealokovaných pásů
+ * budget   - rozpočet paměti
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - chyba alokace nebo překročení rozpočtu
+ */
+int initCanvas(tCanvas *canvas, uint32_t rows, size_t rowBytes, uint8_t fill, tCanvasBudget *budget);
+
+/*
+ * Funkce pro získání řádku s alokací jeho pásu
+ *
+ * Nově alokovaný pás se vyplní výplňovou hodnotou.
+ *
+ * canvas - obrazová data
+ * row    - řádek
+ *
+ * Návratová hodnota:
+ *     ukazatel na řádek, NULL při chybě alokace nebo překročení rozpočtu
+ */
+uint8_t *getCanvasRow(tCanvas *canvas, uint32_t row);
+
+/*
+ * Funkce pro získání řádku bez alokace pásu
+ *
+ * canvas - obrazová data
+ * row    - řádek
+ *
+ * Návratová hodnota:
+ *     ukazatel na řádek, NULL pro řádek nealokovaného pásu
+ */
+uint8_t *peekCanvasRow(const tCanvas *canvas, uint32_t row);
+
+/*
+ * Funkce pro zjištění počtu řádků pásu
+ *
+ * canvas - obrazová data
+ * band   - pořadí pásu
+ */
+uint32_t getCanvasBandRows(const tCanvas *canvas, uint32_t band);
+
+/*
+ * Funkce pro vyplnění všech řádků hodnotou
+ *
+ * Hodnota se stane výplňovou hodnotou nealokovaných pásů.
+ *
+ * canvas - obrazová data
+ * fill   - nová hodnota všech bajtů
+ */
+void fillCanvas(tCanvas *canvas, uint8_t fill);
+
+/*
+ * Funkce pro uvolnění jednoho pásu
+ *
+ * Řádky pásu pak mají opět výplňovou hodnotu.
+ *
+ * canvas - obrazová data
+ * band   - pořadí pásu
+ */
+void freeCanvasBand(tCanvas *canvas, uint32_t band);
+
+/*
+ * Funkce pro uvolnění všech pásů
+ *
+ * canvas - obrazová data (po uvolnění bez pásů)
+ */
+void freeCanvas(tCanvas *canvas);
+
+#endif
@@ -0,0 +1,251 @@
+/*******************************************************************************
+*  Soubor:   expand.c                                                          *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Jádra převodu indexů barev na barvy pixelů. Tabulka barev má 32bitové      *
+*  položky, takže barva pixelu se načte jediným čtením. Verze AVX2 načítá     *
+*  osm barev instrukcí gather, verze SSSE3 čtyři barvy skládá z běžných       *
+*  čtení. Obě pak pro 24bitový výstup vypustí čtvrtý bajt instrukcí pshufb.   *
+*                                                                              *
+*******************************************************************************/
+
+#include <string.h>
+#include "expand.h"
+
+// Jádra SSSE3 a AVX2 se překládají jen na x86 překladačem GCC nebo Clang,
+// instrukční sada se povoluje pouze pro funkce jader (atribut target)
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EXPAND_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Funkce pro sestavení položky tabulky barev
+ *
+ * b, g, r - složky barvy
+ * x       - čtvrtý bajt pixelu BGRX (24bitová jádra jej nezapisují)
+ *
+ * Návratová hodnota:
+ *     položka tabulky s pořadím bajtů B, G, R, X v paměti
+ */
+uint32_t makeExpandColor(uint8_t b, uint8_t g, uint8_t r, uint8_t x) {
+    // Bajty položky v pořadí v paměti
+    uint8_t bytes[EXPAND_BGRX_SIZE] = {b, g, r, x};
+    // Sestavená položka
+    uint32_t color;
+
+    // Kopie bajtů zachová pořadí v paměti nezávisle na endianitě
+    memcpy(&color, bytes, sizeof(color));
+
+    // Navrácení položky
+    return color;
+}
+
+/*
+ * Skalární jádro převodu na 24bitové pixely
+ *
+ * Každý pixel kromě posledního se zapíše jako celá 32bitová položka,
+ * čtvrtý bajt přepíše až následující pixel.
+ */
+static void expandBGRScalar(uint8_t *target, const uint8_t *indexes, uint32_t width, const uint32_t *table) {
+    // Index aktuálního pixelu
+    uint32_t col = 0;
+
+    // Pixely, za kterými následuje další pixel
+    for(; col + 1 < width; col++) {
+        // Zápis celé položky
+        memcpy(target, &table[indexes[col]], EXPAND_BGRX_SIZE);
+        // Posun na další pixel
+        target += EXPAND_BGR_SIZE;
+    }
+    // Poslední pixel řádku se zapíše bez čtvrtého bajtu
+    if(col < width) {
+        memcpy(target, &table[indexes[col]], EXPAND_BGR_SIZE);
+    }
+}
+
+/*
+ * Skalární jádro převodu na 32bitové pixely
+ */
+static void expandBGRXScalar(uint8_t *target, const uint8_t *indexes, uint32_t width, const uint32_t *table) {
+    // Průchod všemi pixely řádku
+    for(uint32_t col = 0; col < width; col++) {
+        // Zápis celé položky
+        memcpy(target, &table[indexes[col]], EXPAND_BGRX_SIZE);
+        // Posun na další pixel
+        target += EXPAND_BGRX_SIZE;
+    }
+}
+
+#ifdef EXPAND_X86
+
+/*
+ * Jádro SSSE3 převodu na 24bitové pixely
+ *
+ * Čtyři barvy se složí do registru a pshufb z nich vypustí čtvrté bajty.
+ * Zápis 16 bajtů přesahuje 12 bajtů pixelů, proto se takto zpracují jen
+ * pixely, za kterými zbývají alespoň další dva pixely řádku.
+ */
+__attribute__((target("ssse3")))
+static void expandBGRSSSE3(uint8_t *target, const uint8_t *indexes, uint32_t width, const uint32_t *table) {
+    // Maska pro vypuštění čtvrtých bajtů
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    // Index aktuálního pixelu
+    uint32_t col = 0;
+
+    // Skupiny čtyř pixelů
+    for(; col + 6 <= width; col += 4) {
+        // Barvy čtyř pixelů
+        __m128i colors = _mm_setr_epi32((int)table[indexes[col]], (int)table[indexes[col + 1]],
+                                        (int)table[indexes[col + 2]], (int)table[indexes[col + 3]]);
+        // Vypuštění čtvrtých bajtů a zápis
+        _mm_storeu_si128((__m128i*)target, _mm_shuffle_epi8(colors, shuffle));
+        // Posun za čtyři pixely
+        target += 4 * EXPAND_BGR_SIZE;
+    }
+    // Zbytek řádku skalárně
+    expandBGRScalar(target, indexes + col, width - col, table);
+}
+
+/*
+ * Jádro SSSE3 (SSE2) převodu na 32bitové pixely
+ */
+__attribute__((target("ssse3")))
+static void expandBGRXSSSE3(uint8_t *target, const uint8_t *indexes, uint32_t width, const uint32_t *table) {
+    // Index aktuálního pixelu
+    uint32_t col = 0;
+
+    // Skupiny čtyř pixelů
+    for(; col + 4 <= width; col += 4) {
+        // Barvy čtyř pixelů
+        __m128i colors = _mm_setr_epi32((int)table[indexes[col]], (int)table[indexes[col + 1]],
+                                        (int)table[indexes[col + 2]], (int)table[indexes[col + 3]]);
+        // Zápis
+        _mm_storeu_si128((__m128i*)target, colors);
+        // Posun za čtyři pixely
+        target += 4 * EXPAND_BGRX_SIZE;
+    }
+    // Zbytek řádku skalárně
+    expandBGRXScalar(target, indexes + col, width - col, table);
+}
+
+/*
+ * Jádro AVX2 převodu na 24bitové pixely
+ *
+ * Osm indexů se rozšíří na 32 bitů a barvy se načtou instrukcí gather.
+ * pshufb vypustí čtvrté bajty v obou polovinách registru, každá polovina
+ * se pak zapíše 16 bajty (12 bajtů pixelů). Poslední zápis přesahuje
+ * o 4 bajty, proto za skupinou musí zbývat alespoň další dva pixely.
+ */
+__attribute__((target("avx2")))
+static void expandBGRAVX2(uint8_t *target, const uint8_t *indexes, uint32_t width, const uint32_t *table) {
+    // Maska pro vypuštění čtvrtých bajtů (pro každou polovinu zvlášť)
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    // Index aktuálního pixelu
+    uint32_t col = 0;
+
+    // Skupiny osmi pixelů
+    for(; col + 10 <= width; col += 8) {
+        // Rozšíření osmi indexů na 32 bitů
+        __m256i colorIndexes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(indexes + col)));
+        // Načtení barev z tabulky
+        __m256i colors = _mm256_i32gather_epi32((const int*)table, colorIndexes, sizeof(uint32_t));
+        // Vypuštění čtvrtých bajtů
+        colors = _mm256_shuffle_epi8(colors, shuffle);
+        // Zápis obou polovin (12 bajtů pixelů v každé)
+        _mm_storeu_si128((__m128i*)target, _mm256_castsi256_si128(colors));
+        _mm_storeu_si128((__m128i*)(target + 4 * EXPAND_BGR_SIZE), _mm256_extracti128_si256(colors, 1));
+        // Posun za osm pixelů
+        target += 8 * EXPAND_BGR_SIZE;
+    }
+    // Zbytek řádku skalárně
+    expandBGRScalar(target, indexes + col, width - col, table);
+}
+
+/*
+ * Jádro AVX2 převodu na 32bitové pixely
+ */
+__attribute__((target("avx2")))
+static void expandBGRXAVX2(uint8_t *target, const uint8_t *indexes, uint32_t width, const uint32_t *table) {
+    // Index aktuálního pixelu
+    uint32_t col = 0;
+
+    // Skupiny osmi pixelů
+    for(; col + 8 <= width; col += 8) {
+        // Rozšíření osmi indexů na 32 bitů
+        __m256i colorIndexes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(indexes + col)));
+        // Načtení barev z tabulky a zápis
+        _mm256_storeu_si256((__m256i*)target, _mm256_i32gather_epi32((const int*)table, colorIndexes, sizeof(uint32_t)));
+        // Posun za osm pixelů
+        target += 8 * EXPAND_BGRX_SIZE;
+    }
+    // Zbytek řádku skalárně
+    expandBGRXScalar(target, indexes + col, width - col, table);
+}
+
+#endif
+
+/*
+ * Funkce pro výběr jader podle schopností procesoru
+ *
+ * kernels - vybraná jádra
+ * kernel  - nejvyšší povolená verze jader (EXPAND_KERNEL_*)
+ *
+ * Návratová hodnota:
+ *     verze vybraných jader
+ */
+int selectExpandKernels(tExpandKernels *kernels, int kernel) {
+#ifdef EXPAND_X86
+    // Inicializace detekce schopností procesoru
+    __builtin_cpu_init();
+    // AVX2, pokud je povoleno a procesor jej podporuje
+    if(kernel >= EXPAND_KERNEL_AVX2 && __builtin_cpu_supports("avx2")) {
+        kernels->kernel = EXPAND_KERNEL_AVX2;
+        kernels->expandBGR = expandBGRAVX2;
+        kernels->expandBGRX = expandBGRXAVX2;
+        return kernels->kernel;
+    }
+    // SSSE3, pokud je povoleno a procesor jej podporuje
+    if(kernel >= EXPAND_KERNEL_SSSE3 && __builtin_cpu_supports("ssse3")) {
+        kernels->kernel = EXPAND_KERNEL_SSSE3;
+        kernels->expandBGR = expandBGRSSSE3;
+        kernels->expandBGRX = expandBGRXSSSE3;
+        return kernels->kernel;
+    }
+#else
+    // Bez x86 jsou k dispozici jen skalární jádra
+    (void)kernel;
+#endif
+    // Skalární jádra
+    kernels->kernel = EXPAND_KERNEL_SCALAR;
+    kernels->expandBGR = expandBGRScalar;
+    kernels->expandBGRX = expandBGRXScalar;
+    return kernels->kernel;
+}
+
+/*
+ * Funkce pro získání názvu verze jader
+ *
+ * kernel - verze jader (EXPAND_KERNEL_*)
+ *
+ * Návratová hodnota:
+ *     název verze jader
+ */
+const char *getExpandKernelName(int kernel) {
+    // Název podle verze
+    switch(kernel) {
+        case EXPAND_KERNEL_AVX2:
+            return "avx2";
+        case EXPAND_KERNEL_SSSE3:
+            return "ssse3";
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,91 @@
+/*******************************************************************************
+*  Soubor:   expand.h                                                          *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Hlavičkový  soubor  jader  převodu  indexů barev na barvy pixelů. Každé    *
+*  jádro existuje ve skalární verzi a na procesorech x86 také ve verzi pro    *
+*  SSSE3 a AVX2. Vhodná verze se vybírá za běhu podle schopností procesoru.   *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef EXPAND_H
+#define EXPAND_H
+
+#include <stdint.h>
+
+// Počet položek tabulky barev jader
+#define EXPAND_TABLE_SIZE 256
+// Velikost pixelu ve formátu BGR (24 bitů)
+#define EXPAND_BGR_SIZE 3
+// Velikost pixelu ve formátu BGRX (32 bitů)
+#define EXPAND_BGRX_SIZE 4
+
+// Verze jader podle instrukční sady
+#define EXPAND_KERNEL_SCALAR 0
+#define EXPAND_KERNEL_SSSE3 1
+#define EXPAND_KERNEL_AVX2 2
+
+/*
+ * Typ jádra pro převod jednoho řádku indexů barev
+ *
+ * Jádro zapisuje právě width pixelů, za konec řádku nikdy nezapisuje.
+ *
+ * target  - cílový řádek
+ * indexes - indexy barev řádku
+ * width   - počet pixelů řádku
+ * table   - tabulka barev, položka má v paměti pořadí bajtů B, G, R, X
+ */
+typedef void (*tExpandRowFunction)(uint8_t *target, const uint8_t *indexes, uint32_t width, const uint32_t *table);
+
+/*
+ * Struktura vybraných jader
+ *
+ * kernel     - verze jader (EXPAND_KERNEL_*)
+ * expandBGR  - převod na 24bitové pixely B, G, R
+ * expandBGRX - převod na 32bitové pixely B, G, R, X
+ */
+typedef struct {
+    int kernel;
+    tExpandRowFunction expandBGR;
+    tExpandRowFunction expandBGRX;
+} tExpandKernels;
+
+/*
+ * Funkce pro sestavení položky tabulky barev
+ *
+ * b, g, r - složky barvy
+ * x       - čtvrtý bajt pixelu BGRX (24bitová jádra jej nezapisují)
+ *
+ * Návratová hodnota:
+ *     položka tabulky s pořadím bajtů B, G, R, X v paměti
+ */
+uint32_t makeExpandColor(uint8_t b, uint8_t g, uint8_t r, uint8_t x);
+
+/*
+ * Funkce pro výběr jader podle schopností procesoru
+ *
+ * kernels - vybraná jádra
+ * kernel  - nejvyšší povolená verze jader (EXPAND_KERNEL_*)
+ *
+ * Návratová hodnota:
+ *     verze vybraných jader
+ */
+int selectExpandKernels(tExpandKernels *kernels, int kernel);
+
+/*
+ * Funkce pro získání názvu verze jader
+ *
+ * kernel - verze jader (EXPAND_KERNEL_*)
+ *
+ * Návratová hodnota:
+ *     název verze jader
+ */
+const char *getExpandKernelName(int kernel);
+
+#endif
@@ -0,0 +1,210 @@
+/*******************************************************************************
+*  Soubor:   expandbench.c                                                     *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Mikrobenchmark  jader  převodu  indexů  barev na barvy pixelů (expand.h).  *
+*  Pro každou verzi jader podporovanou procesorem ověří shodu s referenčním   *
+*  převodem (včetně zápisu za konec řádku) a změří propustnost.               *
+*                                                                              *
+*******************************************************************************/
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "expand.h"
+
+// Šířka měřeného obrázku v pixelech
+#define BENCH_WIDTH 4096
+// Výška měřeného obrázku v pixelech
+#define BENCH_HEIGHT 1024
+// Počet opakování měření
+#define BENCH_REPEAT 8
+// Největší šířka řádku při ověřování jader
+#define CHECK_MAX_WIDTH 80
+// Počet hlídacích bajtů za koncem řádku
+#define CHECK_GUARD_SIZE 32
+// Hodnota hlídacích bajtů
+#define CHECK_GUARD_VALUE 0xA5
+
+/*
+ * Funkce pro referenční převod řádku
+ *
+ * target    - cílový řádek
+ * indexes   - indexy barev řádku
+ * width     - počet pixelů řádku
+ * table     - tabulka barev
+ * pixelSize - velikost pixelu (EXPAND_BGR_SIZE nebo EXPAND_BGRX_SIZE)
+ */
+void expandReference(uint8_t *target, const uint8_t *indexes, uint32_t width, const uint32_t *table, size_t pixelSize) {
+    // Průchod všemi pixely řádku
+    for(uint32_t col = 0; col < width; col++) {
+        // Kopie prvních pixelSize bajtů položky tabulky
+        memcpy(target + col * pixelSize, &table[indexes[col]], pixelSize);
+    }
+}
+
+/*
+ * Funkce pro ověření jádra proti referenčnímu převodu
+ *
+ * expand    - ověřované jádro
+ * indexes   - testovací indexy (alespoň CHECK_MAX_WIDTH)
+ * table     - tabulka barev
+ * pixelSize - velikost pixelu jádra
+ *
+ * Návratová hodnota:
+ *     0 - jádro se shoduje, -1 - neshoda nebo zápis za konec řádku
+ */
+int checkKernel(tExpandRowFunction expand, const uint8_t *indexes, const uint32_t *table, size_t pixelSize) {
+    // Výstup jádra a referenční výstup včetně hlídacích bajtů
+    uint8_t output[CHECK_MAX_WIDTH * EXPAND_BGRX_SIZE + CHECK_GUARD_SIZE];
+    uint8_t reference[CHECK_MAX_WIDTH * EXPAND_BGRX_SIZE + CHECK_GUARD_SIZE];
+
+    // Ověření všech šířek řádku a posunů začátku indexů
+    for(uint32_t width = 0; width <= CHECK_MAX_WIDTH - 8; width++) {
+        for(uint32_t shift = 0; shift < 8; shift++) {
+            // Vyplnění obou výstupů hlídací hodnotou
+            memset(output, CHECK_GUARD_VALUE, sizeof(output));
+            memset(reference, CHECK_GUARD_VALUE, sizeof(reference));
+            // Převod oběma způsoby
+            expand(output, indexes + shift, width, table);
+            expandReference(reference, indexes + shift, width, table, pixelSize);
+            // Porovnání včetně hlídacích bajtů
+            if(memcmp(output, reference, sizeof(output)) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    // Jádro se shoduje
+    return 0;
+}
+
+/*
+ * Funkce pro změření propustnosti jádra
+ *
+ * expand    - měřené jádro
+ * indexes   - indexy barev obrázku
+ * output    - výstupní buffer obrázku
+ * table     - tabulka barev
+ * pixelSize - velikost pixelu jádra
+ *
+ * Návratová hodnota:
+ *     propustnost v milionech pixelů za sekundu
+ */
+double measureKernel(tExpandRowFunction expand, const uint8_t *indexes, uint8_t *output, const uint32_t *table, size_t pixelSize) {
+    // Začátek měření
+    clock_t start = clock();
+    // Naměřený čas v sekundách
+    double seconds;
+
+    // Opakovaný převod všech řádků
+    for(int repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+        for(uint32_t row = 0; row < BENCH_HEIGHT; row++) {
+            expand(output + (size_t)row * BENCH_WIDTH * pixelSize, indexes + (size_t)row * BENCH_WIDTH, BENCH_WIDTH, table);
+        }
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    // Ochrana proti dělení nulou
+    if(seconds <= 0) {
+        return 0;
+    }
+    // Výpočet propustnosti
+    return ((double)BENCH_WIDTH * BENCH_HEIGHT * BENCH_REPEAT) / (seconds * 1e6);
+}
+
+/*
+ * Funkce main - spuštění mikrobenchmarku
+ *
+ * Návratová hodnota:
+ *     EXIT_SUCCESS - všechna jádra se shodují s referenčním převodem
+ *     EXIT_FAILURE - chyba alokace nebo neshoda jádra
+ */
+int main(void) {
+    // Tabulka barev
+    uint32_t table[EXPAND_TABLE_SIZE];
+    // Indexy barev a výstup obrázku
+    uint8_t *indexes = (uint8_t*)malloc((size_t)BENCH_WIDTH * BENCH_HEIGHT);
+    uint8_t *output = (uint8_t*)malloc((size_t)BENCH_WIDTH * BENCH_HEIGHT * EXPAND_BGRX_SIZE);
+    // Propustnost skalárních jader pro výpočet zrychlení
+    double scalarBGR = 0;
+    double scalarBGRX = 0;
+
+    // Kontrola alokace
+    if(indexes == NULL || output == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: benchmark malloc failed.\n");
+        // Uvolnění dat a konec programu s chybou
+        free(indexes);
+        free(output);
+        return EXIT_FAILURE;
+    }
+
+    // Naplnění tabulky a indexů reprodukovatelnou pseudonáhodnou posloupností
+    uint32_t seed = 0x12345678;
+    for(size_t index = 0; index < EXPAND_TABLE_SIZE; index++) {
+        // Lineární kongruenční generátor
+        seed = seed * 1103515245u + 12345u;
+        table[index] = makeExpandColor((uint8_t)(seed >> 8), (uint8_t)(seed >> 16), (uint8_t)(seed >> 24), 0);
+    }
+    for(size_t index = 0; index < (size_t)BENCH_WIDTH * BENCH_HEIGHT; index++) {
+        // Lineární kongruenční generátor
+        seed = seed * 1103515245u + 12345u;
+        indexes[index] = (uint8_t)(seed >> 16);
+    }
+
+    // Hlavička výsledků
+    printf("kernel   BGR Mpix/s   speedup   BGRX Mpix/s   speedup\n");
+
+    // Měření všech verzí jader
+    for(int kernel = EXPAND_KERNEL_SCALAR; kernel <= EXPAND_KERNEL_AVX2; kernel++) {
+        // Vybraná jádra
+        tExpandKernels kernels;
+
+        // Verze nepodporovaná procesorem se přeskočí
+        if(selectExpandKernels(&kernels, kernel) != kernel) {
+            printf("%-6s   unsupported\n", getExpandKernelName(kernel));
+            continue;
+        }
+
+        // Ověření shody s referenčním převodem
+        if(checkKernel(kernels.expandBGR, indexes, table, EXPAND_BGR_SIZE) != 0 ||
+           checkKernel(kernels.expandBGRX, indexes, table, EXPAND_BGRX_SIZE) != 0) {
+            // Tisk chyby
+            fprintf(stderr, "ERROR: %s kernel mismatch.\n", getExpandKernelName(kernel));
+            // Uvolnění dat a konec programu s chybou
+            free(indexes);
+            free(output);
+            return EXIT_FAILURE;
+        }
+
+        // Měření obou jader
+        double bgr = measureKernel(kernels.expandBGR, indexes, output, table, EXPAND_BGR_SIZE);
+        double bgrx = measureKernel(kernels.expandBGRX, indexes, output, table, EXPAND_BGRX_SIZE);
+        // Skalární jádra jsou základem zrychlení
+        if(kernel == EXPAND_KERNEL_SCALAR) {
+            scalarBGR = bgr;
+            scalarBGRX = bgrx;
+        }
+
+        // Tisk výsledků
+        printf("%-6s   %12.1f   %6.2fx   %11.1f   %6.2fx\n", getExpandKernelName(kernel),
+               bgr, scalarBGR > 0 ? bgr / scalarBGR : 0.0,
+               bgrx, scalarBGRX > 0 ? bgrx / scalarBGRX : 0.0);
+    }
+
+    // Uvolnění dat
+    free(indexes);
+    free(output);
+
+    // Konec programu bez chyby
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,356 @@
+/*******************************************************************************
+*  Soubor:   framedecode.c                                                     *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Paralelní  dekódování  image  bloků.  Vlákna  si  berou bloky v pořadí     *
+*  souboru a dekódují je vlastním slovníkem LZW do bufferu indexů barev.      *
+*  Skládání do obrazu (průhlednost, palety) zůstává na převodu, který bloky   *
+*  přebírá ve stejném pořadí, takže výsledek je shodný se sekvenčním          *
+*  převodem.                                                                  *
+*                                                                              *
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdlib.h>
+#include "gif2bmp.h"
+#include "framedecode.h"
+
+/*
+ * Struktura zdroje sub-bloků jednoho bloku v paměti
+ *
+ * data       - data souboru
+ * length     - délka dat
+ * position   - pozice bajtu velikosti dalšího sub-bloku
+ * terminated - příznak načtení ukončujícího bajtu
+ * subBlocks  - počet předaných sub-bloků
+ */
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+    uint8_t terminated;
+    uint32_t subBlocks;
+} tFrameSource;
+
+/*
+ * Struktura výstupu dekódování do bufferu bloku
+ *
+ * pixels   - buffer indexů barev
+ * count    - počet uložených indexů
+ * capacity - velikost bufferu (počet pixelů bloku)
+ */
+typedef struct {
+    uint8_t *pixels;
+    uint32_t count;
+    uint32_t capacity;
+} tFrameOutput;
+
+/*
+ * Funkce pro získání dalšího sub-bloku z paměti (tLZWFillFunction)
+ *
+ * source - zdroj sub-bloků (tFrameSource)
+ * data   - ukazatel pro uložení začátku dat sub-bloku
+ *
+ * Návratová hodnota:
+ *     délka sub-bloku, 0 pro ukončující bajt nebo konec dat
+ */
+static size_t readFrameSubBlock(void *source, const uint8_t **data) {
+    // Zdroj sub-bloků
+    tFrameSource *frameSource = (tFrameSource*)source;
+    // Velikost sub-bloku
+    size_t size;
+
+    // Po ukončujícím bajtu nebo na konci dat již nic nenásleduje
+    if(frameSource->terminated == FLAG_TRUE || frameSource->position >= frameSource->length) {
+        return 0;
+    }
+    // Načtení velikosti sub-bloku
+    size = frameSource->data[frameSource->position];
+    // Ukončující bajt dat bloku
+    if(size == 0) {
+        frameSource->terminated = FLAG_TRUE;
+        return 0;
+    }
+    // Sub-blok přesahující konec dat (předběžný průchod jej nepřipustí)
+    if(frameSource->position + 1 + size > frameSource->length) {
+        return 0;
+    }
+    // Předání dat sub-bloku a posun za něj
+    *data = &frameSource->data[frameSource->position + 1];
+    frameSource->position += 1 + size;
+    frameSource->subBlocks++;
+    return size;
+}
+
+/*
+ * Funkce pro uložení rozvinutého řetězce do bufferu bloku
+ * (tLZWOutputFunction)
+ *
+ * target - výstup dekódování (tFrameOutput)
+ * colors - indexy barev řetězce
+ * count  - počet indexů barev řetězce
+ */
+static void storeFramePixels(void *target, const uint8_t *colors, uint32_t count) {
+    // Výstup dekódování
+    tFrameOutput *output = (tFrameOutput*)target;
+
+    // Přebytečná data za posledním pixelem bloku se ignorují
+    if(count > output->capacity - output->count) {
+        count = output->capacity - output->count;
+    }
+    // Kopie řetězce za dosud uložené indexy
+    memcpy(output->pixels + output->count, colors, count);
+    output->count += count;
+}
+
+/*
+ * Funkce pro dekódování jednoho bloku (bez zámku dekodéru)
+ *
+ * Blok, který se nemá nebo nemůže dekódovat (přeskočený blok, nepodporovaná
+ * velikost kódu, chyba alokace), zůstane bez bufferu a převod jej zpracuje
+ * sám ze vstupu.
+ *
+ * decoder - dekodér
+ * table   - slovník LZW vlákna
+ * frame   - záznam bloku z předběžného průchodu
+ * result  - dekódovaný blok
+ */
+static void decodeFrame(tFrameDecoder *decoder, tLZWTable *table, const tGIFFrame *frame, tDecodedFrame *result) {
+    // Zdroj sub-bloků za minimální velikostí LZW kódu
+    tFrameSource source = {decoder->data, decoder->length, (size_t)frame->dataOffset + 1, FLAG_FALSE, 0};
+    // Výstup dekódování
+    tFrameOutput output = {NULL, 0, 0};
+    // Počet pixelů bloku
+    uint64_t pixelCount = (uint64_t)frame->width * frame->height;
+    // Minimální velikost LZW kódu
+    uint8_t minimumCodeSize;
+
+    // Bez bufferu zůstane přeskočený blok, prázdný blok i blok mimo data
+    result->pixels = NULL;
+    if(frame->skip == FLAG_TRUE || pixelCount == 0 || pixelCount > UINT32_MAX || frame->dataOffset >= decoder->length) {
+        return;
+    }
+    // Nepodporovanou velikost kódu ohlásí převod
+    minimumCodeSize = decoder->data[frame->dataOffset];
+    if(minimumCodeSize > BYTE_BITS) {
+        return;
+    }
+    // Alokace bufferu indexů bloku
+    output.capacity = (uint32_t)pixelCount;
+    output.pixels = (uint8_t*)malloc(output.capacity);
+    if(output.pixels == NULL) {
+        return;
+    }
+
+    // Dekódování dat bloku
+    result->status = decodeLZWData(table, minimumCodeSize, readFrameSubBlock, &source, storeFramePixels, &output,
+                                   &result->invalidCode, &result->lzwStats);
+    // Uložení výsledku
+    result->pixels = output.pixels;
+    result->count = output.count;
+    result->subBlocks = source.subBlocks;
+}
+
+/*
+ * Funkce pro zjištění velikosti bufferu indexů bloku
+ *
+ * frame - záznam bloku z předběžného průchodu
+ *
+ * Návratová hodnota:
+ *     počet bajtů bufferu (počet pixelů bloku, 0 u přeskočeného bloku)
+ */
+static uint64_t getFrameBufferSize(const tGIFFrame *frame) {
+    return (frame->skip == FLAG_TRUE) ? 0 : (uint64_t)frame->width * frame->height;
+}
+
+/*
+ * Funkce pracovního vlákna dekodéru
+ *
+ * arg - dekodér (tFrameDecoder)
+ *
+ * Návratová hodnota:
+ *     NULL
+ */
+static void *frameDecoderWorker(void *arg) {
+    // Dekodér
+    tFrameDecoder *decoder = (tFrameDecoder*)arg;
+    // Vlastní slovník LZW vlákna
+    tLZWTable *table = (tLZWTable*)malloc(sizeof(tLZWTable));
+
+    pthread_mutex_lock(&decoder->mutex);
+    // Dokud zbývají bloky a dekodér nebyl zastaven
+    while(decoder->stop == FLAG_FALSE && decoder->next < decoder->scan->count) {
+        // Čekání na místo v okně dekódování
+        if(decoder->next >= decoder->released + decoder->window) {
+            pthread_cond_wait(&decoder->cond, &decoder->mutex);
+            continue;
+        }
+        // Převzetí dalšího bloku
+        uint32_t index = decoder->next++;
+        tDecodedFrame result = {NULL, 0, LZW_DECODE_OK, 0, {0, 0, 0}, 0, FLAG_TRUE};
+        uint64_t bufferSize = getFrameBufferSize(&decoder->scan->frames[index]);
+
+        // Buffer bloku se započítá již před jeho alokací
+        decoder->bufferBytes += bufferSize;
+        if(decoder->bufferBytes > decoder->bufferPeak) {
+            decoder->bufferPeak = decoder->bufferBytes;
+        }
+
+        // Dekódování bez zámku (bez slovníku převod dekóduje blok sám)
+        pthread_mutex_unlock(&decoder->mutex);
+        if(table != NULL) {
+            decodeFrame(decoder, table, &decoder->scan->frames[index], &result);
+        }
+        pthread_mutex_lock(&decoder->mutex);
+
+        // Blok, který převod mezitím uvolnil, se již nepotřebuje
+        if(index < decoder->released) {
+            free(result.pixels);
+            result.pixels = NULL;
+        }
+        // Blok bez bufferu se z obsazené paměti odečte
+        if(result.pixels == NULL) {
+            decoder->bufferBytes -= bufferSize;
+        }
+        // Zveřejnění výsledku a probuzení čekajících
+        decoder->frames[index] = result;
+        pthread_cond_broadcast(&decoder->cond);
+    }
+    pthread_mutex_unlock(&decoder->mutex);
+
+    // Uvolnění slovníku vlákna
+    free(table);
+    return NULL;
+}
+
+/*
+ * Funkce pro spuštění paralelního dekodéru bloků
+ *
+ * data        - data souboru od pozice předběžného průchodu
+ * length      - délka dat
+ * scan        - výsledek předběžného průchodu (musí existovat až do
+ *               zastavení dekodéru)
+ * threadCount - počet vláken
+ *
+ * Návratová hodnota:
+ *     dekodér, NULL při chybě (převod pak dekóduje bloky sám)
+ */
+tFrameDecoder *startFrameDecoder(const uint8_t *data, size_t length, const tGIFScan *scan, unsigned threadCount) {
+    // Alokace dekodéru a výsledků bloků
+    tFrameDecoder *decoder = (tFrameDecoder*)calloc(1, sizeof(tFrameDecoder));
+    if(decoder == NULL) {
+        return NULL;
+    }
+    decoder->frames = (tDecodedFrame*)calloc(scan->count > 0 ? scan->count : 1, sizeof(tDecodedFrame));
+    if(decoder->frames == NULL) {
+        free(decoder);
+        return NULL;
+    }
+
+    // Omezení počtu vláken
+    if(threadCount > FRAME_DECODER_MAX_THREADS) {
+        threadCount = FRAME_DECODER_MAX_THREADS;
+    }
+    // Nastavení dekodéru
+    decoder->data = data;
+    decoder->length = length;
+    decoder->scan = scan;
+    decoder->window = threadCount * FRAME_DECODER_WINDOW;
+    pthread_mutex_init(&decoder->mutex, NULL);
+    pthread_cond_init(&decoder->cond, NULL);
+
+    // Spuštění vláken
+    for(; decoder->threadCount < threadCount; decoder->threadCount++) {
+        if(pthread_create(&decoder->threads[decoder->threadCount], NULL, frameDecoderWorker, decoder) != 0) {
+            break;
+        }
+    }
+    // Bez jediného vlákna se dekodér nepoužije
+    if(decoder->threadCount == 0) {
+        stopFrameDecoder(decoder);
+        return NULL;
+    }
+
+    // Navrácení spuštěného dekodéru
+    return decoder;
+}
+
+/*
+ * Funkce pro čekání na dekódovaný blok
+ *
+ * decoder - dekodér
+ * index   - pořadí bloku
+ *
+ * Návratová hodnota:
+ *     dekódovaný blok (platný do jeho uvolnění)
+ */
+const tDecodedFrame *waitDecodedFrame(tFrameDecoder *decoder, uint32_t index) {
+    pthread_mutex_lock(&decoder->mutex);
+    // Čekání na dokončení bloku
+    while(decoder->frames[index].done == FLAG_FALSE) {
+        pthread_cond_wait(&decoder->cond, &decoder->mutex);
+    }
+    pthread_mutex_unlock(&decoder->mutex);
+    // Navrácení bloku
+    return &decoder->frames[index];
+}
+
+/*
+ * Funkce pro uvolnění bloku zpracovaného převodem
+ *
+ * Uvolní buffer bloku a posune okno dekódování za blok.
+ *
+ * decoder - dekodér
+ * index   - pořadí bloku
+ */
+void releaseDecodedFrame(tFrameDecoder *decoder, uint32_t index) {
+    pthread_mutex_lock(&decoder->mutex);
+    // Uvolnění bufferu dokončeného bloku (nedokončený uvolní vlákno)
+    if(decoder->frames[index].done == FLAG_TRUE && decoder->frames[index].pixels != NULL) {
+        free(decoder->frames[index].pixels);
+        decoder->frames[index].pixels = NULL;
+        decoder->bufferBytes -= getFrameBufferSize(&decoder->scan->frames[index]);
+    }
+    // Posun okna dekódování
+    if(decoder->released < index + 1) {
+        decoder->released = index + 1;
+    }
+    // Probuzení vláken čekajících na místo v okně
+    pthread_cond_broadcast(&decoder->cond);
+    pthread_mutex_unlock(&decoder->mutex);
+}
+
+/*
+ * Funkce pro zastavení dekodéru a uvolnění všech jeho prostředků
+ *
+ * decoder - dekodér
+ */
+void stopFrameDecoder(tFrameDecoder *decoder) {
+    // Zastavení vláken
+    pthread_mutex_lock(&decoder->mutex);
+    decoder->stop = FLAG_TRUE;
+    pthread_cond_broadcast(&decoder->cond);
+    pthread_mutex_unlock(&decoder->mutex);
+    // Čekání na dokončení rozpracovaných bloků
+    for(unsigned index = 0; index < decoder->threadCount; index++) {
+        pthread_join(decoder->threads[index], NULL);
+    }
+
+    // Uvolnění zbylých bufferů bloků
+    for(uint32_t index = 0; index < decoder->scan->count; index++) {
+        free(decoder->frames[index].pixels);
+    }
+    // Uvolnění dekodéru
+    pthread_mutex_destroy(&decoder->mutex);
+    pthread_cond_destroy(&decoder->cond);
+    free(decoder->frames);
+    free(decoder);
+}
@@ -0,0 +1,132 @@
+/*******************************************************************************
+*  Soubor:   framedecode.h                                                     *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Hlavičkový  soubor  paralelního  dekódování  image bloků. Každý image blok  *
+*  je samostatný LZW proud, jehož pozici zná předběžný průchod (gifscan.h).   *
+*  Vlákna dekódují bloky do vlastních bufferů indexů barev, převod je pak     *
+*  skládá do obrazu v pořadí souboru. Vlákna předbíhají skládání nejvýše o    *
+*  omezený počet bloků, takže paměť nezávisí na délce animace.                *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef FRAMEDECODE_H
+#define FRAMEDECODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "gifscan.h"
+#include "lzwbits.h"
+
+// Maximální počet vláken dekódování bloků
+#define FRAME_DECODER_MAX_THREADS 64
+// Počet bloků na vlákno, o které smí dekódování předběhnout skládání
+#define FRAME_DECODER_WINDOW 2
+
+/*
+ * Struktura jednoho dekódovaného bloku
+ *
+ * pixels      - indexy barev v pořadí dekódování (NULL - blok se
+ *               nedekódoval a převod jej musí dekódovat sám)
+ * count       - počet dekódovaných pixelů (nejvýše šířka * výška bloku)
+ * status      - výsledek dekódování (LZW_DECODE_*)
+ * invalidCode - neplatný kód při chybě dekódování
+ * lzwStats    - čítače dekódování bloku
+ * subBlocks   - počet dekódovaných sub-bloků dat bloku
+ * done        - příznak dokončení bloku vláknem
+ */
+typedef struct {
+    uint8_t *pixels;
+    uint32_t count;
+    int status;
+    uint16_t invalidCode;
+    tLZWDecodeStats lzwStats;
+    uint32_t subBlocks;
+    uint8_t done;
+} tDecodedFrame;
+
+/*
+ * Struktura paralelního dekodéru bloků
+ *
+ * mutex       - zámek stavu dekodéru
+ * cond        - podmínka pro dokončení bloku i uvolnění místa v okně
+ * threads     - pracovní vlákna
+ * threadCount - počet spuštěných vláken
+ * data        - data souboru, ke kterým se vztahují pozice bloků
+ * length      - délka dat
+ * scan        - výsledek předběžného průchodu
+ * frames      - dekódované bloky (stejné pořadí jako v scan)
+ * next        - další blok k dekódování
+ * released    - počet bloků od začátku, které převod již zpracoval
+ * window      - počet bloků, o které smí dekódování předběhnout převod
+ * bufferBytes - počet bajtů aktuálně alokovaných bufferů bloků
+ * bufferPeak  - největší počet bajtů současně alokovaných bufferů bloků
+ * stop        - příznak ukončení vláken
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t threads[FRAME_DECODER_MAX_THREADS];
+    unsigned threadCount;
+    const uint8_t *data;
+    size_t length;
+    const tGIFScan *scan;
+    tDecodedFrame *frames;
+    uint32_t next;
+    uint32_t released;
+    uint32_t window;
+    uint64_t bufferBytes;
+    uint64_t bufferPeak;
+    uint8_t stop;
+} tFrameDecoder;
+
+/*
+ * Funkce pro spuštění paralelního dekodéru bloků
+ *
+ * data        - data souboru od pozice předběžného průchodu
+ * length      - délka dat
+ * scan        - výsledek předběžného průchodu (musí existovat až do
+ *               zastavení dekodéru)
+ * threadCount - počet vláken
+ *
+ * Návratová hodnota:
+ *     dekodér, NULL při chybě (převod pak dekóduje bloky sám)
+ */
+tFrameDecoder *startFrameDecoder(const uint8_t *data, size_t length, const tGIFScan *scan, unsigned threadCount);
+
+/*
+ * Funkce pro čekání na dekódovaný blok
+ *
+ * decoder - dekodér
+ * index   - pořadí bloku
+ *
+ * Návratová hodnota:
+ *     dekódovaný blok (platný do jeho uvolnění)
+ */
+const tDecodedFrame *waitDecodedFrame(tFrameDecoder *decoder, uint32_t index);
+
+/*
+ * Funkce pro uvolnění bloku zpracovaného převodem
+ *
+ * Uvolní buffer bloku a posune okno dekódování za blok.
+ *
+ * decoder - dekodér
+ * index   - pořadí bloku
+ */
+void releaseDecodedFrame(tFrameDecoder *decoder, uint32_t index);
+
+/*
+ * Funkce pro zastavení dekodéru a uvolnění všech jeho prostředků
+ *
+ * decoder - dekodér
+ */
+void stopFrameDecoder(tFrameDecoder *decoder);
+
+#endif
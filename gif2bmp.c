@@ -23,375 +23,302 @@
 *                                                                              *
 *******************************************************************************/
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <math.h>
+#include <time.h>
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <inttypes.h>
 #include "gif2bmp.h"
+#include "gifinput.h"
+#include "lzwbits.h"
 
-// Informace z hlavičky vstupního souboru
-tGIFInfo info = {0, 0, 0, 0, 0, 0, 0, 0};
-// Ukazatel pro globální tabulku barev
-tRGB *globalColorTable = NULL;
-// Ukazatel pro lokální tabulku barev
-tRGB *localColorTable = NULL;
-// Vstupní soubor (GIF)
-FILE *inputGIFFile = NULL;
-// Výstupní soubor (BMP)
-FILE *outputBMPFile = NULL;
-// Ukazatel pro obrazová data v image bloku
-char *data = NULL;
-// Ukazatel na následující volný bajt při ukládání dat do *data
-uint32_t dataIndex = 0;
-// Ukazatel na aktuálně zpracovávaný bajt v *data
-uint32_t actualIndex = 0;
-// Proměnná pro minimální velikost LZW kódu
-uint8_t LZWMininumCodeSize = 0;
-// Proměnná pro BMP obrazová data
-tRGB **dataBMP = NULL;
-// Proměnná pro následující index tabulky barev pixelů
-uint32_t nextPixelIndex = 0;
-// Proměnná pro dorovnání indexu do tabulky nových indexů
-uint32_t eoiIndex = 0;
-// Proměnná pro velikost GIF souboru
-uint64_t gifSize = 0;
-// Proměnná pro velikost aktuálně používané tabulky barev
-uint16_t actualColorTableSize = 0;
-// Ukazatel na aktuálně používanou tabulku barev
-tRGB *actualColorTable = NULL;
-// Proměnná pro pořadové číslo image bloku
-uint8_t imageBlockNumber = 0;
-// Proměnná pro příznak průhlednosti
-uint8_t blockTrasparentColorFlag = 0;
-// Proměnná pro index průhledné barvy
-uint8_t transparentColorIndex = 0;
-// Horní index image bloku
-uint32_t actualTop = 0;
-// Levý index image bloku
-uint32_t actualLeft = 0;
-// Šířka image bloku
-uint32_t actualWidth = 0;
-// Výška image bloku
-uint32_t actualHeight = 0;
-// Proměnná pro příznak prokládání
-uint8_t blockInterlaceFlag = FLAG_FALSE;
-// Proměnná pro aktuální proložený řádek
-uint32_t actualInterlaceRow = 0;
-// Proměnná pro aktuální stav prokládání
-uint8_t interlaceState = STATE0;
-
-/*
- * Funkce pro získání souřadnice řádku zpracovávaného bloku
- */
-uint32_t getRowIndex() {
-    // Proměnná pro návratovou hodnotu
-    uint32_t rowIdx = 0;
-
-    // Pokud je nastaven příznak prokládání
-    if(blockInterlaceFlag == FLAG_TRUE) {
-        // Aktuální řádek se bude řídit prokládáním
-        rowIdx = actualInterlaceRow + actualTop;
-
-        // Pokud je aktuální index na konci řádku
-        if(nextPixelIndex > 0 && ((nextPixelIndex + 1) % actualWidth) == 0) {
-            // Posunutí indexu řádku na další proložený
-            switch(interlaceState) {
-                // Prokládání 8n
-                case STATE0: {
-                    // Posun na další řádek o 8
-                    actualInterlaceRow += 8;
-                    // Konec větve
-                    break;
-                }
-                // Prokládání 8n+4
-                case STATE1: {
-                    // Posun na další řádek o 8
-                    actualInterlaceRow += 8;
-                    // Konec větve
-                    break;
-                }
-                // Prokládání 4n+2
-                case STATE2: {
-                    // Posun na další řádek o 4
-                    actualInterlaceRow += 4;
-                    // Konec větve
-                    break;
-                }
-                // Prokládání 2n+1
-                case STATE3: {
-                    // Posun na další řádek o 2
-                    actualInterlaceRow += 2;
-                    // Konec větve
-                    break;
-                }
-            }
-
-            // Pokud číslo řádku překročilo aktuální výšku bloku
-            if(actualInterlaceRow >= actualHeight) {
-                // Posun na další stav prokládání
-                interlaceState++;
-
-                // Nastavení iniciální hodnoty podle nového stavu prokládání
-                switch(interlaceState) {
-                    // Pro stav 8n
-                    case STATE0: {
-                        // Prokládání začíná na 0
-                        actualInterlaceRow = 0;
-                        // Konec větve
-                        break;
-                    }
-                    // Pro stav 8n+4
-                    case STATE1: {
-                        // Prokládání začíná na 4
-                        actualInterlaceRow = 4;
-                        // Konec větve
-                        break;
-                    }
-                    // Pro stav 4n+2
-                    case STATE2: {
-                        // Prokládání začíná na 2
-                        actualInterlaceRow = 2;
-                        // Konec větve
-                        break;
-                    }
-                    // Pro stav 2n+1
-                    case STATE3: {
-                        // Prokládání začíná na 1
-                        actualInterlaceRow = 1;
-                        // Konec větve
-                        break;
-                    }
-                }
-            }
+/*
+ * Funkce pro sestavení mapy řádků aktuálního bloku
+ *
+ * Pro každé pořadí dekódovaného řádku se jednou za blok určí řádek bloku,
+ * do kterého pixely patří. Prokládaný blok prochází řádky 8n, 8n+4, 4n+2
+ * a 2n+1, průchod bez řádků uvnitř bloku (nízký blok) se přeskočí. Mapa
+ * tak obsahuje každý řádek bloku právě jednou.
+ */
+void makeRowMap(tGIF2BMPContext *context) {
+    // První řádky průchodů prokládání
+    static const uint8_t interlaceStart[] = {0, 4, 2, 1};
+    // Kroky průchodů prokládání
+    static const uint8_t interlaceStep[] = {8, 8, 4, 2};
+    // Pořadí dalšího určovaného řádku
+    uint32_t rowNumber = 0;
+
+    // Pokud není blok prokládaný, řádky jdou postupně
+    if(context->blockInterlaceFlag != FLAG_TRUE) {
+        for(rowNumber = 0; rowNumber < context->actualHeight; rowNumber++) {
+            context->rowMap[rowNumber] = (uint16_t)rowNumber;
         }
-    } else {
-        // Pokud není GIF prokládaný
-
-        // Výpočet čísla řádku bez prokládání
-        rowIdx = ((nextPixelIndex / actualWidth) + actualTop);
+        return;
     }
 
-    // Navrácení souřadnice řádku bloku
-    return rowIdx;
+    // Průchody prokládání, každý jen přes řádky uvnitř bloku
+    for(uint8_t state = STATE0; state <= STATE3; state++) {
+        for(uint32_t row = interlaceStart[state]; row < context->actualHeight; row += interlaceStep[state]) {
+            context->rowMap[rowNumber++] = (uint16_t)row;
+        }
+    }
 }
 
 /*
- * Funkce pro získání souřadnice sloupce zpracovávaného bloku
+ * Funkce pro získání času monotónních hodin (měření fází převodu)
+ *
+ * Návratová hodnota:
+ *     čas v sekundách od libovolného pevného okamžiku
  */
-uint32_t getColIndex() {
-    // Výpočet a navrácení souřadnice sloupce bloku
-    return ((nextPixelIndex % actualWidth) + actualLeft);
+double getMonotonicTime(void) {
+    // Aktuální čas monotónních hodin
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
 }
 
 /*
- * Funkce pro načtení a navrácení hodnoty jednoho bajtu ze vstupního GIF souboru
+ * Funkce pro započtení bufferů mimo obrazová data do nejvyšší paměti
+ *
+ * K bufferům se přičte řádek průběžného zápisu, který existuje po celý
+ * převod.
+ *
+ * context - kontext převodu
+ * bytes   - počet bajtů současně alokovaných bufferů
  */
-int getByte() {
-    // Načtení jednoho bajtu
-    int bajt = fgetc(inputGIFFile);
-
-    // Kontrola, zda nebylo dosaženo konce souboru předčasně
-    if(bajt == EOF) {
-        // Výpis chybového hlášení
-        fprintf(stderr, "ERROR: End of file reached.\n");
-        // Ukončení programu s chybou
-        exit(RETURN_FAILURE);
+void noteBufferMemory(tGIF2BMPContext *context, uint64_t bytes) {
+    // Řádek průběžného zápisu
+    if(context->dataBMP != NULL) {
+        bytes += context->bmpRowWidth;
+    }
+    // Nejvyšší obsazení bufferů
+    if(bytes > context->bufferPeak) {
+        context->bufferPeak = bytes;
     }
-
-    // Inkrementace velikosti GIF
-    gifSize++;
-    // Navrácení hodnoty bajtu
-    return bajt;
 }
 
 /*
- * Funkce pro zápis 2 bajtů v little-endian formátu do výstupního souboru
+ * Funkce pro započtení paměti převodu do záznamu o převodu
  *
- * bytes - 2 bajty pro zápis do souboru
+ * Záznam si ponechá nejvyšší hodnotu ze všech průchodů souborem.
+ *
+ * context - kontext převodu (paralelní dekodér již zastaven)
  */
-void write2Bytes(uint16_t bytes) {
-    // Získání spodního bajtu pro zápis
-    char byteToWrite = (bytes % BYTE_OVERFLOW);
-    // Zápis spodního bajtu do souboru
-    fprintf(outputBMPFile, "%c", byteToWrite);
-    // Získání horního bajtu pro zápis
-    byteToWrite = (bytes / BYTE_OVERFLOW);
-    // Zápis horního bajtu do souboru
-    fprintf(outputBMPFile, "%c", byteToWrite);
+void updateMemoryStats(tGIF2BMPContext *context) {
+    // Nejvyšší obsazení rozpočtu obrazových dat
+    if(context->canvasBudget.peak > context->stats.canvasPeak) {
+        context->stats.canvasPeak = context->canvasBudget.peak;
+    }
+    // Nejvyšší paměť převodu včetně bufferů mimo obrazová data
+    if((int64_t)(context->canvasBudget.peak + context->bufferPeak) > context->stats.peakMemory) {
+        context->stats.peakMemory = (int64_t)(context->canvasBudget.peak + context->bufferPeak);
+    }
 }
 
 /*
- * Funkce pro zápis 4 bajtů v little-endian formátu do výstupního souboru
+ * Funkce pro nastavení chyby převodu
+ *
+ * Chyba se zaznamená do kontextu (hlášení se tiskne jen pro první chybu),
+ * zpracování se pak ukončí návratovými hodnotami funkcí.
  *
- * bytes - 4 bajty pro zápis do souboru
+ * context - kontext převodu
+ * message - chybové hlášení
  */
-void write4Bytes(uint32_t bytes) {
-    // Pomocná proměnná pro jeden bajt k zápisu
-    char byte = 0;
-    // Cyklus získání a zápisu 4 bajtů do souboru
-    for(uint8_t step = 0; step < 4; step++) {
-        // Získání dalšího (vyššího) bajtu pro zápis
-        byte = (bytes % BYTE_OVERFLOW);
-        // Zápis bajtu do souboru
-        fprintf(outputBMPFile, "%c", byte);
-        // Získání zbylých bajtů k zápisu
-        bytes = bytes / BYTE_OVERFLOW;
+void setError(tGIF2BMPContext *context, const char *message) {
+    // Tisk pouze první chyby převodu
+    if(context->error == RETURN_SUCCESS) {
+        // Výpis chybového hlášení
+        fprintf(stderr, "ERROR: %s\n", message);
     }
+    // Uložení chybového stavu
+    context->error = RETURN_FAILURE;
 }
 
 /*
- * Funkce pro inicializaci jedné položky tabulky indexů barev
+ * Funkce pro načtení souvislého úseku bajtů ze vstupního GIF souboru
+ *
+ * context - kontext převodu
+ * count   - počet požadovaných bajtů
  *
- * item - položka k inicializaci
+ * Návratová hodnota:
+ *     ukazatel na bajty, NULL při předčasném konci souboru
  */
-void initTableItem(tItem *item) {
-    // Nastavení aktuální alokované paměti v položce
-    item->allocated = ITEM_ALLOC_SIZE;
-    // Nastavení počtu využitých bajtů v položce
-    item->used = 0;
-    // Alokace pole indexů do tabulky barev
-    item->indexList = (uint8_t*)malloc(item->allocated * sizeof(uint8_t));
-    // Kontrola alokace
-    if(item->indexList == NULL) {
-        // Tisk chyby
-        fprintf(stderr, "ERROR: item->indexList malloc failed.\n");
-        // Konec programu s chybou
-        exit(RETURN_FAILURE);
+const uint8_t *getBytes(tGIF2BMPContext *context, size_t count) {
+    // Načtení úseku bajtů
+    const uint8_t *bytes = getInputBytes(&context->input, count);
+
+    // Kontrola, zda nebylo dosaženo konce souboru předčasně
+    if(bytes == NULL) {
+        // Nastavení chyby
+        setError(context, "End of file reached.");
     }
+
+    // Navrácení úseku bajtů
+    return bytes;
 }
 
 /*
- * Funkce pro zvětšení alokovaného prostoru v položce tabulky indexů barev
+ * Funkce pro přeskočení bajtů vstupního GIF souboru
  *
- * item - položka pro zvětšení alokovaného prostoru
+ * context - kontext převodu
+ * count   - počet přeskakovaných bajtů
+ *
+ * Návratová hodnota:
+ *      0 - bajty byly přeskočeny
+ *     -1 - předčasný konec souboru
  */
-void resizeTableItem(tItem *item) {
-    // Zvýšení počtu alokovaných bajtů v položce
-    item->allocated += ITEM_ALLOC_SIZE;
-    // Realokace alokovaného prostoru pro pole indexů do tabulky barev
-    item->indexList = (uint8_t*)realloc(item->indexList, item->allocated * sizeof(uint8_t));
-    // Kontrola realokace
-    if(item->indexList == NULL) {
-        // Tisk chyby
-        fprintf(stderr, "ERROR: item->indexList realloc failed.\n");
-        // Konec programu s chybou
-        exit(RETURN_FAILURE);
+int skipBytes(tGIF2BMPContext *context, size_t count) {
+    // Kontrola, zda nebylo dosaženo konce souboru předčasně
+    if(skipInputBytes(&context->input, count) != RETURN_SUCCESS) {
+        // Nastavení chyby
+        setError(context, "End of file reached.");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
     }
+    // Bajty byly přeskočeny
+    return RETURN_SUCCESS;
 }
 
 /*
- * Funkce pro uvolnění alokované paměti položky tabulky indexů barev
+ * Funkce pro načtení a navrácení hodnoty jednoho bajtu ze vstupního GIF souboru
  *
- * item - položka pro uvolnění paměti
+ * context - kontext převodu
+ *
+ * Návratová hodnota:
+ *     hodnota bajtu, EOF při předčasném konci souboru
  */
-void freeTableItem(tItem *item) {
-    // Uvolnění paměti po seznamu indexů do tabulky barev v položce
-    free(item->indexList);
+int getByte(tGIF2BMPContext *context) {
+    // Ukazatel na bajt získaný po doplnění vstupu
+    const uint8_t *bajt = NULL;
+
+    // Rychlá cesta - bajt je k dispozici bez čtení souboru
+    if(context->input.position < context->input.length) {
+        // Započtení bajtu do velikosti GIF
+        context->input.offset++;
+        // Navrácení hodnoty bajtu
+        return context->input.data[context->input.position++];
+    }
+    // Doplnění vstupu
+    bajt = getBytes(context, 1);
+    // Navrácení hodnoty bajtu nebo EOF
+    return (bajt != NULL) ? *bajt : EOF;
 }
 
 /*
- * Funkce pro přidání jednoho indexu do seznamu indexů tabulky barev v položce
+ * Funkce pro načtení 2 bajtů v little-endian formátu
  *
- * item  - položka pro přidání indexu
- * index - přidávaný index
+ * bytes - ukazatel na 2 bajty
  */
-void addByteToTableItem(tItem *item, uint8_t index) {
-    // Pokud je seznam indexů v položce plný
-    if(item->allocated == item->used) {
-        // Zvětšení prostoru pro indexy
-        resizeTableItem(item);
-    }
-    // Uložení nového indexu do pole v položce
-    item->indexList[item->used] = index;
-    // Zvýšení počtu využitých míst v poli indexu položky
-    item->used++;
+uint16_t readWord(const uint8_t *bytes) {
+    // Složení hodnoty z dolního a horního bajtu
+    return (uint16_t)(bytes[0] + (bytes[1] * BYTE_OVERFLOW));
 }
 
 /*
- * Funkce pro inicializaci tabulky indexů barev
+ * Funkce pro přidání 2 bajtů v little-endian formátu do hlavičky BMP
  *
- * table - tabulka pro inicializaci
+ * header - sestavovaná hlavička
+ * bytes  - 2 bajty pro přidání do hlavičky
  */
-void initTable(tTable *table) {
-    // Nastavení aktuální alokované paměti v tabulce
-    table->allocated = TABLE_ALLOC_SIZE;
-    // Nastavení počtu využitých míst v tabulce
-    table->used = 0;
-    // Alokace místa pro položky tabulky
-    table->itemList = (tItem*)malloc(table->allocated * sizeof(tItem));
-    // Kontrola alokace
-    if(table->itemList == NULL) {
-        // Tisk chyby
-        fprintf(stderr, "ERROR: table->itemList malloc failed.\n");
-        // Konec programu s chybou
-        exit(RETURN_FAILURE);
-    }
+void put2Bytes(tBMPHeader *header, uint16_t bytes) {
+    // Uložení spodního bajtu
+    header->bytes[header->used++] = (uint8_t)(bytes % BYTE_OVERFLOW);
+    // Uložení horního bajtu
+    header->bytes[header->used++] = (uint8_t)(bytes / BYTE_OVERFLOW);
 }
 
 /*
- * Funkce pro zvětšení místa pro položky tabulky indexů barev
+ * Funkce pro přidání 4 bajtů v little-endian formátu do hlavičky BMP
  *
- * table - tabulka pro zvětšení místa
+ * header - sestavovaná hlavička
+ * bytes  - 4 bajty pro přidání do hlavičky
  */
-void resizeTable(tTable *table) {
-    // Zvýšení počtu alokovaných míst v tabulce
-    table->allocated += TABLE_ALLOC_SIZE;
-    // Realokace prostoru pro položky tabulky
-    table->itemList = (tItem*)realloc(table->itemList, table->allocated * sizeof(tItem));
-    // Kontrola realokace
-    if(table->itemList == NULL) {
-        // Tisk chyby
-        fprintf(stderr, "ERROR: table->itemList realloc failed.\n");
-        // Konec programu s chybou
-        exit(RETURN_FAILURE);
+void put4Bytes(tBMPHeader *header, uint32_t bytes) {
+    // Cyklus uložení 4 bajtů od nejnižšího
+    for(uint8_t step = 0; step < 4; step++) {
+        // Uložení dalšího (vyššího) bajtu
+        header->bytes[header->used++] = (uint8_t)(bytes % BYTE_OVERFLOW);
+        // Získání zbylých bajtů k uložení
+        bytes = bytes / BYTE_OVERFLOW;
     }
 }
 
 /*
- * Funkce pro uvolnění alokované paměti celé tabulky indexů barev
+ * Funkce pro inicializaci slovníku LZW po clear kódu
  *
- * table - tabulka pro uvolnění
+ * table     - slovník pro inicializaci
+ * clearCode - hodnota clear kódu (počet kořenových položek slovníku)
  */
-void freeTable(tTable *table) {
-    // Cyklus pro uvolňování paměti po položkách tabulky
-    for(uint32_t itemIndex = 0; itemIndex < table->used; itemIndex++) {
-        // Uvolnění paměti po jedné položce tabulky
-        freeTableItem(&(table->itemList[itemIndex]));
+void resetLZWTable(tLZWTable *table, uint16_t clearCode) {
+    // Naplnění kořenových položek slovníku (jednotlivé indexy barev)
+    for(uint16_t code = 0; code < clearCode; code++) {
+        // Kořenová položka nemá prefix
+        table->prefix[code] = 0;
+        // Poslední a zároveň první index barvy je kód samotný
+        table->suffix[code] = (uint8_t)code;
+        table->first[code] = (uint8_t)code;
+        // Řetězec kořenové položky má délku 1
+        table->length[code] = 1;
     }
-    // Uvolnění místa po položkách v tabulce
-    free(table->itemList);
+    // První volný kód následuje za clear kódem a EOI
+    table->used = clearCode + 2;
 }
 
 /*
- * Funkce pro vložení nové položky do tabulky indexů barev
+ * Funkce pro přidání nové položky do slovníku LZW
  *
- * table - tabulka, do které se vkládá nová položka
- * item  - nová vkládaná položka
+ * table      - slovník, do kterého se vkládá nová položka
+ * prefixCode - kód řetězce, který nová položka prodlužuje
+ * suffix     - index barvy přidaný na konec řetězce
  */
-void insertNewItem(tTable *table, tItem *item) {
-    // Pokud jsou obsazená všechna místa v tabulce
-    if(table->allocated == table->used) {
-        // Zvětšení místa pro další položky
-        resizeTable(table);
+void addLZWTableItem(tLZWTable *table, uint16_t prefixCode, uint8_t suffix) {
+    // Pokud je slovník plný, nová položka se nepřidává (odložený clear kód)
+    if(table->used >= LZW_TABLE_SIZE) {
+        return;
     }
-    // Uložení nové položky do tabulky
-    table->itemList[table->used] = *item;
-    // Zvýšení počtu využitých položek v tabulce
+    // Uložení odkazu na prodlužovaný řetězec
+    table->prefix[table->used] = prefixCode;
+    // Uložení přidaného indexu barvy
+    table->suffix[table->used] = suffix;
+    // První index barvy se dědí z prefixu
+    table->first[table->used] = table->first[prefixCode];
+    // Délka je o jedna větší než délka prefixu
+    table->length[table->used] = table->length[prefixCode] + 1;
+    // Posun na další volný kód
     table->used++;
 }
 
 /*
- * Funkce pro získání položky z tabulky indexů barev podle indexu
+ * Funkce pro rozvinutí řetězce kódu do pomocného pole slovníku
+ *
+ * Řetězec se zapisuje od konce, protože průchod po prefixech vrací
+ * indexy barev v opačném pořadí.
+ *
+ * table - slovník LZW
+ * code  - kód rozvíjeného řetězce
  *
- * table - tabulka s položkami
- * index - index požadované položky
+ * Návratová hodnota:
+ *     délka rozvinutého řetězce v table->stack
  */
-tItem *getItemByIndex(tTable *tab, uint32_t index) {
-    // Úprava indexu do tabulky - indexy následují až po EOI
-    index = index - eoiIndex;
-    // Navrácení požadované položky
-    return &(tab->itemList[index]);
+uint16_t unpackLZWTableItem(tLZWTable *table, uint16_t code) {
+    // Délka rozvíjeného řetězce
+    uint16_t length = table->length[code];
+    // Pozice pro zápis dalšího indexu barvy (od konce)
+    uint16_t position = length;
+
+    // Průchod řetězcem od posledního indexu barvy k prvnímu
+    while(position > 0) {
+        // Zápis indexu barvy na jeho pozici v řetězci
+        table->stack[--position] = table->suffix[code];
+        // Posun na prefix řetězce
+        code = table->prefix[code];
+    }
+
+    // Navrácení délky řetězce
+    return length;
 }
 
 /*
@@ -401,9 +328,7 @@ tItem *getItemByIndex(tTable *tab, uint32_t index) {
  *         0 - bez chyby
  *        -1 - nastala chyba
  */
-int checkGIFSignature() {
-    // Index signatury vstupního souboru
-    uint8_t inputSignatureIndex = 0;
+int checkGIFSignature(tGIF2BMPContext *context) {
     // Pole pro uložení vstupní signatury souboru
     char fileSignature[GIF_SIGNATURE_LENGTH + 1];
 
@@ -411,12 +336,14 @@ int checkGIFSignature() {
     // fprintf(stderr, "INFO: Checking GIF signature\n");
 
     // Načtení signatury vstupního souboru
-    for(inputSignatureIndex = 0; inputSignatureIndex < GIF_SIGNATURE_LENGTH; inputSignatureIndex++) {
-        // Načtení jednoho znaku signatury vstupního souboru do pole
-        fileSignature[inputSignatureIndex] = getByte();
+    const uint8_t *signature = getBytes(context, GIF_SIGNATURE_LENGTH);
+    // Kontrola konce souboru
+    if(signature == NULL) {
+        return RETURN_FAILURE;
     }
+    memcpy(fileSignature, signature, GIF_SIGNATURE_LENGTH);
     // Ukončení pole signatury vstupního souboru
-    fileSignature[inputSignatureIndex] = '\0';
+    fileSignature[GIF_SIGNATURE_LENGTH] = '\0';
 
     // Porovnání signatury vstupního souboru a podporované signatury
     if(strcmp(GIF_SIGNATURE, fileSignature) == 0) {
@@ -430,6 +357,8 @@ int checkGIFSignature() {
         fprintf(stderr, "Expected: %s\n", GIF_SIGNATURE);
         // Tisk špatné/nepodporované signatury vstupního souboru
         fprintf(stderr, "Found:    %s\n", fileSignature);
+        // Uložení chybového stavu
+        context->error = RETURN_FAILURE;
         // Ukončení funkce s chybou
         return RETURN_FAILURE;
     }
@@ -437,677 +366,2036 @@ int checkGIFSignature() {
 
 /*
  * Funkce pro získání informací z hlavičky vstupního souboru
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - předčasný konec souboru
  */
-void getGIFInfo() {
+int getGIFInfo(tGIF2BMPContext *context) {
     // Proměnná pro bitové pole hlavičky
     uint8_t headerBitField;
     // Pomocná proměnná pro mocninu velikosti globální tabulky barev
     uint8_t globalColorTablePower;
+    // Načtení celého popisu logické obrazovky najednou
+    const uint8_t *header = getBytes(context, LOGICAL_SCREEN_DESCRIPTOR_SIZE);
+    // Kontrola konce souboru
+    if(header == NULL) {
+        return RETURN_FAILURE;
+    }
 
     // Získání šířky souboru z hlavičky
-    info.imageWidth  = getByte();
-    info.imageWidth += (getByte() * BYTE_OVERFLOW);
+    context->info.imageWidth = readWord(&header[0]);
 
     // Získání výšky souboru z hlavičky
-    info.imageHeight  = getByte();
-    info.imageHeight += (getByte() * BYTE_OVERFLOW);
+    context->info.imageHeight = readWord(&header[2]);
 
     // Získání bitového pole z hlavičky
-    headerBitField = getByte();
+    headerBitField = header[4];
 
     // Získání příznaku pro globální tabulku barev
     if((headerBitField & AND_OF_COLOR_TABLE_FLAG) == AND_OF_COLOR_TABLE_FLAG) {
-        info.gctFlag = FLAG_TRUE;
+        context->info.gctFlag = FLAG_TRUE;
     } else {
-        info.gctFlag = FLAG_FALSE;
+        context->info.gctFlag = FLAG_FALSE;
     }
 
     // Zjištění počtu bitů na pixel
-    info.bpp = (headerBitField & AND_OF_BPP);
-    info.bpp = info.bpp >> BPP_SHIFT;
-    info.bpp++;
+    context->info.bpp = (headerBitField & AND_OF_BPP);
+    context->info.bpp = context->info.bpp >> BPP_SHIFT;
+    context->info.bpp++;
 
     // Získání příznaku setřídění globální tabulky barev
     if((headerBitField & AND_OF_SORT_FLAG) == AND_OF_SORT_FLAG) {
-        info.gctSortFlag = FLAG_TRUE;
+        context->info.gctSortFlag = FLAG_TRUE;
     } else {
-        info.gctSortFlag = FLAG_FALSE;
+        context->info.gctSortFlag = FLAG_FALSE;
     }
 
     // Získání velikosti globální tabulky barev
     globalColorTablePower = (headerBitField & AND_OF_COLOR_TABLE_SIZE);
     globalColorTablePower++;
-    info.gctSize = (uint16_t)pow(2, globalColorTablePower);
+    context->info.gctSize = (uint16_t)pow(2, globalColorTablePower);
 
     // Získání indexu barvy pozadí
-    info.bgColorIndex = getByte();
+    context->info.bgColorIndex = header[5];
 
     // Získání poměru výšky a šířky pixelu
-    info.paRatio = getByte();
+    context->info.paRatio = header[6];
+
+    // Hlavička byla načtena
+    return RETURN_SUCCESS;
 }
 
 /*
  * Funkce pro vytvoření globální tabulky barev
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - chyba alokace nebo předčasný konec souboru
  */
-void makeGCT() {
+int makeGCT(tGIF2BMPContext *context) {
     // Alokace prostoru pro globální tabulku barev
-    globalColorTable = (tRGB*)malloc(sizeof(tRGB) * info.gctSize);
+    context->globalColorTable = (tRGB*)malloc(sizeof(tRGB) * context->info.gctSize);
     // Kontrola alokace
-    if(globalColorTable == NULL) {
+    if(context->globalColorTable == NULL) {
         // Tisk chyby
-        fprintf(stderr, "ERROR: globalColorTable malloc failed.\n");
-        // Konec programu s chybou
-        exit(RETURN_FAILURE);
+        setError(context, "globalColorTable malloc failed.");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
     }
 
-    // Načtení jednotlivých barev globální tabulky
-    for(uint16_t index = 0; index < info.gctSize; index++) {
+    // Načtení celé globální tabulky barev najednou
+    const uint8_t *colors = getBytes(context, context->info.gctSize * ONE_PIXEL_SIZE);
+    // Kontrola konce souboru
+    if(colors == NULL) {
+        return RETURN_FAILURE;
+    }
+    // Rozdělení jednotlivých barev globální tabulky
+    for(uint16_t index = 0; index < context->info.gctSize; index++) {
         // Červená složka
-        globalColorTable[index].r = getByte();
+        context->globalColorTable[index].r = colors[index * ONE_PIXEL_SIZE];
         // Zelená složka
-        globalColorTable[index].g = getByte();
+        context->globalColorTable[index].g = colors[index * ONE_PIXEL_SIZE + 1];
         // Modrá složka
-        globalColorTable[index].b = getByte();
+        context->globalColorTable[index].b = colors[index * ONE_PIXEL_SIZE + 2];
     }
+
+    // Tabulka barev byla načtena
+    return RETURN_SUCCESS;
 }
 
 /*
  * Funkce pro vytvoření lokální tabulky barev
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - chyba alokace nebo předčasný konec souboru
  */
-void makeLCT(uint16_t lctSize) {
+int makeLCT(tGIF2BMPContext *context, uint16_t lctSize) {
     // Alokace prostoru pro lokální tabulku barev
-    localColorTable = (tRGB*)malloc(sizeof(tRGB) * lctSize);
+    context->localColorTable = (tRGB*)malloc(sizeof(tRGB) * lctSize);
     // Kontrola alokace
-    if(localColorTable == NULL) {
+    if(context->localColorTable == NULL) {
         // Tisk chyby
-        fprintf(stderr, "ERROR: localColorTable malloc failed.\n");
-        // Konec programu s chybou
-        exit(RETURN_FAILURE);
+        setError(context, "localColorTable malloc failed.");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
     }
 
-    // Načtení jednotlivých barev lokální tabulky
+    // Načtení celé lokální tabulky barev najednou
+    const uint8_t *colors = getBytes(context, lctSize * ONE_PIXEL_SIZE);
+    // Kontrola konce souboru
+    if(colors == NULL) {
+        return RETURN_FAILURE;
+    }
+    // Rozdělení jednotlivých barev lokální tabulky
     for(uint16_t index = 0; index < lctSize; index++) {
         // Červená složka
-        localColorTable[index].r = getByte();
+        context->localColorTable[index].r = colors[index * ONE_PIXEL_SIZE];
         // Zelená složka
-        localColorTable[index].g = getByte();
+        context->localColorTable[index].g = colors[index * ONE_PIXEL_SIZE + 1];
         // Modrá složka
-        localColorTable[index].b = getByte();
+        context->localColorTable[index].b = colors[index * ONE_PIXEL_SIZE + 2];
     }
+
+    // Tabulka barev byla načtena
+    return RETURN_SUCCESS;
 }
 
 /*
- * Funkce pro alokaci výsledných barev pro zápis do výstupního souboru
+ * Funkce pro nastavení chyby alokace obrazových dat
+ *
+ * Rozlišuje překročení rozpočtu paměti a chybu alokace.
+ *
+ * name - název alokovaných dat
  */
-void allocBMPData() {
-    // Alokace počtu řádků výsledného obrázku
-    dataBMP = malloc(info.imageHeight * sizeof(tRGB*));
-    // Kontrola alokace
-    if(dataBMP == NULL) {
-        // Tisk chyby
-        fprintf(stderr, "ERROR: dataBMP malloc failed.\n");
-        // Konec programu s chybou
-        exit(RETURN_FAILURE);
-    }
-    // Cyklus alokace sloupců (celých řádků) pro výsledné hodnoty barev
-    for(uint32_t colIndex = 0; colIndex < info.imageHeight; colIndex++) {
-        // Alokace jednoho celého řádku indexů
-        dataBMP[colIndex] = (tRGB*)malloc(info.imageWidth * sizeof(tRGB));
-        // Kontrola alokace
-        if(dataBMP[colIndex] == NULL) {
-            // Tisk chyby
-            fprintf(stderr, "ERROR: dataBMP[colIndex] malloc failed.\n");
-            // Konec programu s chybou
-            exit(RETURN_FAILURE);
-        }
+void setCanvasError(tGIF2BMPContext *context, const char *name) {
+    // Alokaci odmítl rozpočet paměti
+    if(context->canvasBudget.exceeded == FLAG_TRUE) {
+        setError(context, "Memory limit exceeded.");
+    } else {
+        setError(context, name);
     }
 }
 
 /*
- * Funkce pro výpis výsledných barev na standardní výstup (informační)
+ * Funkce pro získání řádku obrazových dat s alokací jeho pásu
+ *
+ * canvas - obrazová data
+ * row    - řádek obrazových dat
+ *
+ * Návratová hodnota:
+ *     ukazatel na řádek, NULL při chybě (chyba je nastavena)
  */
-void printPixels() {
-    // Cyklus procházení řádků tabulky
-    for(uint32_t row = 0; row < info.imageHeight; row++) {
-        // Cyklus procházení sloupců v řádku tabulky
-        for(uint32_t col = 0; col < info.imageWidth; col++) {
-            // Výpis hodnot barev na pozici řádek:sloupec
-
-            // Červená složka
-            printf("%02x", dataBMP[row][col].r);
-            // Zelená složka
-            printf("%02x", dataBMP[row][col].g);
-            // Modrá složka
-            printf("%02x ", dataBMP[row][col].b);
-        }
-        // Odřádkování každého řádku tabulky
-        printf("\n");
+uint8_t *touchCanvasRow(tGIF2BMPContext *context, tCanvas *canvas, uint32_t row) {
+    // Řádek, příp. nově alokovaný pás
+    uint8_t *rowData = getCanvasRow(canvas, row);
+    // Kontrola alokace
+    if(rowData == NULL) {
+        setCanvasError(context, "Canvas band malloc failed.");
     }
-
-    // Výpis celkového počtu indexů v tabulce
-    printf("\n%d\n", nextPixelIndex);
+    return rowData;
 }
 
 /*
- * Funkce pro uvolnění paměti po tabulce výsledných barev
+ * Funkce pro získání ukazatele na pixel výsledných barev
+ *
+ * row - řádek obrázku (shora)
+ * col - sloupec obrázku
+ *
+ * Návratová hodnota:
+ *     ukazatel na pixel, NULL při chybě alokace (chyba je nastavena)
  */
-void freeBMPData() {
-    // Cyklus procházení řádků tabulky
-    for(uint32_t row = 0; row < info.imageHeight; row++) {
-        // Uvolnění jednoho celého řádku tabulky
-        free(dataBMP[row]);
-    }
-    // Uvolnění místa po řádcích tabulky
-    free(dataBMP);
+uint8_t *getBMPPixel(tGIF2BMPContext *context, uint32_t row, uint32_t col) {
+    // Řádky jsou v BMP uloženy zdola nahoru
+    uint8_t *rowData = touchCanvasRow(context, &context->bgrCanvas, context->info.imageHeight - 1 - row);
+    return (rowData == NULL) ? NULL : rowData + (size_t)col * ONE_PIXEL_SIZE;
 }
 
 /*
- * Funkce pro zápis výsledných dat do BMP výstupního souboru
+ * Funkce pro alokaci výsledných barev pro zápis do výstupního souboru
+ *
+ * Řádky jsou přesně ve tvaru pixelových dat BMP souboru - zdola nahoru,
+ * pixely v pořadí BGR a každý řádek zarovnaný nulami na násobek 4 bajtů.
+ * Pásy řádků se alokují až při vykreslení (nealokované řádky jsou černé).
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - chyba alokace
  */
-void writeBMPData(tGIF2BMP *logInfo) {
-    // Proměnná pro uložení počtu batjů k zarovnání jednoho řádku výsledných dat
-    // na délku násobku 4 bajtů
-    uint8_t addition = 0;
-    // Proměnná počtu bajtů pro jeden řádek ve výsledném souboru
-    uint16_t rowWidth = info.imageWidth * ONE_PIXEL_SIZE;
-    // Získání počtu bajtů pro jeden řádek
-    // a dorovnání počtu bajtů na násobek 4 bajtů
-    while((rowWidth % ROW_MULT_SIZE) > 0) {
-        // Inkrementace délky řádku v bajtech
-        rowWidth++;
-        // Inkrementace počtu bajtů na dorovnání řádku
-        addition++;
-    }
-
-    // BITMAPFILEHEADER - zápis hlavičky
-    // Identifikátor formátu BMP
-    char bfType[] = BMP_IDENTIFICATOR;
-    // Zápis identifikátoru BMP souboru
-    fprintf(outputBMPFile, bfType);
-    // Celková velikost souboru s obrazovými údaji
-    uint32_t bfSize = BITMAPFILEHEADER_SIZE  // Velikost hlavičky
-                    + BITMAPINFOHEADER_SIZE  // Velikost informační hlavičky
-                    + (info.imageHeight * info.imageWidth * ONE_PIXEL_SIZE)  // Velikost plochy obrázku
-                    + (info.imageHeight * addition);  // Bajty pro doplnění délky řádku na násobek 4
-    // Uložení velikosti BMP souboru pro log
-    if(logInfo != NULL) logInfo->bmpSize = bfSize;
-    // Zápis celkové velikosti souboru
-    write4Bytes(bfSize);
-    // Tento údaj je rezervovaný pro pozdější použití
-    uint16_t bfReserved1 = RESERVED_VALUE;
-    // Zápis rezervovaného údaje č. 1
-    write2Bytes(bfReserved1);
-    // I tento údaj je rezervovaný pro pozdější použití
-    uint16_t bfReserved2 = RESERVED_VALUE;
-    // Zápis rezervovaného údaje č. 2
-    write2Bytes(bfReserved2);
-    // Posun struktury BITMAPFILEHEADER od začátku vlastních obrazových dat
-    uint32_t bfOffBits = BITMAPFILEHEADER_SIZE  // Velikost hlavičky
-                       + BITMAPINFOHEADER_SIZE;  // Velikost informační hlavičky
-    // Zápis posunu hlavičky
-    write4Bytes(bfOffBits);
-
-    // BITMAPINFOHEADER - zápis informační hlavičky
-    // Celková velikost datové struktury BITMAPINFOHEADER
-    uint32_t biSize = BITMAPINFOHEADER_SIZE;
-    // Zápis velikosti informační hlavičky
-    write4Bytes(biSize);
-    // Šířka obrazu v pixelech
-    uint32_t biWidth = info.imageWidth;
-    // Zápis šířky obrazu
-    write4Bytes(biWidth);
-    // Výška obrazu v pixelech
-    uint32_t biHeight = info.imageHeight;
-    // Zápis výšky obrazu
-    write4Bytes(biHeight);
-    // Počet bitových rovin pro výstupní zařízení
-    uint16_t biPlanes = BI_PLANES_VALUE;
-    // Zápis bitových rovin
-    write2Bytes(biPlanes);
-    // Celkový počet bitů na pixel
-    uint16_t biBitCount = BIT_COUNT;
-    // Zápis počtu bitů na pixel
-    write2Bytes(biBitCount);
-    // Typ komprimační metody obrazových dat
-    uint32_t biCompression = COMPRESSION_METHOD;
-    // Zápis komprimační metody
-    write4Bytes(biCompression);
-    // Velikost obrazu v bajtech = nula (dopočítá se z předchozích položek)
-    uint32_t biSizeImage = 0x0;
-    // Zápis velikosti obrazu v bajtech
-    write4Bytes(biSizeImage);
-    // Horizontální rozlišení výstupního zařízení v pixelech na metr - neznámé
-    uint32_t biXPelsPerMeter = 0x0;
-    // Zápis horizontálního rozlišení
-    write4Bytes(biXPelsPerMeter);
-    // Vertikální rozlišení výstupního zařízení v pixelech na metr - neznámé
-    uint32_t biYPelsPerMeter = 0x0;
-    // Zápis vertikálního rozlišení
-    write4Bytes(biYPelsPerMeter);
-    // Celkový počet barev, které jsou použité v dané bitmapě - neurčeno
-    uint32_t biClrUsed = 0x0;
-    // Zápis celkového počtu použitých barev
-    write4Bytes(biClrUsed);
-    // Počet barev, které jsou důležité pro vykreslení bitmapy - neurčeno
-    uint32_t biClrImportant = 0x0;
-    // Zápis počtu důležitých barev
-    write4Bytes(biClrImportant);
+int allocBGRData(tGIF2BMPContext *context) {
+    // Obrazová data bez alokovaných pásů (všechny řádky černé)
+    if(initCanvas(&context->bgrCanvas, context->info.imageHeight, context->bmpRowWidth, 0, &context->canvasBudget) != RETURN_SUCCESS) {
+        // Tisk chyby
+        setCanvasError(context, "bgrCanvas malloc failed.");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
 
-    // BITS - zápis barev pixelů
-    // Cyklus procházení řádků obrázku - zdola nahoru
-    for(uint32_t row = info.imageHeight; row > 0; row--) {
-        // Cyklus procházení sloupců jednoho řádku obrázku
-        for(uint32_t col = 0; col < info.imageWidth; col++) {
-            // Zápis jedné barvy do výstupního souboru
+    // Obrazová data byla alokována
+    return RETURN_SUCCESS;
+}
 
-            // Modrá složka
-            fprintf(outputBMPFile, "%c", dataBMP[row-1][col].b);
-            // Zelená složka
-            fprintf(outputBMPFile, "%c", dataBMP[row-1][col].g);
-            // Zelená složka
-            fprintf(outputBMPFile, "%c", dataBMP[row-1][col].r);
-        }
-        // Cyklus doplnění počtu bajtů řádku na násobek 4
-        for(uint8_t plus = 0; plus < addition; plus++) {
-            // Zápis nulového bajtu do souboru
-            fprintf(outputBMPFile, "%c", 0x0);
-        }
+/*
+ * Funkce pro zjištění, zda lze řádky BMP zapisovat průběžně
+ *
+ * Průběžný zápis je možný jen pro soubor s jediným neprokládaným blokem
+ * přes celou logickou obrazovku (podle předběžného průchodu) - řádky se
+ * pak dekódují shora dolů a každý se dekóduje celý najednou. První blok
+ * je vždy neprůhledný.
+ *
+ * Návratová hodnota:
+ *     FLAG_TRUE  - řádky lze zapisovat průběžně
+ *     FLAG_FALSE - zápis až po dekódování celého obrazu
+ */
+uint8_t canStreamRows(tGIF2BMPContext *context) {
+    // Průběžný zápis musí být požadován a výstup nesmí být paletový
+    if(context->options.streaming != FLAG_TRUE || context->options.palettized == FLAG_TRUE) {
+        return FLAG_FALSE;
+    }
+    // Bez předběžného průchodu nelze počet bloků zjistit
+    if(context->scan.frames == NULL || context->scan.count != 1 ||
+       context->info.imageWidth == 0 || context->info.imageHeight == 0) {
+        return FLAG_FALSE;
     }
+    // Jediný neprokládaný blok přes celou logickou obrazovku
+    tGIFFrame *frame = &context->scan.frames[0];
+    if(frame->interlaced == FLAG_TRUE || frame->visible.left != 0 || frame->visible.top != 0 ||
+       frame->visible.right != context->info.imageWidth || frame->visible.bottom != context->info.imageHeight) {
+        return FLAG_FALSE;
+    }
+    return FLAG_TRUE;
 }
 
 /*
- * Funkce pro zpracování dat v image bloku
+ * Funkce pro alokaci obrazových dat převodu
+ *
+ * Dekodér ukládá indexy barev (jeden bajt na pixel, řádky shora dolů),
+ * na barvy BMP se převedou až při zápisu výstupního souboru. Pásy řádků
+ * se alokují až při vykreslení, paměť tak odpovídá řádkům, které bloky
+ * pokrývají. Při průběžném zápisu se ukládají barvy jediného právě
+ * dekódovaného řádku.
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - chyba alokace
  */
-void processImageBlockData() {
-    // Proměnná pro velikost bloku s daty
-    // a její získání
-    uint16_t blockSize = getByte();
-    // Tisk velikosti bloku s daty
-    // fprintf(stderr, "INFO: Block size: %d\n", blockSize);
-
-    // Pokud blok obsahuje nějaká data
-    if(blockSize > 0) {
-        // Naalokuji místo pro data v tomto bloku
-        data = (char*)malloc(blockSize * sizeof(char));
+int allocBMPData(tGIF2BMPContext *context) {
+    // Rozpočet paměti obrazových dat
+    context->canvasBudget.limit = context->options.memoryLimit;
+    // Počet bajtů pro jeden řádek 24bitového BMP
+    context->bmpRowWidth = context->info.imageWidth * ONE_PIXEL_SIZE;
+    // Dorovnání počtu bajtů řádku na násobek 4 bajtů
+    context->bmpRowWidth = (context->bmpRowWidth + ROW_MULT_SIZE - 1) / ROW_MULT_SIZE * ROW_MULT_SIZE;
+
+    // Při průběžném zápisu stačí jediný řádek barev BMP
+    if(canStreamRows(context) == FLAG_TRUE) {
+        context->streaming = FLAG_TRUE;
+        context->dataBMP = (uint8_t*)calloc((size_t)context->bmpRowWidth + 1, 1);
         // Kontrola alokace
-        if(data == NULL) {
+        if(context->dataBMP == NULL) {
             // Tisk chyby
-            fprintf(stderr, "ERROR: data malloc failed.\n");
-            // Konec programu s chybou
-            exit(RETURN_FAILURE);
+            setError(context, "dataBMP malloc failed.");
+            // Ukončení funkce s chybou
+            return RETURN_FAILURE;
         }
-        // Vynulování ukazatelů pro práci s daty bloku
-        dataIndex = 0;
-        actualIndex = 0;
-        nextPixelIndex = 0;
+        noteBufferMemory(context, 0);
+        return RETURN_SUCCESS;
     }
 
-    // Dokud nenarazím na ukončující bajt,
-    // načítám data
-    while(blockSize > 0) {
-        // Do proměnné *data ukládám všechny bajty v aktuálním bloku dat
-        for(uint16_t blockIndex = 0; blockIndex < blockSize; blockIndex++) {
-            // Uložení jednoho bajtu do proměnné *data
-            data[dataIndex] = getByte();
-            // Zvýšení indexu na první volný bajt v proměnné *data
-            dataIndex++;
-        }
+    // Indexy barev všech pixelů logické obrazovky bez alokovaných pásů
+    if(initCanvas(&context->indexCanvas, context->info.imageHeight, context->info.imageWidth, 0, &context->canvasBudget) != RETURN_SUCCESS) {
+        // Tisk chyby
+        setCanvasError(context, "indexCanvas malloc failed.");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
 
-        // Zjisti novou velikost bloku,
-        // popř. načti ukončující bajt bloku
-        blockSize = getByte();
+    // Obrazová data byla alokována
+    return RETURN_SUCCESS;
+}
 
-        // Pokud se nejedná o ukončující bajt bloku
-        if(blockSize != BLOCK_TERMINATOR) {
-            // Tiskni o tom informaci
-            // a vypiš velikost dalšího bloku s daty
-            // fprintf(stderr, "INFO: No terminator, block size: %d\n", blockSize);
-            // Realokuj místo pro data v novém bloku
-            data = (char*)realloc(data, (dataIndex + blockSize));
-            // Kontrola realokace
-            if(data == NULL) {
-                // Tisk chyby
-                fprintf(stderr, "ERROR: data realloc failed.\n");
-                // Konec programu s chybou
-                exit(RETURN_FAILURE);
-            }
-        } else {
-            // Jinak tiskni informaci o konci bloku
-            // fprintf(stderr, "INFO: Image block terminator, data size: %d\n", dataIndex);
-        }
+/*
+ * Funkce pro sestavení tabulky barev palety pro jádra převodu (expand.h)
+ *
+ * context - kontext převodu
+ * table   - tabulka pro PALETTE_MAX_SIZE barev po čtyřech bajtech (B, G, R, X)
+ */
+void makeBGRTable(tGIF2BMPContext *context, uint32_t *table) {
+    // Průchod všemi položkami palety
+    for(uint16_t index = 0; index < PALETTE_MAX_SIZE; index++) {
+        table[index] = makeExpandColor(context->palette[index].b, context->palette[index].g, context->palette[index].r, RESERVED_VALUE);
     }
+}
 
-    // Proměnná pro aktuální index do tabulky barev
-    uint32_t actualColorIndex = 0x0;
-    // Proměnná pro předchozí index do tabulky barev
-    uint32_t previousColorIndex = 0x0;
-    // Hodnota clear code (CC)
-    uint16_t clearCode = pow(2, LZWMininumCodeSize);
-    // Hodnota end of input (EOI)
-    uint16_t endOfInput = (clearCode + 1);
-    // Hodnota pro vyrovnání indexu tabulky nových indexů barev
-    eoiIndex = (endOfInput + 1);
-    // Aktuální hodnota velikosti LZW kódu
-    uint8_t actualLZWCodeSize = (LZWMininumCodeSize + 1);
-    // Aktuální bitová maska pro získání bitu
-    uint16_t actualBitMask = 0x1;
-    // Proměnná pro získání jednoho bitu
-    uint16_t oneBit = 0x0;
-    // Aktuální index do tabulky nových kódů
-    uint32_t actualTableIndex = 0;
-    // Proměnná pro maximální počet barev aktuální velikost LZW kódu
-    uint32_t maximalTableIndex = (pow(2, (actualLZWCodeSize - 1)) - 1);
-    // Tabulka pro nové indexy tabulky indexů barev (258 - ...)
-    tTable colorTable;
-    // Ukazatel pro položku aktuálního načteného indexu ze vstupního souboru
-    tItem *actual = NULL;
-    // Ukazatel pro položku předchozího načteného indexu ze vstupního souboru
-    tItem *previous = NULL;
-    // Příznak prvního bajtu po clear kódu
-    uint8_t isFirst = YES;
+/*
+ * Funkce pro převod indexů barev na barvy BMP
+ *
+ * Volá se, pokud barvy bloku nelze přidat do palety (více než 256 barev
+ * všech bloků dohromady) - převod pak pokračuje s barvami a výstup bude
+ * 24bitový. Indexy se převádí po pásech a každý převedený pás se hned
+ * uvolní. Nealokované pásy indexů se převedou, jen pokud jejich výplň
+ * není černá.
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - chyba alokace
+ */
+int expandIndexData(tGIF2BMPContext *context) {
+    // Tabulka barev palety pro jádra převodu
+    uint32_t table[PALETTE_MAX_SIZE];
 
-    // Inicializace tabulky pro nové indexy barev
-    initTable(&colorTable);
-    // Nastavím ukazatel právě zpracovávaného bajtu na první bajt dat
-    actualIndex = 0;
+    // Alokace barev výsledného obrázku
+    if(allocBGRData(context) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
 
-    // Dokud nejsem na konci bloku dat,
-    // zpracovávám další index do tabulky barev
-    do {
-        // Uložení aktuálního indexu barvy jako předchozího
-        previousColorIndex = actualColorIndex;
-        // Nastavení aktuálního indexu barvy na 0
-        actualColorIndex = 0x0;
-
-        // Cyklus pro získání jedné nové hodnoty indexu do tabulky barev
-        for(uint8_t bitIndex = 0; bitIndex < actualLZWCodeSize; bitIndex++) {
-            // Pokud je aktuálně získávaný bit 1
-            if((data[actualIndex] & actualBitMask) > 0) {
-                // Nastavím nový bit na 1
-                oneBit = 0x1;
-            } else {
-                // Jinak nastavím nový bit na 0
-                oneBit = 0x0;
+    // Pokud již byla určena paleta, převedou se indexy na barvy
+    if(context->paletteSize > 0) {
+        // Výplň nealokovaných pásů indexů
+        tRGB *fill = &context->palette[context->indexCanvas.fill];
+        // Sestavení tabulky barev
+        makeBGRTable(context, table);
+        // Převod všech pásů logické obrazovky
+        for(uint32_t band = 0; band < context->indexCanvas.bandCount && context->error == RETURN_SUCCESS; band++) {
+            // Nealokovaný pás s černou výplní odpovídá nealokovaným barvám
+            if(context->indexCanvas.bands[band] == NULL && fill->r == 0 && fill->g == 0 && fill->b == 0) {
+                continue;
             }
-
-            // Posun bitu v bitové masce pro další bit o 1 pozici vlevo
-            actualBitMask = actualBitMask << 1;
-            // Posun nového bitu o i pozic vlevo
-            oneBit = oneBit << bitIndex;
-
-            // Přidání nově získaného bitu do výsledného indexu přichozí barvy
-            actualColorIndex = actualColorIndex | oneBit;
-
-            // Pokud jsem na konci zpracovávaného bajtu
-            if(actualBitMask == 0x100) {
-                // Nastavení masky na první bit (LSB)
-                actualBitMask = 0x1;
-                // Posun na další bajt načtených dat vstupního souboru
-                actualIndex++;
+            // Převod všech řádků pásu
+            for(uint32_t row = band * context->indexCanvas.bandRows, end = row + getCanvasBandRows(&context->indexCanvas, band); row < end; row++) {
+                // Řádek indexů (nealokovaný pás se vyplní) a řádek barev
+                uint8_t *indexes = touchCanvasRow(context, &context->indexCanvas, row);
+                uint8_t *target = getBMPPixel(context, row, 0);
+                if(indexes == NULL || target == NULL) {
+                    break;
+                }
+                context->expandKernels.expandBGR(target, indexes, context->info.imageWidth, table);
             }
+            // Převedený pás indexů již není potřeba
+            freeCanvasBand(&context->indexCanvas, band);
         }
+    }
 
-        // Pokud je aktuální získaný index EOI
-        if(actualColorIndex == endOfInput) {
-            // Konec cyklu zpracovávání vstupu
-            break;
-        }
-
-        // Posun na další položku v tabulce nových indexů barev
-        actualTableIndex++;
+    // Indexy barev již nejsou potřeba
+    freeCanvas(&context->indexCanvas);
 
-        // Pokud je aktuální získaný index clear kódem
-        if(actualColorIndex == clearCode) {
-            // Resetování aktuální hodnoty LZW kódu
-            actualLZWCodeSize = (LZWMininumCodeSize + 1);
-            // Resetování maximální velikosti tabulky pro aktuální LZW kód
-            maximalTableIndex = (pow(2, LZWMininumCodeSize) - 1);
-            // Resetování indexu do tabulky nových indexů
-            actualTableIndex = 0;
-            // Uvolnění místa po předchozí tabulce indexů
-            freeTable(&colorTable);
-            // Reinicializace tabulky nových indexů barev
-            initTable(&colorTable);
-            // Nastavení příznaku nového bloku po clear kódu
-            isFirst = YES;
-            // Pokračuje se dalším krokem cyklu
-            continue;
-        } else if(actualTableIndex == maximalTableIndex) {
-            // Pokud bylo dosaženo maximálního indexu pro aktuální LZW
+    // Obrazová data byla převedena
+    return context->error;
+}
 
-            // Zvýšení velikosti LZW kódu pokud to ještě lze (<12)
-            if(actualLZWCodeSize < 12) {
-                // Inkrementace velikosti LZW
-                actualLZWCodeSize++;
+/*
+ * Funkce pro obarvení nevykreslených pixelů řádku bloku černě
+ *
+ * Pixely mimo logickou obrazovku se přeskočí, nealokovaný řádek barev
+ * je černý celý.
+ *
+ * row - řádek logické obrazovky
+ * col - první nevykreslený sloupec bloku
+ */
+void blackenBlockRow(tGIF2BMPContext *context, uint32_t row, uint32_t col) {
+    // Řádek barev (jen alokovaný)
+    uint8_t *rowData = NULL;
+
+    // Řádek nebo sloupec mimo logickou obrazovku
+    if(row >= context->info.imageHeight || col >= context->actualVisibleWidth) {
+        return;
+    }
+    rowData = peekCanvasRow(&context->bgrCanvas, context->info.imageHeight - 1 - row);
+    if(rowData != NULL) {
+        memset(rowData + (size_t)(context->actualLeft + col) * ONE_PIXEL_SIZE, 0, (size_t)(context->actualVisibleWidth - col) * ONE_PIXEL_SIZE);
+    }
+}
+
+/*
+ * Funkce pro dokončení prvního bloku palety bez černé barvy
+ *
+ * Pokud první blok nevykreslil celou logickou obrazovku (např. zkrácená
+ * data), indexy se převedou na barvy a nevykreslené pixely bloku se
+ * obarví černě. Řádky nevykreslených pixelů určuje mapa řádků bloku.
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - chyba alokace
+ */
+int finishBlackMissingPalette(tGIF2BMPContext *context) {
+    // Počet vykreslených pixelů bloku
+    uint32_t paintedCount = context->nextPixelIndex;
+
+    // Černá barva již není potřeba řešit
+    context->paletteBlackMissing = FLAG_FALSE;
+    // Pokud byla vykreslena celá logická obrazovka, paleta zůstává
+    if(context->canvasCovered == FLAG_TRUE) {
+        return RETURN_SUCCESS;
+    }
+
+    // Převod indexů na barvy
+    if(expandIndexData(context) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+
+    // Blok bez pixelů nic nevykreslil
+    if(context->actualWidth == 0) {
+        return RETURN_SUCCESS;
+    }
+    // Průchod nevykreslenými řádky bloku v pořadí dekódování
+    for(uint32_t rowNumber = paintedCount / context->actualWidth, col = paintedCount % context->actualWidth;
+        rowNumber < context->actualHeight; rowNumber++, col = 0) {
+        // Nevykreslené pixely řádku jsou černé
+        blackenBlockRow(context, context->actualTop + context->rowMap[rowNumber], col);
+    }
+
+    // Pixely byly obarveny
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro převod indexů mimo tabulku barev bloku na černou barvu palety
+ *
+ * Stejně jako u výstupu 24 bitů na pixel jsou takové pixely černé.
+ */
+void remapOutsideBlockTable(tGIF2BMPContext *context) {
+    for(uint16_t index = context->actualColorTableSize; index < PALETTE_MAX_SIZE; index++) {
+        context->paletteRemap[index] = context->paletteBlackIndex;
+    }
+}
+
+/*
+ * Funkce pro přidání tabulky barev bloku do palety
+ *
+ * Každá barva tabulky bloku se vyhledá v paletě, chybějící barvy se
+ * přidají na její konec. Výsledkem je převodní tabulka indexů bloku
+ * na indexy palety.
+ *
+ * Návratová hodnota:
+ *         0 - tabulka byla přidána
+ *        -1 - paleta by měla více než 256 barev
+ */
+int mergeBlockPalette(tGIF2BMPContext *context) {
+    // Černá barva nevykreslených pixelů mimo tabulku se stane položkou palety
+    if(context->paletteBlackIndex >= context->paletteSize) {
+        context->paletteSize = context->paletteBlackIndex + 1;
+    }
+
+    // Průchod barvami tabulky bloku
+    for(uint16_t index = 0; index < context->actualColorTableSize; index++) {
+        // Barva bloku
+        tRGB color = context->actualColorTable[index];
+        // Hledání barvy v paletě
+        uint16_t paletteIndex = 0;
+        while(paletteIndex < context->paletteSize &&
+              (context->palette[paletteIndex].r != color.r || context->palette[paletteIndex].g != color.g || context->palette[paletteIndex].b != color.b)) {
+            paletteIndex++;
+        }
+        // Barva v paletě chybí, přidá se na konec
+        if(paletteIndex == context->paletteSize) {
+            // Paleta je plná
+            if(context->paletteSize >= PALETTE_MAX_SIZE) {
+                return RETURN_FAILURE;
             }
-            // Zvýšení maximálního indexu pro nový LZW kód
-            maximalTableIndex = pow(2, (actualLZWCodeSize-1));
-            // Reset indexu pro aktuální LZW
-            actualTableIndex = 0;
+            context->palette[context->paletteSize++] = color;
         }
+        // Uložení převodu indexu
+        context->paletteRemap[index] = (uint8_t)paletteIndex;
+    }
 
-        // Pokud se jedná o nový blok po clear kódu
-        if(isFirst == YES) {
-            // Nastavení příznaku na zpracovaný první index nového bloku
-            isFirst = NO;
+    // Indexy mimo tabulku bloku jsou černé
+    remapOutsideBlockTable(context);
+
+    // Tabulka byla přidána
+    return RETURN_SUCCESS;
+}
 
-            // Pokud aktuálně zpracovávaný pixel má být neprůhledný
-            if(imageBlockNumber == 1 || blockTrasparentColorFlag != FLAG_TRUE || actualColorIndex != transparentColorIndex) {
-                // Získání čísla řádku
-                uint32_t rowIndex = getRowIndex();
-                // Získání čísla sloupce
-                uint32_t colIndex = getColIndex();
-                // Uložení barvy aktuálního pixelu
-                dataBMP[rowIndex][colIndex].r = actualColorTable[actualColorIndex].r;
-                dataBMP[rowIndex][colIndex].g = actualColorTable[actualColorIndex].g;
-                dataBMP[rowIndex][colIndex].b = actualColorTable[actualColorIndex].b;
+/*
+ * Funkce pro kontrolu tabulky barev bloku
+ *
+ * Tabulka prvního bloku se stane paletou obrazu. Pixely, které žádný blok
+ * nevykreslí, mají černou barvu, proto se pro ně vybere černá barva palety
+ * (příp. první nevyužitá položka palety). Tabulky dalších bloků se do palety
+ * přidají; pokud by měla více než 256 barev, indexy se převedou na barvy.
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - chyba alokace
+ */
+int checkBlockPalette(tGIF2BMPContext *context) {
+    // Pokud se již neukládají indexy barev, není co kontrolovat
+    if(context->indexCanvas.bands == NULL) {
+        return RETURN_SUCCESS;
+    }
+
+    // Blok bez tabulky barev - převod na barvy
+    if(context->actualColorTable == NULL || context->actualColorTableSize == 0) {
+        return expandIndexData(context);
+    }
+
+    // Pokud je paleta již určena, tabulka bloku se do ní přidá
+    if(context->paletteSize > 0) {
+        // Shodná tabulka - indexy zůstávají platné
+        if(context->paletteSize == context->actualColorTableSize &&
+           memcmp(context->palette, context->actualColorTable, sizeof(tRGB) * context->paletteSize) == 0) {
+            // Indexy bloku odpovídají indexům palety, indexy mimo tabulku
+            // jsou černé
+            for(uint16_t index = 0; index < context->actualColorTableSize; index++) {
+                context->paletteRemap[index] = (uint8_t)index;
             }
-            // Posun na další index výstupní tabulky
-            nextPixelIndex++;
-        } else {
-            // Pokud již byl zpracován první index nového bloku
-
-            // Nová položka do tabulky indexů
-            tItem newTableItem = {0, 0, NULL};
-            // Inicializace nové položky
-            initTableItem(&newTableItem);
-
-            // Pokud je aktuální index barvy v rozsahu již existujících indexů
-            if(actualColorIndex < (colorTable.used + eoiIndex)) {
-                // Data z aktuálního indexu jdou na výstup
-
-                // Pokud je index v rozsahu aktuální tabulky barev
-                if(actualColorIndex < actualColorTableSize) {
-                    // Pokud aktuálně zpracovávaný pixel má být neprůhledný
-                    if(imageBlockNumber == 1 || blockTrasparentColorFlag != FLAG_TRUE || actualColorIndex != transparentColorIndex) {
-                        // Získání čísla řádku
-                        uint32_t rowIndex = getRowIndex();
-                        // Získání čísla sloupce
-                        uint32_t colIndex = getColIndex();
-                        // Na výstupu bude aktuální index barvy
-                        dataBMP[rowIndex][colIndex].r = actualColorTable[actualColorIndex].r;
-                        dataBMP[rowIndex][colIndex].g = actualColorTable[actualColorIndex].g;
-                        dataBMP[rowIndex][colIndex].b = actualColorTable[actualColorIndex].b;
-                    }
-                    // Posun na další index výstupní tabulky
-                    nextPixelIndex++;
+            remapOutsideBlockTable(context);
+            return RETURN_SUCCESS;
+        }
+        // Přidání tabulky do palety, při přeplnění převod na barvy
+        if(mergeBlockPalette(context) != RETURN_SUCCESS) {
+            return expandIndexData(context);
+        }
+        return RETURN_SUCCESS;
+    }
+
+    // Uložení palety (nevyužité položky zůstávají černé)
+    memset(context->palette, 0, sizeof(context->palette));
+    memcpy(context->palette, context->actualColorTable, sizeof(tRGB) * context->actualColorTableSize);
+    context->paletteSize = context->actualColorTableSize;
+
+    // Hledání černé barvy v paletě
+    uint16_t blackIndex = 0;
+    while(blackIndex < context->paletteSize &&
+          (context->palette[blackIndex].r != 0 || context->palette[blackIndex].g != 0 || context->palette[blackIndex].b != 0)) {
+        blackIndex++;
+    }
+    // Plná paleta bez černé barvy - nevykreslené pixely nelze vyjádřit indexem
+    if(blackIndex >= PALETTE_MAX_SIZE) {
+        // Blok přes celou logickou obrazovku ji pravděpodobně celou vykreslí,
+        // pixely se zatím vyplní indexem 0 a po bloku se pokrytí zkontroluje
+        if(context->actualLeft != 0 || context->actualTop != 0 ||
+           context->actualWidth < context->info.imageWidth || context->actualHeight < context->info.imageHeight) {
+            // Zatím nebyl vykreslen žádný pixel, barvy zůstanou černé
+            context->paletteSize = 0;
+            return expandIndexData(context);
+        }
+        blackIndex = 0;
+        context->paletteBlackMissing = FLAG_TRUE;
+    }
+    // Uložení indexu černé barvy
+    context->paletteBlackIndex = (uint8_t)blackIndex;
+
+    // Všechny pixely jsou zatím nevykreslené (černé)
+    fillCanvas(&context->indexCanvas, context->paletteBlackIndex);
+    // Indexy bloku odpovídají indexům palety, indexy mimo tabulku jsou černé
+    for(uint16_t index = 0; index < context->actualColorTableSize; index++) {
+        context->paletteRemap[index] = (uint8_t)index;
+    }
+    remapOutsideBlockTable(context);
+
+    // Paleta byla určena
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro výpis výsledných barev na standardní výstup (informační)
+ */
+void printPixels(tGIF2BMPContext *context) {
+    // Cyklus procházení řádků tabulky
+    for(uint32_t row = 0; row < context->info.imageHeight; row++) {
+        // Cyklus procházení sloupců v řádku tabulky
+        for(uint32_t col = 0; col < context->info.imageWidth; col++) {
+            // Výpis hodnot barev na pozici řádek:sloupec (nealokovaný
+            // řádek je černý)
+            static const uint8_t black[ONE_PIXEL_SIZE] = {0, 0, 0};
+            const uint8_t *rowData = peekCanvasRow(&context->bgrCanvas, context->info.imageHeight - 1 - row);
+            const uint8_t *pixel = (rowData == NULL) ? black : rowData + (size_t)col * ONE_PIXEL_SIZE;
+
+            // Červená složka
+            printf("%02x", pixel[2]);
+            // Zelená složka
+            printf("%02x", pixel[1]);
+            // Modrá složka
+            printf("%02x ", pixel[0]);
+        }
+        // Odřádkování každého řádku tabulky
+        printf("\n");
+    }
+
+    // Výpis celkového počtu indexů v tabulce
+    printf("\n%d\n", context->nextPixelIndex);
+}
+
+/*
+ * Funkce pro uvolnění paměti po tabulce výsledných barev
+ */
+void freeBMPData(tGIF2BMPContext *context) {
+    // Uvolnění řádku průběžného zápisu
+    free(context->dataBMP);
+    // Ukazatel již neodkazuje na platná data
+    context->dataBMP = NULL;
+    // Uvolnění všech pásů barev a indexů barev
+    freeCanvas(&context->bgrCanvas);
+    freeCanvas(&context->indexCanvas);
+}
+
+/*
+ * Funkce pro zabalení jednoho řádku indexů barev do řádku BMP
+ *
+ * Při 1 a 4 bitech na pixel je první pixel v nejvyšších bitech bajtu.
+ *
+ * target   - řádek BMP (vynulovaný)
+ * indexes  - indexy barev řádku
+ * width    - počet pixelů řádku
+ * bitCount - počet bitů na pixel (1, 4 nebo 8)
+ */
+void packIndexRow(uint8_t *target, const uint8_t *indexes, uint32_t width, uint16_t bitCount) {
+    // Rozvětvení podle počtu bitů na pixel
+    switch(bitCount) {
+        // Jeden bajt na pixel - přímá kopie
+        case PALETTE_BIT_COUNT_8: {
+            memcpy(target, indexes, width);
+            break;
+        }
+        // Dva pixely na bajt
+        case PALETTE_BIT_COUNT_4: {
+            for(uint32_t col = 0; col < width; col++) {
+                target[col >> 1] |= (uint8_t)((indexes[col] & 0x0f) << ((col & 1) ? 0 : 4));
+            }
+            break;
+        }
+        // Osm pixelů na bajt
+        default: {
+            for(uint32_t col = 0; col < width; col++) {
+                target[col >> 3] |= (uint8_t)((indexes[col] & 0x01) << (7 - (col & 7)));
+            }
+            break;
+        }
+    }
+}
+
+/*
+ * Funkce pro přípravu výstupního bufferu v paměti
+ *
+ * Bez bufferu volajícího se alokuje buffer přesně pro celý BMP soubor,
+ * buffer volajícího musí mít alespoň tuto velikost.
+ *
+ * context - kontext převodu
+ * size    - velikost celého BMP souboru
+ *
+ * Návratová hodnota:
+ *      0 - buffer je připraven
+ *     -1 - chyba alokace nebo malý buffer volajícího
+ */
+int prepareOutputBuffer(tGIF2BMPContext *context, size_t size) {
+    // Požadovaná velikost pro případné opakování s větším bufferem
+    context->outputRequired = size;
+    // Buffer volajícího
+    if(context->outputBuffer != NULL) {
+        if(context->outputCapacity < size) {
+            setError(context, "BMP output buffer too small.");
+            return RETURN_FAILURE;
+        }
+        return RETURN_SUCCESS;
+    }
+    // Alokace bufferu knihovnou (+1 pro prázdný obraz)
+    context->outputBuffer = (uint8_t*)malloc(size + 1);
+    if(context->outputBuffer == NULL) {
+        setError(context, "outputBuffer malloc failed.");
+        return RETURN_FAILURE;
+    }
+    context->outputCapacity = size;
+    context->outputAllocated = FLAG_TRUE;
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro zápis bajtů na výstup (soubor nebo buffer v paměti)
+ *
+ * context - kontext převodu
+ * bytes   - zapisované bajty
+ * count   - počet bajtů
+ *
+ * Návratová hodnota:
+ *      0 - bajty byly zapsány
+ *     -1 - chyba zápisu nebo plný buffer
+ */
+int writeOutput(tGIF2BMPContext *context, const void *bytes, size_t count) {
+    // Výstup do souboru
+    if(context->outputBMPFile != NULL) {
+        return (fwrite(bytes, 1, count, context->outputBMPFile) == count) ? RETURN_SUCCESS : RETURN_FAILURE;
+    }
+    // Výstup do bufferu v paměti
+    if(count > context->outputCapacity - context->outputLength) {
+        return RETURN_FAILURE;
+    }
+    memcpy(context->outputBuffer + context->outputLength, bytes, count);
+    context->outputLength += count;
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro výpočet velikosti BMP souboru
+ *
+ * Velikost se počítá v 64 bitech, takže může přesáhnout největší
+ * velikost BMP souboru (BMP_MAX_FILE_SIZE).
+ *
+ * context        - kontext převodu
+ * paletteEntries - počet položek palety
+ * rowWidth       - délka řádku včetně zarovnání
+ *
+ * Návratová hodnota:
+ *     velikost celého BMP souboru v bajtech
+ */
+uint64_t getBMPFileSize(tGIF2BMPContext *context, uint32_t paletteEntries, uint64_t rowWidth) {
+    return (uint64_t)BMP_HEADER_SIZE + (uint64_t)paletteEntries * BMP_COLOR_SIZE + rowWidth * context->info.imageHeight;
+}
+
+/*
+ * Funkce pro kontrolu velikosti výstupního BMP souboru před dekódováním
+ *
+ * Kontroluje se nejmenší možný výstup - 24 bitů na pixel, při paletovém
+ * výstupu 1 bit na pixel (paletový výstup s více barvami se kontroluje
+ * až při zápisu hlavičky). U 24bitového výstupu do bufferu volajícího
+ * se zároveň kontroluje velikost bufferu.
+ *
+ * Návratová hodnota:
+ *      0 - BMP soubor nepřekročí největší velikost
+ *     -1 - obrázek nelze uložit do BMP souboru, příp. malý buffer volajícího
+ */
+int checkBMPFileSize(tGIF2BMPContext *context) {
+    // Počet bitů na pixel nejmenšího možného výstupu
+    uint64_t bitCount = (context->options.palettized == FLAG_TRUE) ? PALETTE_BIT_COUNT_1 : BIT_COUNT;
+    // Délka řádku zarovnaná na násobek 4 bajtů
+    uint64_t rowWidth = ((uint64_t)context->info.imageWidth * bitCount + BYTE_BITS * ROW_MULT_SIZE - 1) / (BYTE_BITS * ROW_MULT_SIZE) * ROW_MULT_SIZE;
+    // Počet položek palety nejmenšího možného výstupu
+    uint32_t paletteEntries = (context->options.palettized == FLAG_TRUE) ? (1u << PALETTE_BIT_COUNT_1) : 0;
+
+    // Kontrola největší velikosti BMP souboru
+    if(getBMPFileSize(context, paletteEntries, rowWidth) > BMP_MAX_FILE_SIZE) {
+        // Tisk chyby
+        setError(context, "BMP file would exceed the 4 GB format limit.");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
+    // 24bitový výstup má velikost známou již nyní, malý buffer volajícího
+    // se odmítne před dekódováním (s potřebnou velikostí)
+    if(context->options.palettized != FLAG_TRUE && context->outputBMPFile == NULL && context->outputBuffer != NULL &&
+       prepareOutputBuffer(context, (size_t)getBMPFileSize(context, 0, rowWidth)) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro sestavení a zápis hlavičky BMP souboru
+ *
+ * Hlavička se sestaví v paměti a zapíše jedním voláním. Výstup do bufferu
+ * v paměti se před zápisem připraví podle velikosti BMP souboru. Soubor
+ * větší než BMP_MAX_FILE_SIZE se nezapíše.
+ *
+ * context        - kontext převodu
+ * logInfo        - záznam o převodu pro velikost BMP souboru (může být NULL)
+ * bitCount       - počet bitů na pixel
+ * paletteEntries - počet položek palety
+ * rowWidth       - délka řádku včetně zarovnání
+ * topDown        - příznak řádků shora dolů (záporná výška)
+ *
+ * Návratová hodnota:
+ *      0 - hlavička byla zapsána
+ *     -1 - chyba alokace, zápisu nebo příliš velký soubor
+ */
+int writeBMPHeader(tGIF2BMPContext *context, tGIF2BMP *logInfo, uint16_t bitCount, uint32_t paletteEntries, uint32_t rowWidth, uint8_t topDown) {
+    // Velikost palety v bajtech
+    uint32_t paletteBytes = paletteEntries * BMP_COLOR_SIZE;
+    // Velikost celého souboru v 64 bitech
+    uint64_t fileSize = getBMPFileSize(context, paletteEntries, rowWidth);
+
+    // Sestavovaná hlavička BMP souboru
+    tBMPHeader header;
+    // Hlavička je zatím prázdná
+    header.used = 0;
+
+    // BITMAPFILEHEADER - sestavení hlavičky
+    // Identifikátor formátu BMP
+    char bfType[] = BMP_IDENTIFICATOR;
+    // Uložení identifikátoru BMP souboru
+    header.bytes[header.used++] = bfType[0];
+    header.bytes[header.used++] = bfType[1];
+    // Uložení velikosti BMP souboru pro log
+    if(logInfo != NULL) logInfo->bmpSize = (int64_t)fileSize;
+    // Velikost souboru musí být vyjádřitelná v hlavičce
+    if(fileSize > BMP_MAX_FILE_SIZE) {
+        // Tisk chyby
+        setError(context, "BMP file would exceed the 4 GB format limit.");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
+    // Celková velikost souboru s obrazovými údaji (hlavička, informační
+    // hlavička, paleta a plocha obrázku včetně doplnění řádků na násobek 4)
+    uint32_t bfSize = (uint32_t)fileSize;
+    // Příprava výstupního bufferu v paměti přesně pro celý soubor
+    if(context->outputBMPFile == NULL && prepareOutputBuffer(context, bfSize) != RETURN_SUCCESS) {
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
+    // Zápis celkové velikosti souboru
+    put4Bytes(&header, bfSize);
+    // Tento údaj je rezervovaný pro pozdější použití
+    uint16_t bfReserved1 = RESERVED_VALUE;
+    // Zápis rezervovaného údaje č. 1
+    put2Bytes(&header, bfReserved1);
+    // I tento údaj je rezervovaný pro pozdější použití
+    uint16_t bfReserved2 = RESERVED_VALUE;
+    // Zápis rezervovaného údaje č. 2
+    put2Bytes(&header, bfReserved2);
+    // Posun struktury BITMAPFILEHEADER od začátku vlastních obrazových dat
+    uint32_t bfOffBits = BITMAPFILEHEADER_SIZE  // Velikost hlavičky
+                       + BITMAPINFOHEADER_SIZE  // Velikost informační hlavičky
+                       + paletteBytes;  // Velikost palety
+    // Zápis posunu hlavičky
+    put4Bytes(&header, bfOffBits);
+
+    // BITMAPINFOHEADER - zápis informační hlavičky
+    // Celková velikost datové struktury BITMAPINFOHEADER
+    uint32_t biSize = BITMAPINFOHEADER_SIZE;
+    // Zápis velikosti informační hlavičky
+    put4Bytes(&header, biSize);
+    // Šířka obrazu v pixelech
+    uint32_t biWidth = context->info.imageWidth;
+    // Zápis šířky obrazu
+    put4Bytes(&header, biWidth);
+    // Výška obrazu v pixelech (záporná pro řádky shora dolů)
+    uint32_t biHeight = context->info.imageHeight;
+    if(topDown == FLAG_TRUE) {
+        biHeight = (uint32_t)(-(int32_t)context->info.imageHeight);
+    }
+    // Zápis výšky obrazu
+    put4Bytes(&header, biHeight);
+    // Počet bitových rovin pro výstupní zařízení
+    uint16_t biPlanes = BI_PLANES_VALUE;
+    // Zápis bitových rovin
+    put2Bytes(&header, biPlanes);
+    // Celkový počet bitů na pixel
+    uint16_t biBitCount = bitCount;
+    // Zápis počtu bitů na pixel
+    put2Bytes(&header, biBitCount);
+    // Typ komprimační metody obrazových dat
+    uint32_t biCompression = COMPRESSION_METHOD;
+    // Zápis komprimační metody
+    put4Bytes(&header, biCompression);
+    // Velikost obrazu v bajtech = nula (dopočítá se z předchozích položek)
+    uint32_t biSizeImage = 0x0;
+    // Zápis velikosti obrazu v bajtech
+    put4Bytes(&header, biSizeImage);
+    // Horizontální rozlišení výstupního zařízení v pixelech na metr - neznámé
+    uint32_t biXPelsPerMeter = 0x0;
+    // Zápis horizontálního rozlišení
+    put4Bytes(&header, biXPelsPerMeter);
+    // Vertikální rozlišení výstupního zařízení v pixelech na metr - neznámé
+    uint32_t biYPelsPerMeter = 0x0;
+    // Zápis vertikálního rozlišení
+    put4Bytes(&header, biYPelsPerMeter);
+    // Celkový počet barev, které jsou použité v dané bitmapě (velikost palety)
+    uint32_t biClrUsed = paletteEntries;
+    // Zápis celkového počtu použitých barev
+    put4Bytes(&header, biClrUsed);
+    // Počet barev, které jsou důležité pro vykreslení bitmapy - neurčeno
+    uint32_t biClrImportant = 0x0;
+    // Zápis počtu důležitých barev
+    put4Bytes(&header, biClrImportant);
+
+    // Zápis celé hlavičky do výstupního souboru
+    if(writeOutput(context, header.bytes, header.used) != RETURN_SUCCESS) {
+        // Nastavení chyby
+        setError(context, "BMP header write failed.");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
+
+    // Hlavička byla zapsána
+    return RETURN_SUCCESS;
+}
+
+
+/*
+ * Funkce pro zahájení průběžného zápisu (zápis hlavičky s řádky shora dolů)
+ *
+ * Návratová hodnota:
+ *      0 - bez průběžného zápisu nebo hlavička byla zapsána
+ *     -1 - chyba zápisu
+ */
+int startStreamRows(tGIF2BMPContext *context) {
+    // Bez průběžného zápisu se hlavička zapíše až po dekódování
+    if(context->streaming != FLAG_TRUE) {
+        return RETURN_SUCCESS;
+    }
+    return writeBMPHeader(context, &context->stats, BIT_COUNT, 0, context->bmpRowWidth, FLAG_TRUE);
+}
+
+/*
+ * Funkce pro zápis právě dokončeného řádku při průběžném zápisu
+ *
+ * Řádek pod logickou obrazovkou se nezapisuje. Buffer řádku se po zápisu
+ * vynuluje (nevykreslené pixely dalšího řádku jsou černé). Po první chybě
+ * zápisu se již nic nezapisuje a další sub-bloky bloku se nečtou, takže
+ * dekódování skončí.
+ *
+ * Návratová hodnota:
+ *      0 - řádek byl zapsán nebo se nezapisuje
+ *     -1 - chyba zápisu (i dřívější)
+ */
+int flushStreamRow(tGIF2BMPContext *context) {
+    // Po chybě zápisu se již nezapisuje
+    if(context->error != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+    // Řádek mimo logickou obrazovku
+    if(context->actualRowData == NULL) {
+        return RETURN_SUCCESS;
+    }
+    // Zápis celého řádku včetně zarovnání
+    if(writeOutput(context, context->dataBMP, context->bmpRowWidth) != RETURN_SUCCESS) {
+        setError(context, "BMP data write failed.");
+        // Další sub-bloky se již nečtou
+        context->subBlocksTerminated = FLAG_TRUE;
+        return RETURN_FAILURE;
+    }
+    // Vynulování řádku pro další řádek
+    memset(context->dataBMP, 0, context->bmpRowWidth);
+    context->streamedRows++;
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro dokončení průběžného zápisu
+ *
+ * Řádky, které blok nevykreslil (předčasný konec dat), jsou černé. Zapsané
+ * řádky se nakonec předají souboru, aby se projevila i chyba jejich zápisu.
+ *
+ * Návratová hodnota:
+ *      0 - všechny řádky byly zapsány
+ *     -1 - chyba zápisu
+ */
+int finishStreamRows(tGIF2BMPContext *context) {
+    // Rozpracovaný řádek se zapíše včetně dosud vykreslených pixelů
+    if(context->streamedRows < context->info.imageHeight && context->actualColumn > 0 &&
+       flushStreamRow(context) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+    // Po chybě zápisu během dekódování se zbývající řádky nezapisují
+    if(context->error != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+    // Zbývající řádky jsou černé
+    memset(context->dataBMP, 0, context->bmpRowWidth);
+    while(context->streamedRows < context->info.imageHeight) {
+        if(writeOutput(context, context->dataBMP, context->bmpRowWidth) != RETURN_SUCCESS) {
+            setError(context, "BMP data write failed.");
+            return RETURN_FAILURE;
+        }
+        context->streamedRows++;
+    }
+    // Předání bufferovaných řádků souboru (i chyba zápisu posledních řádků)
+    if(context->outputBMPFile != NULL && fflush(context->outputBMPFile) != 0) {
+        setError(context, "BMP data write failed.");
+        return RETURN_FAILURE;
+    }
+    return context->error;
+}
+
+/*
+ * Funkce pro zápis výsledných dat do BMP výstupního souboru
+ *
+ * Hlavička se zapíše funkcí writeBMPHeader. Uložené indexy
+ * barev se převádí po blocích řádků (na barvy BGR, při paletovém výstupu
+ * na indexy zabalené na 1, 4 nebo 8 bitů podle počtu použitých barev)
+ * a každý blok se zapíše jedním voláním. Obrazová data převedená na barvy
+ * již během dekódování jsou ve tvaru BMP a každý pás řádků se zapíše
+ * jedním voláním. Nealokované řádky mají výplňovou hodnotu (černá barva).
+ * Bez výstupního souboru se data zapisují do bufferu v paměti, který se
+ * před zápisem připraví podle velikosti BMP souboru. Při průběžném zápisu
+ * se zapíší jen zbývající (nevykreslené) řádky.
+ *
+ * Návratová hodnota:
+ *      0 - zápis proběhl v pořádku
+ *     -1 - chyba alokace nebo zápisu
+ */
+int writeBMPData(tGIF2BMPContext *context, tGIF2BMP *logInfo) {
+    // Počet bitů na pixel výstupního souboru
+    uint16_t bitCount = BIT_COUNT;
+    // Počet položek palety výstupního souboru
+    uint32_t paletteEntries = 0;
+    // Délka řádku výstupního souboru
+    uint32_t rowWidth = context->bmpRowWidth;
+    // Blok převedených řádků výstupního souboru
+    uint8_t *blockData = NULL;
+    // Řádek výplně (indexy, příp. barvy nealokovaných pásů)
+    uint8_t *fillData = NULL;
+    // Počet řádků v jednom bloku
+    uint32_t blockRows = 1;
+    // Tabulka barev palety pro jádra převodu
+    uint32_t table[PALETTE_MAX_SIZE];
+
+    // Hlavička a dekódované řádky průběžného zápisu jsou již zapsány
+    if(context->streaming == FLAG_TRUE) {
+        return finishStreamRows(context);
+    }
+
+    // Pokud jsou uloženy indexy barev a je požadován paletový výstup
+    if(context->indexCanvas.bands != NULL && context->options.palettized == FLAG_TRUE) {
+        // Počet potřebných barev - velikost tabulky, největší použitý index
+        // a černá barva nevykreslených pixelů
+        uint32_t colorCount = (context->paletteSize > 0) ? context->paletteSize : 1;
+        if((uint32_t)context->paletteMaxIndex + 1 > colorCount) {
+            colorCount = (uint32_t)context->paletteMaxIndex + 1;
+        }
+        if(context->canvasCovered != FLAG_TRUE && (uint32_t)context->paletteBlackIndex + 1 > colorCount) {
+            colorCount = (uint32_t)context->paletteBlackIndex + 1;
+        }
+        // Nejmenší počet bitů na pixel pro potřebný počet barev
+        bitCount = (colorCount <= (1u << PALETTE_BIT_COUNT_1)) ? PALETTE_BIT_COUNT_1 :
+                   (colorCount <= (1u << PALETTE_BIT_COUNT_4)) ? PALETTE_BIT_COUNT_4 : PALETTE_BIT_COUNT_8;
+        // Paleta obsahuje všechny položky daného počtu bitů
+        paletteEntries = 1u << bitCount;
+        // Délka řádku zarovnaná na násobek 4 bajtů
+        rowWidth = ((context->info.imageWidth * bitCount + BYTE_BITS * ROW_MULT_SIZE - 1) / (BYTE_BITS * ROW_MULT_SIZE)) * ROW_MULT_SIZE;
+    }
+
+    // Pokud jsou uloženy indexy barev, převádí se po blocích řádků
+    if(context->indexCanvas.bands != NULL && rowWidth > 0) {
+        // Počet řádků bloku podle velikosti bloku zápisu
+        blockRows = BMP_WRITE_BLOCK_SIZE / rowWidth;
+        if(blockRows == 0) {
+            blockRows = 1;
+        }
+        if(blockRows > context->info.imageHeight) {
+            blockRows = context->info.imageHeight;
+        }
+        // Alokace bloku (zarovnání řádků zůstává nulové)
+        blockData = (uint8_t*)calloc((size_t)rowWidth * blockRows + 1, 1);
+        // Kontrola alokace
+        if(blockData == NULL) {
+            // Nastavení chyby
+            setError(context, "blockData malloc failed.");
+            // Ukončení funkce s chybou
+            return RETURN_FAILURE;
+        }
+        // Sestavení tabulky barev pro převod na barvy
+        makeBGRTable(context, table);
+    }
+
+    // Řádek výplně má délku řádku indexů, příp. celého pásu barev
+    size_t fillSize = (context->indexCanvas.bands != NULL) ? context->info.imageWidth :
+                      (size_t)context->bgrCanvas.bandRows * context->bgrCanvas.rowBytes;
+    // Alokace řádku výplně
+    fillData = (uint8_t*)malloc(fillSize + 1);
+    // Kontrola alokace
+    if(fillData == NULL) {
+        // Nastavení chyby
+        setError(context, "fillData malloc failed.");
+        // Uvolnění bloku řádků
+        free(blockData);
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
+    // Blok řádků a výplň existují současně
+    noteBufferMemory(context, ((blockData != NULL) ? (uint64_t)rowWidth * blockRows : 0) + fillSize);
+    // Výplň nealokovaných pásů
+    memset(fillData, (context->indexCanvas.bands != NULL) ? context->indexCanvas.fill : 0, fillSize);
+
+    // Velikost palety v bajtech
+    uint32_t paletteBytes = paletteEntries * BMP_COLOR_SIZE;
+
+    // Zápis hlavičky BMP souboru
+    if(writeBMPHeader(context, logInfo, bitCount, paletteEntries, rowWidth, FLAG_FALSE) != RETURN_SUCCESS) {
+        // Uvolnění bloku řádků a výplně
+        free(blockData);
+        free(fillData);
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
+
+    // RGBQUAD - zápis palety (položky v pořadí BGR + rezervovaný bajt)
+    if(paletteEntries > 0) {
+        // Bajty celé palety
+        uint8_t paletteBMP[PALETTE_MAX_SIZE * BMP_COLOR_SIZE];
+        // Sestavení položek palety
+        for(uint32_t index = 0; index < paletteEntries; index++) {
+            paletteBMP[index * BMP_COLOR_SIZE] = context->palette[index].b;
+            paletteBMP[index * BMP_COLOR_SIZE + 1] = context->palette[index].g;
+            paletteBMP[index * BMP_COLOR_SIZE + 2] = context->palette[index].r;
+            paletteBMP[index * BMP_COLOR_SIZE + 3] = RESERVED_VALUE;
+        }
+        // Zápis celé palety
+        if(writeOutput(context, paletteBMP, paletteBytes) != RETURN_SUCCESS) {
+            // Nastavení chyby
+            setError(context, "BMP palette write failed.");
+            // Uvolnění bloku řádků a výplně
+            free(blockData);
+            free(fillData);
+            // Ukončení funkce s chybou
+            return RETURN_FAILURE;
+        }
+    }
+
+    // BITS - zápis barev pixelů
+    if(blockData == NULL) {
+        // Obrazová data jsou již ve tvaru BMP, pásy se zapíší v pořadí
+        for(uint32_t band = 0; band < context->bgrCanvas.bandCount; band++) {
+            // Velikost pásu
+            size_t bandSize = (size_t)getCanvasBandRows(&context->bgrCanvas, band) * context->bgrCanvas.rowBytes;
+            // Nealokovaný pás je černý
+            const uint8_t *bandData = (context->bgrCanvas.bands[band] != NULL) ? context->bgrCanvas.bands[band] : fillData;
+            // Zápis pásu jedním voláním
+            if(writeOutput(context, bandData, bandSize) != RETURN_SUCCESS) {
+                // Nastavení chyby
+                setError(context, "BMP data write failed.");
+                // Uvolnění výplně
+                free(fillData);
+                // Ukončení funkce s chybou
+                return RETURN_FAILURE;
+            }
+        }
+    } else {
+        // Řádky BMP jsou zdola nahoru, bloky se převádí od spodního řádku
+        for(uint32_t blockEnd = context->info.imageHeight; blockEnd > 0; ) {
+            // Počet řádků aktuálního bloku
+            uint32_t rows = (blockEnd < blockRows) ? blockEnd : blockRows;
+            // Převod řádků bloku
+            for(uint32_t blockRow = 0; blockRow < rows; blockRow++) {
+                // Řádek obrázku (shora) a jeho indexy barev
+                uint32_t row = blockEnd - 1 - blockRow;
+                const uint8_t *indexes = peekCanvasRow(&context->indexCanvas, row);
+                if(indexes == NULL) {
+                    indexes = fillData;
+                }
+                // Cílový řádek bloku
+                uint8_t *target = blockData + (size_t)blockRow * rowWidth;
+                // Převod na barvy, příp. zabalení indexů
+                if(bitCount == BIT_COUNT) {
+                    context->expandKernels.expandBGR(target, indexes, context->info.imageWidth, table);
                 } else {
-                    // Pokud je index v rozsahu nových indexů barev
-
-                    // Uložení položky z tabulky indexů podle aktuálního indexu
-                    actual = getItemByIndex(&colorTable, actualColorIndex);
-                    // Ukládání všech indexů z aktuální položky do výstupní tabulky
-                    for(uint32_t idx = 0; idx < actual->used; idx++) {
-                        // Pokud aktuálně zpracovávaný pixel má být neprůhledný
-                        if(imageBlockNumber == 1 || blockTrasparentColorFlag != FLAG_TRUE || actual->indexList[idx] != transparentColorIndex) {
-                            // Získání čísla řádku
-                            uint32_t rowIndex = getRowIndex();
-                            // Získání čísla sloupce
-                            uint32_t colIndex = getColIndex();
-                            // Uložení barvy aktuálního pixelu
-                            dataBMP[rowIndex][colIndex].r = actualColorTable[actual->indexList[idx]].r;
-                            dataBMP[rowIndex][colIndex].g = actualColorTable[actual->indexList[idx]].g;
-                            dataBMP[rowIndex][colIndex].b = actualColorTable[actual->indexList[idx]].b;
-                        }
-                        // Posun na další index výstupní tabulky
-                        nextPixelIndex++;
-                    }
+                    // Zabalení přičítá bity, řádek se musí vynulovat
+                    memset(target, 0, rowWidth);
+                    packIndexRow(target, indexes, context->info.imageWidth, bitCount);
                 }
+            }
+            // Zápis celého bloku jedním voláním
+            if(writeOutput(context, blockData, (size_t)rows * rowWidth) != RETURN_SUCCESS) {
+                // Nastavení chyby
+                setError(context, "BMP data write failed.");
+                // Uvolnění bloku řádků a výplně
+                free(blockData);
+                free(fillData);
+                // Ukončení funkce s chybou
+                return RETURN_FAILURE;
+            }
+            // Posun na další blok
+            blockEnd -= rows;
+        }
+        // Uvolnění bloku řádků
+        free(blockData);
+    }
+    // Uvolnění výplně
+    free(fillData);
+
+    // Zápis proběhl v pořádku
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro načtení dalšího sub-bloku obrazových dat ze vstupního souboru
+ *
+ * Funkce slouží jako zdroj dat čtečky LZW kódů, takže dekódování probíhá
+ * souběžně se čtením souboru a v paměti je vždy jen jeden sub-blok.
+ *
+ * source - kontext převodu (tGIF2BMPContext)
+ * data   - ukazatel pro uložení začátku načteného sub-bloku
+ *
+ * Návratová hodnota:
+ *     velikost načteného sub-bloku, 0 po ukončujícím bajtu nebo chybě
+ */
+size_t readSubBlock(void *source, const uint8_t **data) {
+    // Kontext převodu
+    tGIF2BMPContext *context = (tGIF2BMPContext*)source;
+    // Proměnná pro velikost sub-bloku
+    int blockSize = 0;
+
+    // Po ukončujícím bajtu již žádná data nenásledují
+    if(context->subBlocksTerminated == FLAG_TRUE) {
+        return 0;
+    }
+
+    // Získání velikosti sub-bloku
+    blockSize = getByte(context);
+    // Pokud se jedná o ukončující bajt nebo konec souboru
+    if(blockSize == BLOCK_TERMINATOR || blockSize == EOF) {
+        // Uložení příznaku konce dat
+        context->subBlocksTerminated = FLAG_TRUE;
+        return 0;
+    }
+
+    // Navrácení sub-bloku přímo ze vstupu (bez kopírování)
+    *data = getBytes(context, (size_t)blockSize);
+    // Kontrola konce souboru
+    if(*data == NULL) {
+        // Uložení příznaku konce dat
+        context->subBlocksTerminated = FLAG_TRUE;
+        return 0;
+    }
+    // Započítání sub-bloku
+    context->stats.subBlocks++;
+    return (size_t)blockSize;
+}
+
+/*
+ * Funkce pro nastavení ukazatele na aktuální řádek bloku
+ *
+ * Ukazatel míří na první pixel řádku bloku v indexech barev, příp. v barvách
+ * BMP. Řádek mimo logickou obrazovku nebo za koncem bloku má ukazatel NULL.
+ */
+void setRowData(tGIF2BMPContext *context) {
+    // Řádek logické obrazovky
+    uint32_t row = 0;
+
+    // Řádek za koncem bloku nebo blok mimo logickou obrazovku
+    if(context->actualRowNumber >= context->actualHeight || context->actualVisibleWidth == 0) {
+        context->actualRowData = NULL;
+        return;
+    }
+    // Řádek podle mapy řádků bloku
+    row = context->actualTop + context->rowMap[context->actualRowNumber];
+    // Řádek pod logickou obrazovkou
+    if(row >= context->info.imageHeight) {
+        context->actualRowData = NULL;
+    } else if(context->indexCanvas.bands != NULL) {
+        // Ukládají se indexy barev (řádek mimo alokovatelné pásy se neukládá)
+        context->actualRowData = touchCanvasRow(context, &context->indexCanvas, row);
+        if(context->actualRowData != NULL) {
+            context->actualRowData += context->actualLeft;
+        }
+    } else if(context->streaming == FLAG_TRUE) {
+        // Průběžně zapisovaný řádek
+        context->actualRowData = context->dataBMP + (size_t)context->actualLeft * ONE_PIXEL_SIZE;
+    } else {
+        // Ukládají se barvy BMP
+        context->actualRowData = getBMPPixel(context, row, context->actualLeft);
+    }
+}
+
+/*
+ * Funkce pro přípravu ukládání pixelů aktuálního bloku
+ *
+ * Sestaví mapu řádků bloku, příp. tabulku barev bloku, a nastaví první
+ * řádek.
+ */
+void startBlockPixels(tGIF2BMPContext *context) {
+    // Vynulování indexu dalšího dekódovaného pixelu
+    context->nextPixelIndex = 0;
+    // Počet pixelů bloku
+    context->actualPixelCount = context->actualWidth * context->actualHeight;
+    // Počet sloupců bloku uvnitř logické obrazovky
+    context->actualVisibleWidth = 0;
+    if(context->actualLeft < context->info.imageWidth) {
+        context->actualVisibleWidth = context->info.imageWidth - context->actualLeft;
+        if(context->actualVisibleWidth > context->actualWidth) {
+            context->actualVisibleWidth = context->actualWidth;
+        }
+    }
+    // Dekódování začíná prvním sloupcem prvního řádku
+    context->actualRowNumber = 0;
+    context->actualColumn = 0;
+    // Pokud se ukládají barvy, sestaví se tabulka barev bloku pro jádra
+    // převodu (indexy mimo tabulku barev bloku jsou černé)
+    if(context->indexCanvas.bands == NULL) {
+        for(uint16_t index = 0; index < PALETTE_MAX_SIZE; index++) {
+            context->blockColorTable[index] = 0;
+            if(context->actualColorTable != NULL && index < context->actualColorTableSize) {
+                context->blockColorTable[index] = makeExpandColor(context->actualColorTable[index].b, context->actualColorTable[index].g, context->actualColorTable[index].r, RESERVED_VALUE);
+            }
+        }
+    }
+    // Sestavení mapy řádků bloku
+    makeRowMap(context);
+    // Nastavení prvního řádku
+    setRowData(context);
+}
+
+/*
+ * Funkce pro zkrácení řetězce na pixely uvnitř bloku
+ *
+ * Přebytečná data za posledním pixelem bloku se ignorují. Index dalšího
+ * pixelu se posune za celý (zkrácený) řetězec. Po chybě průběžného zápisu
+ * se neukládá nic.
+ *
+ * count - počet pixelů řetězce
+ *
+ * Návratová hodnota:
+ *     počet ukládaných pixelů
+ */
+uint32_t startPixelString(tGIF2BMPContext *context, uint32_t count) {
+    // Po chybě průběžného zápisu se další pixely neukládají
+    if(context->streaming == FLAG_TRUE && context->error != RETURN_SUCCESS) {
+        return 0;
+    }
+    // Zkrácení řetězce na zbývající pixely bloku
+    if(count > context->actualPixelCount - context->nextPixelIndex) {
+        count = context->actualPixelCount - context->nextPixelIndex;
+    }
+    // Posun indexu dalšího pixelu za celý řetězec
+    context->nextPixelIndex += count;
+    // Navrácení počtu ukládaných pixelů
+    return count;
+}
+
+/*
+ * Funkce pro získání počtu pixelů úseku uvnitř logické obrazovky
+ *
+ * span - délka úseku (nejvýše do konce aktuálního řádku bloku)
+ *
+ * Návratová hodnota:
+ *     počet pixelů úseku, které se ukládají
+ */
+uint32_t getVisibleSpan(tGIF2BMPContext *context, uint32_t span) {
+    // Řádek nebo sloupec mimo logickou obrazovku
+    if(context->actualRowData == NULL || context->actualColumn >= context->actualVisibleWidth) {
+        return 0;
+    }
+    // Úsek zasahující za pravý okraj logické obrazovky se zkrátí
+    if(span > context->actualVisibleWidth - context->actualColumn) {
+        return context->actualVisibleWidth - context->actualColumn;
+    }
+    return span;
+}
+
+/*
+ * Funkce pro posun za uložený úsek
+ *
+ * Na konci řádku se pokračuje dalším řádkem bloku.
+ *
+ * span - délka úseku
+ */
+void advancePixelSpan(tGIF2BMPContext *context, uint32_t span) {
+    // Posun sloupce za úsek
+    context->actualColumn += span;
+    // Pokud úsek skončil na konci řádku, nastaví se další řádek bloku
+    if(context->actualColumn == context->actualWidth) {
+        // Dokončený řádek se při průběžném zápisu hned zapíše
+        if(context->streaming == FLAG_TRUE) {
+            flushStreamRow(context);
+        }
+        context->actualColumn = 0;
+        context->actualRowNumber++;
+        setRowData(context);
+    }
+}
+
+/*
+ * Funkce pro uložení řetězce pixelů neprůhledného bloku
+ *
+ * Řetězec se rozdělí jen na hranicích řádků bloku, každý úsek uvnitř
+ * řádku se uloží najednou (převod indexů, příp. jádrem převodu na barvy).
+ *
+ * target - kontext převodu (tGIF2BMPContext)
+ * colors - indexy barev do aktuální tabulky barev
+ * count  - počet pixelů řetězce
+ */
+void storePixelsOpaque(void *target, const uint8_t *colors, uint32_t count) {
+    // Kontext převodu
+    tGIF2BMPContext *context = (tGIF2BMPContext*)target;
+    // Ukládání po úsecích uvnitř řádků bloku
+    for(count = startPixelString(context, count); count > 0; ) {
+        // Délka úseku - zbytek řetězce nebo zbytek řádku
+        uint32_t span = context->actualWidth - context->actualColumn;
+        if(span > count) {
+            span = count;
+        }
+        // Počet pixelů úseku uvnitř logické obrazovky
+        uint32_t visible = getVisibleSpan(context, span);
+
+        // Pokud se ukládají indexy barev
+        if(visible > 0 && context->indexCanvas.bands != NULL) {
+            // Cílové indexy úseku
+            uint8_t *target = context->actualRowData + context->actualColumn;
+            // Největší uložený index úseku
+            uint8_t maxIndex = context->paletteMaxIndex;
+            // Převod indexů všech pixelů úseku
+            for(uint32_t idx = 0; idx < visible; idx++) {
+                // Index barvy v paletě obrazu
+                uint8_t paletteIndex = context->paletteRemap[colors[idx]];
+                // Uložení indexu barvy pixelu
+                target[idx] = paletteIndex;
+                // Uložení největšího použitého indexu barvy
+                maxIndex = (paletteIndex > maxIndex) ? paletteIndex : maxIndex;
+            }
+            context->paletteMaxIndex = maxIndex;
+        } else if(visible > 0) {
+            // Převod na barvy jádrem převodu
+            context->expandKernels.expandBGR(context->actualRowData + (size_t)context->actualColumn * ONE_PIXEL_SIZE, colors, visible, context->blockColorTable);
+        }
+
+        // Posun za úsek
+        colors += span;
+        count -= span;
+        advancePixelSpan(context, span);
+    }
+}
+
+/*
+ * Funkce pro uložení řetězce pixelů bloku s průhlednou barvou
+ *
+ * Úseky se dělí stejně jako u neprůhledného bloku. Každý pixel se uloží
+ * maskou - průhledný pixel zachová původní hodnotu, bez větvení v cyklu.
+ *
+ * target - kontext převodu (tGIF2BMPContext)
+ * colors - indexy barev do aktuální tabulky barev
+ * count  - počet pixelů řetězce
+ */
+void storePixelsTransparent(void *target, const uint8_t *colors, uint32_t count) {
+    // Kontext převodu
+    tGIF2BMPContext *context = (tGIF2BMPContext*)target;
+    // Index průhledné barvy
+    uint8_t transparentIndex = context->transparentColorIndex;
+
+    // Ukládání po úsecích uvnitř řádků bloku
+    for(count = startPixelString(context, count); count > 0; ) {
+        // Délka úseku - zbytek řetězce nebo zbytek řádku
+        uint32_t span = context->actualWidth - context->actualColumn;
+        if(span > count) {
+            span = count;
+        }
+        // Počet pixelů úseku uvnitř logické obrazovky
+        uint32_t visible = getVisibleSpan(context, span);
+
+        // Pokud se ukládají indexy barev
+        if(visible > 0 && context->indexCanvas.bands != NULL) {
+            // Cílové indexy úseku
+            uint8_t *target = context->actualRowData + context->actualColumn;
+            // Největší uložený index úseku
+            uint8_t maxIndex = context->paletteMaxIndex;
+            // Průchod pixely úseku
+            for(uint32_t idx = 0; idx < visible; idx++) {
+                // Maska zachování původní hodnoty (0xFF pro průhledný pixel)
+                uint8_t keep = (uint8_t)-(colors[idx] == transparentIndex);
+                // Index barvy v paletě obrazu (0 pro průhledný pixel)
+                uint8_t paletteIndex = context->paletteRemap[colors[idx]] & (uint8_t)~keep;
+                // Uložení indexu barvy přes masku
+                target[idx] = (target[idx] & keep) | paletteIndex;
+                // Uložení největšího použitého indexu barvy
+                maxIndex = (paletteIndex > maxIndex) ? paletteIndex : maxIndex;
+            }
+            context->paletteMaxIndex = maxIndex;
+        } else if(visible > 0) {
+            // Cílové barvy úseku
+            uint8_t *target = context->actualRowData + (size_t)context->actualColumn * ONE_PIXEL_SIZE;
+            // Průchod pixely úseku
+            for(uint32_t idx = 0; idx < visible; idx++) {
+                // Maska zachování původní hodnoty (0xFF pro průhledný pixel)
+                uint8_t keep = (uint8_t)-(colors[idx] == transparentIndex);
+                // Barva pixelu v pořadí B, G, R
+                const uint8_t *color = (const uint8_t*)&context->blockColorTable[colors[idx]];
+                // Uložení barvy přes masku
+                target[0] = (target[0] & keep) | (color[0] & (uint8_t)~keep);
+                target[1] = (target[1] & keep) | (color[1] & (uint8_t)~keep);
+                target[2] = (target[2] & keep) | (color[2] & (uint8_t)~keep);
+                // Posun na další pixel
+                target += ONE_PIXEL_SIZE;
+            }
+        }
+
+        // Posun za úsek
+        colors += span;
+        count -= span;
+        advancePixelSpan(context, span);
+    }
+}
+
+/*
+ * Funkce pro dekódování LZW dat jednoho image bloku
+ *
+ * Dekóduje kódy až po kód EOI, konec dat nebo první neplatný kód.
+ * Každý rozvinutý řetězec se předá výstupní funkci. Funkce nepoužívá
+ * kontext převodu, takže ji lze volat i z více vláken současně (každé
+ * vlákno s vlastním slovníkem).
+ *
+ * table           - slovník LZW
+ * minimumCodeSize - minimální velikost LZW kódu (nejvýše 8)
+ * fill            - funkce pro získání dalšího úseku dat
+ * source          - zdroj dat předávaný funkci fill
+ * output          - výstupní funkce pro rozvinuté řetězce
+ * target          - cíl předávaný výstupní funkci
+ * invalidCode     - ukazatel pro uložení neplatného kódu
+ * stats           - čítače dekódování (hodnoty se přičítají)
+ *
+ * Návratová hodnota:
+ *     LZW_DECODE_OK           - data byla dekódována
+ *     LZW_DECODE_INVALID_FIRST - neplatný první kód za clear kódem
+ *     LZW_DECODE_INVALID_CODE  - kód mimo slovník
+ */
+int decodeLZWData(tLZWTable *table, uint8_t minimumCodeSize, tLZWFillFunction fill, void *source,
+                  tLZWOutputFunction output, void *target, uint16_t *invalidCode, tLZWDecodeStats *stats) {
+    // Proměnná pro aktuální kód LZW
+    uint16_t actualColorIndex = 0x0;
+    // Proměnná pro předchozí kód LZW
+    uint16_t previousColorIndex = 0x0;
+    // Hodnota clear code (CC)
+    uint16_t clearCode = (1 << minimumCodeSize);
+    // Hodnota end of input (EOI)
+    uint16_t endOfInput = (clearCode + 1);
+    // Aktuální hodnota velikosti LZW kódu
+    uint8_t actualLZWCodeSize = (minimumCodeSize + 1);
+    // Čtečka LZW kódů z načtených dat
+    tLZWBitReader reader;
+    // Délka rozvinutého řetězce aktuálního kódu
+    uint16_t stringLength = 0;
+    // Příznak prvního bajtu po clear kódu
+    uint8_t isFirst = YES;
+    // Počet načtených kódů (čítač se uloží až na konci dekódování)
+    uint64_t codeCount = 0;
+
+    // Inicializace slovníku LZW
+    resetLZWTable(table, clearCode);
+    stats->resets++;
+    // Inicializace čtečky kódů nad úseky dat
+    initLZWStreamReader(&reader, fill, source, actualLZWCodeSize);
+
+    // Dokud data obsahují další celý kód,
+    // zpracovávám další kód LZW
+    while(readLZWCode(&reader, &actualColorIndex)) {
+        // Započítání kódu
+        codeCount++;
+        // Pokud je aktuální získaný kód EOI
+        if(actualColorIndex == endOfInput) {
+            // Konec cyklu zpracovávání vstupu
+            break;
+        }
 
-                // Přidání další položky do tabulky barev
-                //    - přidání dat z předchozího indexu
+        // Pokud je aktuální získaný kód clear kódem
+        if(actualColorIndex == clearCode) {
+            // Resetování aktuální hodnoty LZW kódu
+            actualLZWCodeSize = (minimumCodeSize + 1);
+            setLZWCodeSize(&reader, actualLZWCodeSize);
+            // Reinicializace slovníku LZW
+            resetLZWTable(table, clearCode);
+            stats->clearCodes++;
+            stats->resets++;
+            // Nastavení příznaku nového bloku po clear kódu
+            isFirst = YES;
+            // Pokračuje se dalším krokem cyklu
+            continue;
+        }
+
+        // Pokud se jedná o první kód po clear kódu
+        if(isFirst == YES) {
+            // První kód musí být kořenovou položkou slovníku
+            if(actualColorIndex >= clearCode) {
+                // Ukončení dekódování poškozených dat
+                *invalidCode = actualColorIndex;
+                stats->codes += codeCount;
+                return LZW_DECODE_INVALID_FIRST;
+            }
+            // Nastavení příznaku na zpracovaný první kód nového bloku
+            isFirst = NO;
+            // Uložení kódu pro vytvoření další položky slovníku
+            previousColorIndex = actualColorIndex;
+            // Uložení barvy aktuálního pixelu
+            uint8_t firstColor = (uint8_t)actualColorIndex;
+            output(target, &firstColor, 1);
+            // Pokračuje se dalším krokem cyklu
+            continue;
+        }
+
+        // Pokud kód ještě není ve slovníku ani není právě vznikající položkou
+        if(actualColorIndex > table->used) {
+            // Ukončení dekódování poškozených dat
+            *invalidCode = actualColorIndex;
+            stats->codes += codeCount;
+            return LZW_DECODE_INVALID_CODE;
+        }
+
+        // Přidání nové položky do slovníku
+        //    - předchozí řetězec + první index barvy aktuálního řetězce,
+        //      pro kód ještě mimo slovník (KwKwK) je to první index
+        //      barvy předchozího řetězce
+        if(actualColorIndex == table->used) {
+            addLZWTableItem(table, previousColorIndex, table->first[previousColorIndex]);
+        } else {
+            addLZWTableItem(table, previousColorIndex, table->first[actualColorIndex]);
+        }
+
+        // Rozvinutí řetězce aktuálního kódu
+        stringLength = unpackLZWTableItem(table, actualColorIndex);
+        // Předání všech indexů barev řetězce výstupní funkci
+        output(target, table->stack, stringLength);
+
+        // Pokud slovník zaplnil rozsah aktuální velikosti LZW kódu
+        if(table->used == (1u << actualLZWCodeSize) && actualLZWCodeSize < LZW_MAX_CODE_SIZE) {
+            // Inkrementace velikosti LZW
+            actualLZWCodeSize++;
+            setLZWCodeSize(&reader, actualLZWCodeSize);
+        }
+
+        // Uložení aktuálního kódu jako předchozího
+        previousColorIndex = actualColorIndex;
+    }
+
+    // Data byla dekódována
+    stats->codes += codeCount;
+    return LZW_DECODE_OK;
+}
+
+/*
+ * Funkce pro tisk chyby dekódování LZW dat
+ *
+ * status      - výsledek dekódování (decodeLZWData)
+ * invalidCode - neplatný kód
+ */
+void printLZWDecodeError(int status, uint16_t invalidCode) {
+    // Tisk chyby podle výsledku dekódování
+    if(status == LZW_DECODE_INVALID_FIRST) {
+        fprintf(stderr, "ERROR: Invalid first LZW code: %d.\n", invalidCode);
+    } else if(status == LZW_DECODE_INVALID_CODE) {
+        fprintf(stderr, "ERROR: Invalid LZW code: %d.\n", invalidCode);
+    }
+}
+
+/*
+ * Funkce pro přičtení čítačů dekódování bloku k čítačům převodu
+ *
+ * context  - kontext převodu
+ * lzwStats - čítače dekódování bloku
+ */
+void addLZWDecodeStats(tGIF2BMPContext *context, const tLZWDecodeStats *lzwStats) {
+    context->stats.codes += lzwStats->codes;
+    context->stats.clearCodes += lzwStats->clearCodes;
+    context->stats.dictionaryResets += lzwStats->resets;
+}
+
+/*
+ * Funkce pro zpracování dat v image bloku
+ *
+ * Návratová hodnota:
+ *         0 - bez chyby
+ *        -1 - předčasný konec souboru
+ */
+int processImageBlockData(tGIF2BMPContext *context) {
+    // Ukazatel na data přeskakovaného sub-bloku
+    const uint8_t *skippedData = NULL;
+    // Výsledek dekódování a neplatný kód
+    int status = LZW_DECODE_OK;
+    uint16_t invalidCode = 0;
+    // Čítače dekódování bloku
+    tLZWDecodeStats lzwStats = {0, 0, 0};
+
+    // Zatím nebyl načten ukončující bajt dat
+    context->subBlocksTerminated = FLAG_FALSE;
+    // Příprava ukládání pixelů bloku (mapa řádků, první řádek)
+    startBlockPixels(context);
+    // Ukládání pixelů se volí jednou pro celý blok - první blok je vždy
+    // neprůhledný, jinak rozhoduje příznak průhledné barvy
+    tLZWOutputFunction storePixels = storePixelsOpaque;
+    if(context->imageBlockNumber != 1 && context->blockTrasparentColorFlag == FLAG_TRUE) {
+        storePixels = storePixelsTransparent;
+    }
+
+    // Minimální velikost LZW kódu musí odpovídat 8bitovým indexům barev
+    if(context->LZWMininumCodeSize > BYTE_BITS) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: Unsupported LZW minimum code size: %d.\n", context->LZWMininumCodeSize);
+        // Data bloku se nedekódují, pouze se přeskočí
+        while(readSubBlock(context, &skippedData) > 0);
+        return context->error;
+    }
+
+    // Blok dekódovaný paralelním dekodérem se jen složí do obrazu
+    if(context->frameDecoder != NULL && context->actualFrame != NULL) {
+        // Čekání na dekódování bloku
+        const tDecodedFrame *decoded = waitDecodedFrame(context->frameDecoder, context->imageBlockNumber - 1);
+        // Blok bez bufferu se dekóduje ze vstupu
+        if(decoded->pixels != NULL) {
+            // Uložení všech dekódovaných pixelů (skládání se měří zvlášť)
+            double composeStart = getMonotonicTime();
+            storePixels(context, decoded->pixels, decoded->count);
+            context->stats.composeTime += getMonotonicTime() - composeStart;
+            // Převzetí čítačů dekódování bloku
+            addLZWDecodeStats(context, &decoded->lzwStats);
+            context->stats.subBlocks += decoded->subBlocks;
+            // Tisk chyby poškozených dat
+            printLZWDecodeError(decoded->status, decoded->invalidCode);
+            // Přeskočení dat bloku až za ukončující bajt
+            context->subBlocksTerminated = FLAG_TRUE;
+            skipBytes(context, (size_t)(context->scanOffset + context->actualFrame->endOffset - context->input.offset));
+            // Navrácení stavu převodu
+            return context->error;
+        }
+    }
+
+    // Dekódování sub-bloků vstupního souboru přímo do výstupní tabulky
+    status = decodeLZWData(&context->lzwTable, context->LZWMininumCodeSize, readSubBlock, context, storePixels, context, &invalidCode, &lzwStats);
+    addLZWDecodeStats(context, &lzwStats);
+    // Tisk chyby poškozených dat
+    printLZWDecodeError(status, invalidCode);
+
+    // Přeskočení sub-bloků za kódem EOI až po ukončující bajt
+    while(readSubBlock(context, &skippedData) > 0);
+
+    // Navrácení stavu převodu
+    return context->error;
+}
+
+/*
+ * Funkce pro zjištění, zda se buffery paralelního dekodéru vejdou do
+ * rozpočtu paměti
+ *
+ * Dekodér může mít současně dekódovaný počet bloků daný oknem dekódování,
+ * odhad proto počítá s největším dekódovaným blokem v každém místě okna.
+ *
+ * Návratová hodnota:
+ *     FLAG_TRUE  - rozpočet není omezen nebo se buffery vejdou
+ *     FLAG_FALSE - bloky se budou dekódovat převodem
+ */
+uint8_t fitFrameDecoderMemory(tGIF2BMPContext *context) {
+    // Největší počet pixelů dekódovaného bloku
+    uint64_t maxPixels = 0;
+
+    // Bez omezení rozpočtu
+    if(context->options.memoryLimit == 0) {
+        return FLAG_TRUE;
+    }
+    // Hledání největšího dekódovaného bloku
+    for(uint32_t index = 0; index < context->scan.count; index++) {
+        tGIFFrame *frame = &context->scan.frames[index];
+        if(frame->skip != FLAG_TRUE && (uint64_t)frame->width * frame->height > maxPixels) {
+            maxPixels = (uint64_t)frame->width * frame->height;
+        }
+    }
+    // Buffery všech bloků okna dekódování
+    return (maxPixels * context->options.frameThreads * FRAME_DECODER_WINDOW <= context->options.memoryLimit) ? FLAG_TRUE : FLAG_FALSE;
+}
+
+/*
+ * Funkce pro předběžný průchod bloky souboru
+ *
+ * Průchod je možný jen nad vstupem celým v paměti (mapovaný soubor nebo
+ * data v paměti), jinak se dekódují všechny bloky převodem. Při vypnutém přeskakování se bloky
+ * nepřeskakují, průchod slouží jen paralelnímu dekódování. Chyba průchodu
+ * pouze vypne přeskakování i paralelní dekódování.
+ *
+ * Návratová hodnota:
+ *      0 - vždy (převod pokračuje i bez výsledku průchodu)
+ */
+int scanFrames(tGIF2BMPContext *context) {
+    // Nad blokově čteným vstupem se nic nezjišťuje, průchod bez
+    // přeskakování je potřeba jen pro paralelní dekódování
+    if(context->input.buffer != NULL ||
+       (context->frameSkipDisabled == FLAG_TRUE && context->options.frameThreads <= 1 && context->options.streaming != FLAG_TRUE)) {
+        return RETURN_SUCCESS;
+    }
+    // Pozice vstupu, od které průchod čte
+    context->scanOffset = context->input.offset;
+    // Průchod zbytkem mapovaných dat
+    if(scanGIFFrames(&context->scan, context->input.data + context->input.position, context->input.length - context->input.position,
+                     context->info.imageWidth, context->info.imageHeight) != RETURN_SUCCESS) {
+        return RETURN_SUCCESS;
+    }
+
+    // Při vypnutém přeskakování se zruší označení překrytých bloků
+    if(context->frameSkipDisabled == FLAG_TRUE) {
+        for(uint32_t index = 0; index < context->scan.count; index++) {
+            context->scan.frames[index].skip = FLAG_FALSE;
+        }
+        context->scan.skipCount = 0;
+    }
+
+    // Paralelní dekódování má smysl až pro dva dekódované bloky
+    // (dekodér, který nelze spustit, nahradí dekódování převodem)
+    if(context->options.frameThreads > 1 && context->scan.count - context->scan.skipCount >= 2 &&
+       fitFrameDecoderMemory(context) == FLAG_TRUE) {
+        context->frameDecoder = startFrameDecoder(context->input.data + context->input.position,
+                                                  context->input.length - context->input.position,
+                                                  &context->scan, context->options.frameThreads);
+    }
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro uvolnění aktuálního bloku paralelního dekodéru
+ *
+ * Posune okno dekódování za aktuální blok a uvolní jeho buffer.
+ */
+void releaseActualFrame(tGIF2BMPContext *context) {
+    // Jen blok známý paralelnímu dekodéru
+    if(context->frameDecoder != NULL && context->actualFrame != NULL) {
+        releaseDecodedFrame(context->frameDecoder, (uint32_t)(context->actualFrame - context->scan.frames));
+    }
+}
+
+/*
+ * Funkce pro zastavení paralelního dekodéru bloků
+ */
+void stopFrames(tGIF2BMPContext *context) {
+    // Zastavení běžícího dekodéru
+    if(context->frameDecoder != NULL) {
+        noteBufferMemory(context, context->frameDecoder->bufferPeak);
+        stopFrameDecoder(context->frameDecoder);
+        context->frameDecoder = NULL;
+    }
+}
+
+/*
+ * Funkce pro započítání lokální tabulky barev a prokládání image bloku
+ * do záznamu o převodu
+ *
+ * context       - kontext převodu
+ * blockBitField - bitové pole popisu bloku
+ */
+void countBlockFlags(tGIF2BMPContext *context, uint8_t blockBitField) {
+    // Blok s lokální tabulkou barev
+    if((blockBitField & AND_OF_COLOR_TABLE_FLAG) == AND_OF_COLOR_TABLE_FLAG) {
+        // Velikost tabulky - 2^(velikost + 1)
+        uint16_t lctSize = (uint16_t)(2u << (blockBitField & AND_OF_COLOR_TABLE_SIZE));
+        context->stats.localTables++;
+        if(lctSize > context->stats.lctMaxSize) {
+            context->stats.lctMaxSize = lctSize;
+        }
+    }
+    // Prokládaný blok
+    if((blockBitField & AND_OF_INTERLACE_FLAG) == AND_OF_INTERLACE_FLAG) {
+        context->stats.interlacedFrames++;
+    }
+}
 
-                // Pokud je index v rozsahu globální tabulky barev
-                if(previousColorIndex < actualColorTableSize) {
-                    // Uložení indexu do nové položky
-                    addByteToTableItem(&newTableItem, previousColorIndex);
-                } else {
-                    // Pokud je index v rozsahu nových indexů
-
-                    // Uložení položky předchozího indexu
-                    previous = getItemByIndex(&colorTable, previousColorIndex);
-                    // Ukládání indexů z předchozího indexu do nové položky
-                    for(uint32_t idx = 0; idx < previous->used; idx++) {
-                        // Přidání jednoho indexu do nové položky
-                        addByteToTableItem(&newTableItem, previous->indexList[idx]);
-                    }
-                }
-                //    - přidání prvního bajtu z aktuálního indexu
+/*
+ * Funkce pro přeskočení sub-bloků dat až po ukončující bajt
+ *
+ * dataSize - ukazatel pro přičtení počtu bajtů dat sub-bloků
+ *
+ * Návratová hodnota:
+ *      0 - sub-bloky byly přeskočeny
+ *     -1 - předčasný konec souboru
+ */
+int skipDataSubBlocks(tGIF2BMPContext *context, uint64_t *dataSize) {
+    // Velikost prvního sub-bloku
+    int blockSize = getByte(context);
 
-                // Pokud je index v rozsahu globální tabulky barev
-                if(actualColorIndex < actualColorTableSize) {
-                    // Uložení indexu do nové položky
-                    addByteToTableItem(&newTableItem, actualColorIndex);
-                } else {
-                    // Pokud je index v rozsahu nových indexů
+    // Dokud pokračují sub-bloky s daty
+    while(blockSize > 0) {
+        // Přeskočení dat sub-bloku podle jeho velikosti
+        if(skipBytes(context, (size_t)blockSize) != RETURN_SUCCESS) {
+            return RETURN_FAILURE;
+        }
+        // Započítání sub-bloku
+        *dataSize += (uint64_t)blockSize;
+        context->stats.subBlocks++;
+        // Velikost dalšího sub-bloku, příp. ukončující bajt
+        blockSize = getByte(context);
+    }
 
-                    // Uložení prvního indexu aktuální položky
-                    addByteToTableItem(&newTableItem, actual->indexList[0]);
-                }
-                // Přidání nové vytvořené položky do tabulky
-                insertNewItem(&colorTable, &newTableItem);
-            } else {
-                // Pokud aktuální index barvy ještě není v tabulce
-
-                // Přidání další položky do tabulky barev
-                //    - přidání dat z předchozího indexu
-
-                // Pokud je index v rozsahu globální tabulky barev
-                if(previousColorIndex < actualColorTableSize) {
-                    // Uložení indexu do nové položky
-                    addByteToTableItem(&newTableItem, previousColorIndex);
-                } else {
-                    // Pokud je index v rozsahu nových indexů
-
-                    // Uložení položky předchozího indexu
-                    previous = getItemByIndex(&colorTable, previousColorIndex);
-                    // Ukládání indexů z předchozího indexu do nové položky
-                    for(uint32_t idx = 0; idx < previous->used; idx++) {
-                        // Přidání jednoho indexu do nové položky
-                        addByteToTableItem(&newTableItem, previous->indexList[idx]);
-                    }
-                }
-                //    - přidání prvního bajtu z předchozího indexu
+    // Navrácení stavu (EOF při předčasném konci souboru)
+    return (blockSize == EOF) ? RETURN_FAILURE : RETURN_SUCCESS;
+}
 
-                // Pokud je index v rozsahu globální tabulky barev
-                if(previousColorIndex < actualColorTableSize) {
-                    // Uložení indexu do nové položky
-                    addByteToTableItem(&newTableItem, previousColorIndex);
-                } else {
-                    // Uložení prvního indexu předchozí položky
-                    addByteToTableItem(&newTableItem, previous->indexList[0]);
-                }
-                // Přidání nové vytvořené položky do tabulky
-                insertNewItem(&colorTable, &newTableItem);
-                // Data z aktuálního indexu jdou na výstup
-
-                // Uložení položky aktuálního indexu
-                actual = getItemByIndex(&colorTable, actualColorIndex);
-                // Ukládání indexů z aktuálního indexu do výstupní tabulky
-                for(uint32_t idx = 0; idx < actual->used; idx++) {
-                    // Pokud aktuálně zpracovávaný pixel má být neprůhledný
-                    if(imageBlockNumber == 1 || blockTrasparentColorFlag != FLAG_TRUE || actual->indexList[idx] != transparentColorIndex) {
-                        // Získání čísla řádku
-                        uint32_t rowIndex = getRowIndex();
-                        // Získání čísla sloupce
-                        uint32_t colIndex = getColIndex();
-                        // Uložení barvy aktuálního pixelu
-                        dataBMP[rowIndex][colIndex].r = actualColorTable[actual->indexList[idx]].r;
-                        dataBMP[rowIndex][colIndex].g = actualColorTable[actual->indexList[idx]].g;
-                        dataBMP[rowIndex][colIndex].b = actualColorTable[actual->indexList[idx]].b;
-                    }
-                    // Posun na další index výstupní tabulky
-                    nextPixelIndex++;
-                }
-            }
+/*
+ * Funkce pro popis image bloku bez dekódování jeho dat
+ *
+ * Popis bloku se doplní údaji posledního bloku graphic control, který
+ * se k bloku vztahuje. Lokální tabulka barev a data bloku se přeskočí.
+ *
+ * descriptor - popis image bloku (IMAGE_DESCRIPTOR_SIZE bajtů)
+ *
+ * Návratová hodnota:
+ *      0 - blok byl popsán
+ *     -1 - předčasný konec souboru nebo chyba alokace
+ */
+int probeImageBlock(tGIF2BMPContext *context, const uint8_t *descriptor) {
+    // Zjišťované informace
+    tGIFProbe *probe = context->probe;
+    // Popis bloku
+    tGIFProbeFrame frame;
+
+    // Pozice, rozměry a prokládání bloku
+    frame.left = readWord(&descriptor[0]);
+    frame.top = readWord(&descriptor[2]);
+    frame.width = readWord(&descriptor[4]);
+    frame.height = readWord(&descriptor[6]);
+    frame.interlaced = ((descriptor[8] & AND_OF_INTERLACE_FLAG) == AND_OF_INTERLACE_FLAG) ? FLAG_TRUE : FLAG_FALSE;
+    // Velikost lokální tabulky barev
+    frame.lctSize = 0;
+    if((descriptor[8] & AND_OF_COLOR_TABLE_FLAG) == AND_OF_COLOR_TABLE_FLAG) {
+        frame.lctSize = (uint16_t)(1u << ((descriptor[8] & AND_OF_COLOR_TABLE_SIZE) + 1));
+    }
+    // Údaje bloku graphic control, který se vztahuje k tomuto bloku
+    frame.delay = 0;
+    frame.disposal = 0;
+    frame.transparentIndex = -1;
+    if(context->blockControlPending == FLAG_TRUE) {
+        frame.delay = context->blockDelayTime;
+        frame.disposal = context->blockDisposalMethod;
+        if(context->blockTrasparentColorFlag == FLAG_TRUE) {
+            frame.transparentIndex = context->transparentColorIndex;
         }
-    // Cyklus procházení načtených dat,
-    // případné ukončení po dosažení konce dat - prevence zacyklení
-    } while(actualIndex < (dataIndex + 2));
+        context->blockControlPending = FLAG_FALSE;
+    }
+    frame.minimumCodeSize = 0;
+    frame.dataSize = 0;
 
-    // Pokud blok obsahoval obrazová data
-    if(data != NULL) {
-        // Uvolnění místa po datech
-        free(data);
+    // Přeskočení lokální tabulky barev
+    if(skipBytes(context, (size_t)frame.lctSize * ONE_PIXEL_SIZE) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+    // Minimální velikost LZW kódu
+    int minimumCodeSize = getByte(context);
+    if(minimumCodeSize == EOF) {
+        return RETURN_FAILURE;
+    }
+    frame.minimumCodeSize = (uint8_t)minimumCodeSize;
+
+    // Pokud je pole popisů plné, zvětší se na dvojnásobek
+    if(probe->frameCount == probe->frameCapacity) {
+        // Nová kapacita pole
+        uint32_t capacity = (probe->frameCapacity == 0) ? GIF_PROBE_ALLOC_SIZE : probe->frameCapacity * 2;
+        // Realokace pole
+        tGIFProbeFrame *frames = (tGIFProbeFrame*)realloc(probe->frames, sizeof(tGIFProbeFrame) * capacity);
+        // Kontrola alokace
+        if(frames == NULL) {
+            // Tisk chyby
+            setError(context, "probe frames malloc failed.");
+            // Ukončení funkce s chybou
+            return RETURN_FAILURE;
+        }
+        probe->frames = frames;
+        probe->frameCapacity = capacity;
     }
 
-    // Uvolnění paměti po tabulce nových indexů barev
-    freeTable(&colorTable);
+    // Přeskočení dat bloku podle velikostí sub-bloků
+    int result = skipDataSubBlocks(context, &frame.dataSize);
+    // Uložení popisu bloku (i zkráceného)
+    probe->frames[probe->frameCount++] = frame;
+
+    // Navrácení výsledku přeskočení dat
+    return result;
 }
 
 /*
  * Funkce pro zpracování bloku s obrazovými daty
+ *
+ * Návratová hodnota:
+ *      0 - blok byl zpracován
+ *     -1 - chyba při zpracování bloku
  */
-void processImageBlock() {
+int processImageBlock(tGIF2BMPContext *context) {
     // Tisk informace o zpracovávání bloku s obrazovými daty
     // fprintf(stderr, "INFO: Image block\n");
     // Inkrementace pořadí image bloku
-    imageBlockNumber++;
+    context->imageBlockNumber++;
+
+    // Záznam bloku z předběžného průchodu, jen pokud pozice bloku
+    // odpovídá průchodu (oddělovač bloku již byl přečten)
+    context->actualFrame = NULL;
+    if(context->imageBlockNumber <= context->scan.count &&
+       context->scanOffset + context->scan.frames[context->imageBlockNumber - 1].offset + 1 == context->input.offset) {
+        context->actualFrame = &context->scan.frames[context->imageBlockNumber - 1];
+    }
+
+    // Blok zcela překrytý pozdějšími bloky se celý přeskočí bez dekódování
+    if(context->actualFrame != NULL && context->actualFrame->skip == FLAG_TRUE) {
+        context->skippedFrames++;
+        // Posun okna paralelního dekódování za blok
+        releaseActualFrame(context);
+        // Popis přeskočeného bloku se jen započítá do záznamu o převodu
+        const uint8_t *skippedDescriptor = getBytes(context, IMAGE_DESCRIPTOR_SIZE);
+        if(skippedDescriptor == NULL) {
+            return RETURN_FAILURE;
+        }
+        countBlockFlags(context, skippedDescriptor[8]);
+        return skipBytes(context, (size_t)(context->scanOffset + context->actualFrame->endOffset - context->input.offset));
+    }
+
+    // Načtení celého popisu image bloku najednou
+    const uint8_t *descriptor = getBytes(context, IMAGE_DESCRIPTOR_SIZE);
+    // Kontrola konce souboru
+    if(descriptor == NULL) {
+        return RETURN_FAILURE;
+    }
+    // Započítání lokální tabulky barev a prokládání do záznamu o převodu
+    countBlockFlags(context, descriptor[8]);
+    // Při zjišťování informací se blok jen popíše
+    if(context->probe != NULL) {
+        return probeImageBlock(context, descriptor);
+    }
 
     // Proměnná pro pozici levého okraje bloku
     // a její výpočet
-    uint16_t blockLeftPosition = getByte();
-    blockLeftPosition += (getByte() * BYTE_OVERFLOW);
+    uint16_t blockLeftPosition = readWord(&descriptor[0]);
     // Tisk pozice levého okraje bloku
     // fprintf(stderr, "INFO: Block left position: %d\n", blockLeftPosition);
     // Uložení levé pozice aktuálního bloku
-    actualLeft = blockLeftPosition;
+    context->actualLeft = blockLeftPosition;
 
     // Proměnná pro pozici horního okraje bloku
     // a její výpočet
-    uint16_t blockTopPosition = getByte();
-    blockTopPosition += (getByte() * BYTE_OVERFLOW);
+    uint16_t blockTopPosition = readWord(&descriptor[2]);
     // Tisk pozice horního okraje bloku
     // fprintf(stderr, "INFO: Block top position: %d\n", blockTopPosition);
     // Uložení horní pozice aktuálního bloku
-    actualTop = blockTopPosition;
+    context->actualTop = blockTopPosition;
 
     // Proměnná pro šířku bloku
     // a její výpočet
-    uint16_t blockWidth = getByte();
-    blockWidth += (getByte() * BYTE_OVERFLOW);
+    uint16_t blockWidth = readWord(&descriptor[4]);
     // Tisk šířky bloku
     // fprintf(stderr, "INFO: Block width: %d\n", blockWidth);
     // Uložení šířky aktuálního bloku
-    actualWidth = blockWidth;
+    context->actualWidth = blockWidth;
 
     // Proměnná pro výšku bloku
     // a její výpočet
-    uint16_t blockHeight = getByte();
-    blockHeight += (getByte() * BYTE_OVERFLOW);
+    uint16_t blockHeight = readWord(&descriptor[6]);
     // Tisk výšky bloku
     // fprintf(stderr, "INFO: Block height: %d\n", blockHeight);
     // Uložení výšky aktuálního bloku
-    actualHeight = blockHeight;
+    context->actualHeight = blockHeight;
 
     // Proměnná pro bitové pole bloku
     // a jeho získání
-    uint8_t blockBitField = getByte();
+    uint8_t blockBitField = descriptor[8];
 
     // Proměnná pro příznak lokální tabulky barev
     uint8_t localColorTableFlag = FLAG_FALSE;
     // Vynulování příznaku prokládání
-    blockInterlaceFlag = FLAG_FALSE;
+    context->blockInterlaceFlag = FLAG_FALSE;
     // Proměnná pro příznak setřídění tabulky barev
     uint8_t localColorTableSortFlag = FLAG_FALSE;
     // Proměnná pro velikost lokální tabulky barev
@@ -1122,12 +2410,7 @@ void processImageBlock() {
 
     // Získání příznaku prokládání
     if((blockBitField & AND_OF_INTERLACE_FLAG) == AND_OF_INTERLACE_FLAG) {
-        blockInterlaceFlag = FLAG_TRUE;
-
-        // Vynulování aktuálního proloženého řádku
-        actualInterlaceRow = 0;
-        // Vynulování aktuálního stavu prokládání
-        interlaceState = STATE0;
+        context->blockInterlaceFlag = FLAG_TRUE;
     }
     // Tisk příznaku prokládání
     // fprintf(stderr, "INFO: Block interlace flag: %d\n", blockInterlaceFlag);
@@ -1153,7 +2436,9 @@ void processImageBlock() {
         // fprintf(stderr, "INFO: Local color table size: %d\n", localColorTableSize);
 
         // Vytvoření lokální tabulky barev
-        makeLCT(localColorTableSize);
+        if(makeLCT(context, localColorTableSize) != RETURN_SUCCESS) {
+            return RETURN_FAILURE;
+        }
 
         // Tisk nadpisu lokální tabulky barev
         // fprintf(stderr, "INFO: Local color table:\n");
@@ -1171,54 +2456,113 @@ void processImageBlock() {
         // Zpracování bloku bude pracovat s lokální tabulkou barev
 
         // Nastavení používané tabulky na lokální
-        actualColorTable = localColorTable;
+        context->actualColorTable = context->localColorTable;
         // Nastavení velikosti tabulky na velikost lokální
-        actualColorTableSize = localColorTableSize;
+        context->actualColorTableSize = localColorTableSize;
     } else {
         // Zpracování bloku bude pracovat s globální tabulkou barev
 
         // Nastavení používané tabulky na blobální
-        actualColorTable = globalColorTable;
+        context->actualColorTable = context->globalColorTable;
         // Nastavení velikosti tabulky na velikost globální
-        actualColorTableSize = info.gctSize;
+        context->actualColorTableSize = context->info.gctSize;
     }
 
+    // Proměnná pro výsledek zpracování bloku
+    int result = RETURN_FAILURE;
     // Získání minimální velikosti LZW kódu
-    LZWMininumCodeSize = getByte();
+    int minimumCodeSize = getByte(context);
     // Tisk minimální velikosti LZW kódu
-    // fprintf(stderr, "INFO: LZW minimum code size: %d\n", LZWMininumCodeSize);
+    // fprintf(stderr, "INFO: LZW minimum code size: %d\n", minimumCodeSize);
+
+    // Pokud soubor nekončí, zpracují se data v image bloku
+    if(minimumCodeSize != EOF) {
+        // Sloučení palety bloku s paletou obrazu patří ke skládání
+        double composeStart = getMonotonicTime();
+        int paletteResult = checkBlockPalette(context);
+        context->stats.composeTime += getMonotonicTime() - composeStart;
+        if(paletteResult == RETURN_SUCCESS) {
+            context->LZWMininumCodeSize = (uint8_t)minimumCodeSize;
+            result = processImageBlockData(context);
+        }
+    }
+    // Posun okna paralelního dekódování za blok
+    releaseActualFrame(context);
+
+    // Příznak neprůhledného bloku (první blok je vždy neprůhledný)
+    uint8_t opaqueBlock = (context->imageBlockNumber == 1 || context->blockTrasparentColorFlag != FLAG_TRUE) ? FLAG_TRUE : FLAG_FALSE;
+
+    // Přeskočené bloky spoléhají na to, že je překrývající bloky vykreslí
+    // celé - blok, který některý řádek své mapy řádků nevykreslil celý,
+    // vyžaduje nový převod (blok, který průchodu neodpovídá, se považuje
+    // za překrývající)
+    if(result == RETURN_SUCCESS && context->skippedFrames > 0 && opaqueBlock == FLAG_TRUE &&
+       (context->actualFrame == NULL || context->actualFrame->covering == FLAG_TRUE) &&
+       context->actualWidth > 0 && context->actualRowNumber < context->actualHeight) {
+        context->frameSkipFailed = FLAG_TRUE;
+        result = RETURN_FAILURE;
+    }
+
+    // Neprůhledný blok, který celý vykreslil celou logickou obrazovku,
+    // přepsal všechny nevykreslené (černé) pixely
+    if(opaqueBlock == FLAG_TRUE &&
+       blockLeftPosition == 0 && blockTopPosition == 0 &&
+       blockWidth >= context->info.imageWidth && blockHeight >= context->info.imageHeight &&
+       context->nextPixelIndex >= (uint32_t)blockWidth * blockHeight) {
+        context->canvasCovered = FLAG_TRUE;
+    }
 
-    // Zpracování dat v image bloku
-    processImageBlockData();
+    // První blok palety bez černé barvy musel vykreslit celou obrazovku
+    if(context->paletteBlackMissing == FLAG_TRUE) {
+        double composeStart = getMonotonicTime();
+        if(finishBlackMissingPalette(context) != RETURN_SUCCESS) {
+            result = RETURN_FAILURE;
+        }
+        context->stats.composeTime += getMonotonicTime() - composeStart;
+    }
 
     // Pokud byla využita lokální tabulka barev
-    if(localColorTableFlag == FLAG_TRUE && localColorTable != NULL) {
+    if(localColorTableFlag == FLAG_TRUE && context->localColorTable != NULL) {
         // Uvolnění paměti po lokální tabulce barev
-        free(localColorTable);
+        free(context->localColorTable);
+        context->localColorTable = NULL;
     }
+
+    // Navrácení výsledku zpracování bloku
+    return result;
 }
 
 /*
  * Funkce pro zpracování bloku rozšíření graphic control
+ *
+ * Návratová hodnota:
+ *      0 - blok byl zpracován
+ *     -1 - předčasný konec souboru
  */
-void processGraphicControlBlock() {
+int processGraphicControlBlock(tGIF2BMPContext *context) {
     // Tisk informace o zpracovávání graphic control bloku
     // fprintf(stderr, "INFO: Graphic control\n");
 
+    // Načtení celého bloku najednou
+    const uint8_t *block = getBytes(context, GRAPHIC_CONTROL_BLOCK_SIZE);
+    // Kontrola konce souboru
+    if(block == NULL) {
+        return RETURN_FAILURE;
+    }
+
     // Proměnná pro velikost bloku
     // a její získání
-    uint8_t blockSize = getByte();
+    uint8_t blockSize = block[0];
     // Tisk velikosti bloku
     // fprintf(stderr, "INFO: Block size: %d\n", blockSize);
 
     // Proměnná pro bitové pole bloku
     // a jeho získání
-    uint8_t blockBitField = getByte();
+    uint8_t blockBitField = block[1];
 
-    // Proměnná pro disposal method bloku
-    // a její získání
-    uint8_t blockDisposalMethod = (blockBitField & AND_OF_DISPOSAL_METHOD);
-    blockDisposalMethod = blockDisposalMethod >> DISPOSAL_METHOD_SHIFT;
+    // Získání disposal method bloku
+    context->blockDisposalMethod = (blockBitField & AND_OF_DISPOSAL_METHOD);
+    context->blockDisposalMethod = context->blockDisposalMethod >> DISPOSAL_METHOD_SHIFT;
     // Tisk disposal method
     // fprintf(stderr, "INFO: Block disposal method: %d\n", blockDisposalMethod);
 
@@ -1232,28 +2576,28 @@ void processGraphicControlBlock() {
     // fprintf(stderr, "INFO: Block user input flag: %d\n", blockUserInputFlag);
 
     // Získání příznaku průhlednosti
-    blockTrasparentColorFlag = (blockBitField & AND_OF_TRANSPARENT_FLAG);
+    context->blockTrasparentColorFlag = (blockBitField & AND_OF_TRANSPARENT_FLAG);
     // Tisk příznaku průhlednosti
     // fprintf(stderr, "INFO: Block transparent flag: %d\n", blockTrasparentColorFlag);
 
-    // Proměnná pro dobu zpoždění
-    // a její získání
-    uint16_t blockDelayTime = getByte();
-    blockDelayTime += (getByte() * BYTE_OVERFLOW);
+    // Získání doby zpoždění
+    context->blockDelayTime = readWord(&block[2]);
     // Výpis doby zpoždění
     // fprintf(stderr, "INFO: Block delay time: %d (1/100s)\n", blockDelayTime);
 
     // Získání indexu průhledné barvy
-    transparentColorIndex = getByte();
+    context->transparentColorIndex = block[4];
+    // Blok se vztahuje k následujícímu image bloku
+    context->blockControlPending = FLAG_TRUE;
 
     // Pokud je nastaven příznak průhlednosti
-    if(blockTrasparentColorFlag == FLAG_TRUE) {
+    if(context->blockTrasparentColorFlag == FLAG_TRUE) {
         // Tisk indexu průhledné barvy
         // fprintf(stderr, "INFO: Transparent color index: %d\n", transparentColorIndex);
     }
 
     // Získání ukončujícího bajtu bloku
-    blockSize = getByte();
+    blockSize = block[5];
 
     // Pokud se nejedná o ukončující bajt
     if(blockSize != BLOCK_TERMINATOR) {
@@ -1263,30 +2607,36 @@ void processGraphicControlBlock() {
         // Jinak tiskni informaci o konci bloku
         // fprintf(stderr, "INFO: Graphic control block terminator\n");
     }
+
+    // Blok byl zpracován
+    return RETURN_SUCCESS;
 }
 
 /*
  * Funkce pro zpracování bloku rozšíření komentáře
+ *
+ * Návratová hodnota:
+ *      0 - blok byl zpracován
+ *     -1 - předčasný konec souboru
  */
-void processCommentBlock() {
+int processCommentBlock(tGIF2BMPContext *context) {
     // Tisk informace o zpracovávání bloku komentáře
     // fprintf(stderr, "INFO: Comment\n");
 
     // Proměnná pro velikost bloku komentáře
     // a její získání
-    uint8_t blockSize = getByte();
+    int blockSize = getByte(context);
 
     // Dokud pokračuje blok s daty
     while(blockSize > 0) {
-        // Projdi všechny datové bajty bloku
-        for(uint8_t blockIndex = 0; blockIndex < blockSize; blockIndex++) {
-            // Načti jeden bajt dat
-            getByte();
+        // Přeskoč všechny datové bajty bloku
+        if(skipBytes(context, (size_t)blockSize) != RETURN_SUCCESS) {
+            return RETURN_FAILURE;
         }
 
         // Zjisti novou velikost bloku,
         // popř. načti ukončující bajt bloku
-        blockSize = getByte();
+        blockSize = getByte(context);
 
         // Pokud se nejedná o ukončující bajt bloku
         if(blockSize != BLOCK_TERMINATOR) {
@@ -1298,75 +2648,40 @@ void processCommentBlock() {
             // fprintf(stderr, "INFO: Comment block terminator\n");
         }
     }
+
+    // Navrácení stavu (EOF při předčasném konci souboru)
+    return (blockSize == EOF) ? RETURN_FAILURE : RETURN_SUCCESS;
 }
 
 /*
  * Funkce pro zpracování bloku rozšíření prostého textu
+ *
+ * Návratová hodnota:
+ *      0 - blok byl zpracován
+ *     -1 - předčasný konec souboru
  */
-void processPlainTextBlock() {
+int processPlainTextBlock(tGIF2BMPContext *context) {
     // Tisk informace o zpracovávání bloku prostého textu
     // fprintf(stderr, "INFO: Plain text\n");
 
+    // Načtení celé hlavičky bloku najednou
+    const uint8_t *block = getBytes(context, PLAIN_TEXT_BLOCK_SIZE);
+    // Kontrola konce souboru
+    if(block == NULL) {
+        return RETURN_FAILURE;
+    }
+
     // Proměnná pro velikost bloku
     // a její získání
-    uint8_t blockSize = getByte();
+    int blockSize = block[0];
     // Tisk velikosti bloku
     // fprintf(stderr, "INFO: Block size: %d\n", blockSize);
 
-    // Proměnná pro pozici levého okraje mřížky textu
-    // a její získání
-    uint16_t textGridLeftPosition = getByte();
-    textGridLeftPosition += (getByte() * BYTE_OVERFLOW);
-    // Tisk pozice levého okraje mřížky textu
-    // fprintf(stderr, "INFO: Text grid left position: %d\n", textGridLeftPosition);
-
-    // Proměnná pro pozici horního okraje mřížky textu
-    // a její získání
-    uint16_t textGridTopPosition = getByte();
-    textGridTopPosition += (getByte() * BYTE_OVERFLOW);
-    // Tisk pozice horního okraje mřížky textu
-    // fprintf(stderr, "INFO: Text grid top position: %d\n", textGridTopPosition);
-
-    // Proměnná pro šířku mřížky textu
-    // a její získání
-    uint16_t textGridWidth = getByte();
-    textGridWidth += (getByte() * BYTE_OVERFLOW);
-    // Tisk šířky mřížky textu
-    // fprintf(stderr "INFO: Text grid width: %d\n", textGridWidth);
-
-    // Proměnná pro výšky mřížky textu
-    // a její získání
-    uint16_t textGridHeight = getByte();
-    textGridHeight += (getByte() * BYTE_OVERFLOW);
-    // Tisk výšky mřížky textu
-    // fprintf(stderr, "INFO: Text grid height: %d\n", textGridHeight);
-
-    // Proměnná pro šířku buňky textu
-    // a její získání
-    uint8_t characterCellWidth = getByte();
-    // Tisk šířky buňky textu
-    // fprintf(stderr, "INFO: Character cell width: %d\n", characterCellWidth);
-
-    // Proměnná pro výšku buňky textu
-    // a její získání
-    uint8_t characterCellHeight = getByte();
-    // Tisk výšky buňky textu
-    // fprintf(stderr, "INFO: Character cell height: %d\n", characterCellHeight);
-
-    // Proměnná pro index barvy popředí textu
-    // a jeho získání
-    uint8_t textForegroundColorIndex = getByte();
-    // Tisk indexu barvy popředí textu
-    // fprintf(stderr, "INFO: Text foreground color index: %d\n", textForegroundColorIndex);
-
-    // Proměnná pro index barvy pozadí textu
-    // a jeho získání
-    uint8_t textBackgroundColorIndex = getByte();
-    // Tisk indexu barvy pozadí textu
-    // fprintf(stderr, "INFO: Text background color index: %d\n", textBackgroundColorIndex);
+    // Mřížka textu, buňky a barvy textu se nevykreslují, hlavička
+    // se jen přeskočí
 
     // Získání velikosti bloku s daty textu
-    blockSize = getByte();
+    blockSize = getByte(context);
     // Tisk velikosti bloku s daty textu
     // fprintf(stderr, "INFO: Plain text data size: %d\n", blockSize);
     // Tisk nadpisu pro uložený text
@@ -1374,16 +2689,15 @@ void processPlainTextBlock() {
 
     // Dokud pokračuje blok s daty
     while(blockSize > 0) {
-        // Projdi všechny bajty bloku
-        for(uint8_t blockIndex = 0; blockIndex < blockSize; blockIndex++) {
-            // Načti a vytiskni znak v bajtu
-            // fprintf(stderr, "%c", getByte());
-            getByte();
+        // Přeskoč všechny bajty bloku
+        // fprintf(stderr, "%.*s", blockSize, getBytes(blockSize));
+        if(skipBytes(context, (size_t)blockSize) != RETURN_SUCCESS) {
+            return RETURN_FAILURE;
         }
 
         // Zjisti novou velikost bloku,
         // popř. načti ukončující bajt bloku
-        blockSize = getByte();
+        blockSize = getByte(context);
 
         // Pokud se nejedná o ukončující bajt bloku
         if(blockSize != BLOCK_TERMINATOR) {
@@ -1397,56 +2711,50 @@ void processPlainTextBlock() {
             // fprintf(stderr, "INFO: Plain text block terminator\n");
         }
     }
+
+    // Navrácení stavu (EOF při předčasném konci souboru)
+    return (blockSize == EOF) ? RETURN_FAILURE : RETURN_SUCCESS;
 }
 
 /*
  * Funkce pro zpracování bloku rozšíření aplikace
+ *
+ * Návratová hodnota:
+ *      0 - blok byl zpracován
+ *     -1 - předčasný konec souboru
  */
-void processApplicationBlock() {
+int processApplicationBlock(tGIF2BMPContext *context) {
     // Tisk informace o zpracovávání bloku aplikace
     // fprintf(stderr, "INFO: Application\n");
 
     // Proměnná pro velikost bloku
     // a její získání
-    uint8_t blockSize = getByte();
+    int blockSize = getByte(context);
     // Tisk velikosti bloku
     // fprintf(stderr, "INFO: Block size: %d\n", blockSize);
 
-    // Tisk návěští identifikátoru aplikace
-    // fprintf(stderr, "INFO: Application identifier: ");
-    // Procházení identifikátoru aplikace
-    for(uint8_t idIndex = 0; idIndex < APPLICATION_IDENTIFIER_LENGTH; idIndex++) {
-        // Tisk jednoho znaku identifikátoru
-        // fprintf(stderr, "%c", getByte());
-        getByte();
-    }
-    // Zalomení identifikátoru aplikace
-    // fprintf(stderr, "\n");
-
+    // Tisk identifikátoru aplikace
+    // fprintf(stderr, "INFO: Application identifier: %.*s\n", APPLICATION_IDENTIFIER_LENGTH, getBytes(APPLICATION_IDENTIFIER_LENGTH));
     // Tisk authentication kódu aplikace
-    // fprintf(stderr, "INFO: Application authentication Code: ");
-    // Procházení kódu aplikace
-    for(uint8_t codeIndex = 0; codeIndex < APPLICATION_CODE_LENGTH; codeIndex++) {
-        // fprintf(stderr, "%c", getByte());
-        getByte();
+    // fprintf(stderr, "INFO: Application authentication Code: %.*s\n", APPLICATION_CODE_LENGTH, getBytes(APPLICATION_CODE_LENGTH));
+    // Přeskočení identifikátoru a kódu aplikace
+    if(blockSize == EOF || skipBytes(context, APPLICATION_IDENTIFIER_LENGTH + APPLICATION_CODE_LENGTH) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
     }
-    // Zalomení kódu aplikace
-    // fprintf(stderr, "\n");
 
     // Získání velikosti bloku s daty aplikace
-    blockSize = getByte();
+    blockSize = getByte(context);
 
     // Dokud pokračuje blok s daty
     while(blockSize > 0) {
-        // Projdi všechny bajty dat aplikace
-        for(uint8_t blockIndex = 0; blockIndex < blockSize; blockIndex++) {
-            // Načti jeden bajt dat
-            getByte();
+        // Přeskoč všechny bajty dat aplikace
+        if(skipBytes(context, (size_t)blockSize) != RETURN_SUCCESS) {
+            return RETURN_FAILURE;
         }
 
         // Zjisti novou velikost bloku,
         // popř. načti ukončující bajt bloku
-        blockSize = getByte();
+        blockSize = getByte(context);
 
         // Pokud se nejedná o ukončující bajt bloku
         if(blockSize != BLOCK_TERMINATOR) {
@@ -1458,24 +2766,39 @@ void processApplicationBlock() {
             // fprintf(stderr, "INFO: Application block terminator\n");
         }
     }
+
+    // Navrácení stavu (EOF při předčasném konci souboru)
+    return (blockSize == EOF) ? RETURN_FAILURE : RETURN_SUCCESS;
 }
 
 /*
  * Funkce pro zpracování části souboru s bloky
+ *
+ * Návratová hodnota:
+ *      0 - bloky byly zpracovány
+ *     -1 - chyba při zpracování bloků
  */
-void processBlocks() {
+int processBlocks(tGIF2BMPContext *context) {
     // Proměnná pro označení typu bloku
-    uint8_t blockLabel;
+    int blockLabel;
+    // Proměnná pro výsledek zpracování bloku
+    int result = RETURN_SUCCESS;
+    // Pozice vstupu za označením bloku rozšíření
+    uint64_t extensionOffset;
     // Proměnná pro zavaděč/oddělovač bloku
     // a jeho získání
-    uint8_t blockSeparator = getByte();
+    int blockSeparator = getByte(context);
 
     // Dokud nejsem na konci souboru
     while(blockSeparator != TRAILER) {
+        // Předčasný konec souboru
+        if(blockSeparator == EOF) {
+            return RETURN_FAILURE;
+        }
         // Pokud se jedná o blok s obrazovými daty
         if(blockSeparator == IMAGE_BLOCK_ID) {
             // Zpracuji obrazová data
-            processImageBlock(inputGIFFile);
+            result = processImageBlock(context);
         } else if (blockSeparator == EXTENSION_BLOCK_ID) {
             // Pokud se jedná o blok s rozšířením
 
@@ -1483,32 +2806,39 @@ void processBlocks() {
             // fprintf(stderr, "INFO: Extension block: ");
 
             // Získání označení rozšíření
-            blockLabel = getByte();
+            blockLabel = getByte(context);
+
+            // Předčasný konec souboru
+            if(blockLabel == EOF) {
+                return RETURN_FAILURE;
+            }
+            // Začátek obsahu bloku rozšíření
+            extensionOffset = context->input.offset;
 
             // Podle označení zpracuj blok rozšíření
             switch(blockLabel) {
                 // Blok s graphic control
                 case GRAPHIC_CONTROL_BLOCK_ID: {
                     // Zpracuj graphic control blok
-                    processGraphicControlBlock(inputGIFFile);
+                    result = processGraphicControlBlock(context);
                     break;
                 }
                 // Blok s komentářem
                 case COMMENT_BLOCK_ID: {
                     // Zpracuj blok komentáře
-                    processCommentBlock(inputGIFFile);
+                    result = processCommentBlock(context);
                     break;
                 }
                 // Blok prostého textu
                 case PLAIN_TEXT_BLOCK_ID: {
                     // Zpracuj blok prostého textu
-                    processPlainTextBlock(inputGIFFile);
+                    result = processPlainTextBlock(context);
                     break;
                 }
                 // Blok aplikace
                 case APPLICATION_BLOCK_ID: {
                     // Zpracuj blok aplikace
-                    processApplicationBlock(inputGIFFile);
+                    result = processApplicationBlock(context);
                     break;
                 }
                 // Neočekávané označení bloku rozšíření
@@ -1516,9 +2846,14 @@ void processBlocks() {
                     // Tisk informace o neočekávaném označení bloku rozšiření
                     fprintf(stderr, "ERROR: Unknown extension label: %x.\n", blockLabel);
                     // Ukončení funkce
-                    return;
+                    return RETURN_SUCCESS;
                 }
             }
+            // Obsah ostatních bloků rozšíření než graphic control se
+            // pouze přeskakuje
+            if(blockLabel != GRAPHIC_CONTROL_BLOCK_ID) {
+                context->stats.skippedBytes += context->input.offset - extensionOffset;
+            }
         } else {
             // Pokud se nejedná o blok obrazových dat nebo rozšíření,
             // tiskni o tom informaci
@@ -1527,89 +2862,461 @@ void processBlocks() {
             break;
         }
 
+        // Pokud zpracování bloku selhalo, končí se
+        if(result != RETURN_SUCCESS) {
+            return RETURN_FAILURE;
+        }
+
         // Načti další zavaděč/oddělovač bloku
-        blockSeparator = getByte();
+        blockSeparator = getByte(context);
     }
+
+    // Bloky byly zpracovány
+    return RETURN_SUCCESS;
 }
 
 /*
- * Funkce pro převod GIF na BMP
+ * Funkce pro přípravu nového převodu bez přeskakování bloků
+ *
+ * Uvolní výsledky dosavadního převodu, vynuluje jeho stav a vrátí vstup
+ * za signaturu souboru. Nastavení, jádra převodu a soubory zůstávají.
+ *
+ * Návratová hodnota:
+ *      0 - převod lze opakovat
+ *     -1 - vstup nelze vrátit
+ */
+int restartConversion(tGIF2BMPContext *context) {
+    // Zachovávané položky kontextu
+    tGIF2BMPOptions options = context->options;
+    tExpandKernels expandKernels = context->expandKernels;
+    tGIFInput input = context->input;
+    FILE *outputBMPFile = context->outputBMPFile;
+    uint8_t *outputBuffer = context->outputBuffer;
+    size_t outputCapacity = context->outputCapacity;
+    tGIF2BMP stats = context->stats;
+
+    // Návrat vstupu na začátek a přeskočení signatury
+    if(rewindGIFInput(&input) != RETURN_SUCCESS || skipInputBytes(&input, GIF_SIGNATURE_LENGTH) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+
+    // Paměť dosavadního průchodu zůstává v záznamu o převodu
+    stopFrames(context);
+    updateMemoryStats(context);
+    stats = context->stats;
+
+    // Uvolnění výsledků dosavadního převodu
+    freeBMPData(context);
+    free(context->globalColorTable);
+    free(context->localColorTable);
+    freeGIFScan(&context->scan);
+
+    // Vynulování stavu převodu a obnovení zachovávaných položek
+    memset(context, 0, sizeof(tGIF2BMPContext));
+    context->options = options;
+    context->expandKernels = expandKernels;
+    context->input = input;
+    context->outputBMPFile = outputBMPFile;
+    context->outputBuffer = outputBuffer;
+    context->outputCapacity = outputCapacity;
+    // Časy fází se sčítají, čítače popisují jen nový průchod
+    context->stats.headerTime = stats.headerTime;
+    context->stats.decodeTime = stats.decodeTime;
+    context->stats.composeTime = stats.composeTime;
+    context->stats.writeTime = stats.writeTime;
+    context->stats.canvasPeak = stats.canvasPeak;
+    context->stats.peakMemory = stats.peakMemory;
+    // Nový převod dekóduje všechny bloky
+    context->frameSkipDisabled = FLAG_TRUE;
+
+    // Převod lze opakovat
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro inicializaci kontextu převodu
+ *
+ * context - kontext převodu (obsah se přepíše)
+ * options - nastavení převodu (NULL pro výchozí nastavení)
+ */
+void initConversion(tGIF2BMPContext *context, const tGIF2BMPOptions *options) {
+    // Vynulování kontextu (každý převod začíná od počátečního stavu)
+    memset(context, 0, sizeof(tGIF2BMPContext));
+    // Uložení nastavení převodu (bez nastavení zůstávají výchozí hodnoty)
+    if(options != NULL) {
+        context->options = *options;
+    }
+    // Výběr jader převodu indexů na barvy podle schopností procesoru
+    selectExpandKernels(&context->expandKernels, EXPAND_KERNEL_AVX2);
+}
+
+/*
+ * Funkce pro převod otevřeného vstupu na výstup kontextu
+ *
+ * Vstup se po převodu uzavře a uvolní se všechny prostředky převodu
+ * kromě výstupního bufferu v paměti.
  *
+ * context - kontext převodu s otevřeným vstupem a nastaveným výstupem
+ * gif2bmp - záznam o převodu
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě,
+ *          příp. nepodporuje daný formát GIF
+ */
+int runConversion(tGIF2BMPContext *context, tGIF2BMP *gif2bmp) {
+    // Začátek měřené fáze převodu a čas skládání před zpracováním bloků
+    double phaseStart;
+    double composeTime;
+
+    // Čtení hlavičky se měří od kontroly signatury
+    phaseStart = getMonotonicTime();
+    // Kontrola signatury vstupního souboru
+    if(checkGIFSignature(context) != RETURN_SUCCESS) {
+        // Uzavření vstupu
+        closeGIFInput(&context->input);
+        return RETURN_FAILURE;
+    }
+
+    // Získání informací z hlavičky vstupního souboru, kontrola velikosti
+    // výstupního souboru, vytvoření globální tabulky barev (pokud je v souboru),
+    // předběžný průchod bloky, alokace výsledných barev výstupního
+    // souboru a zpracování bloků souboru
+    while(getGIFInfo(context) == RETURN_SUCCESS && checkBMPFileSize(context) == RETURN_SUCCESS &&
+          (context->info.gctFlag != FLAG_TRUE || makeGCT(context) == RETURN_SUCCESS) &&
+          scanFrames(context) == RETURN_SUCCESS && allocBMPData(context) == RETURN_SUCCESS &&
+          startStreamRows(context) == RETURN_SUCCESS) {
+        // Konec čtení hlavičky, zpracování bloků bez času skládání
+        context->stats.headerTime += getMonotonicTime() - phaseStart;
+        phaseStart = getMonotonicTime();
+        composeTime = context->stats.composeTime;
+        // Pokud byly zpracovány všechny bloky, zapíší se získaná data
+        if(processBlocks(context) == RETURN_SUCCESS) {
+            context->stats.decodeTime += getMonotonicTime() - phaseStart - (context->stats.composeTime - composeTime);
+            // Zápis získaných dat do výstupního souboru
+            phaseStart = getMonotonicTime();
+            writeBMPData(context, &context->stats);
+            context->stats.writeTime += getMonotonicTime() - phaseStart;
+            break;
+        }
+        context->stats.decodeTime += getMonotonicTime() - phaseStart - (context->stats.composeTime - composeTime);
+        // Pokud přeskočený blok nebyl překryt, převod se opakuje od začátku
+        // bez přeskakování bloků, jinak převod končí chybou
+        phaseStart = getMonotonicTime();
+        if(context->frameSkipFailed != FLAG_TRUE || context->error != RETURN_SUCCESS ||
+           restartConversion(context) != RETURN_SUCCESS) {
+            break;
+        }
+    }
+
+    // Zastavení paralelního dekodéru (jeho buffery se započtou do paměti)
+    stopFrames(context);
+
+    // Uložení záznamu o převodu včetně velikosti GIF souboru pro log
+    if(gif2bmp != NULL) {
+        context->stats.frames = context->imageBlockNumber;
+        context->stats.gifSize = context->input.offset;
+        context->stats.width = context->info.imageWidth;
+        context->stats.height = context->info.imageHeight;
+        context->stats.gctSize = (context->info.gctFlag == FLAG_TRUE) ? context->info.gctSize : 0;
+        updateMemoryStats(context);
+        *gif2bmp = context->stats;
+    }
+
+    // Uzavření vstupu
+    closeGIFInput(&context->input);
+
+    // Uvolnění paměti po tabulce výsledných barev výstupního souboru
+    freeBMPData(context);
+
+    // Pokud existuje globální tabulka barev
+    if(context->globalColorTable != NULL) {
+        // Uvolnění prostoru po globální tabulce barev,
+        free(context->globalColorTable);
+        context->globalColorTable = NULL;
+    }
+
+    // Uvolnění výsledku předběžného průchodu
+    freeGIFScan(&context->scan);
+
+    // Návratová hodnota funkce
+    return context->error;
+}
+
+/*
+ * Funkce pro převod GIF na BMP s explicitním kontextem
+ *
+ * context    - kontext převodu (obsah se přepíše, nemusí být inicializován)
  * gif2bmp    - záznam o převodu
  * inputFile  - vstupní soubor (GIF)
  * outputFile - výstupní soubor (BMP)
+ * options    - nastavení převodu (NULL pro výchozí nastavení)
  *
  * Návratová hodnota:
  *      0 - převod proběhl v pořádku
  *     -1 - při převodu došlo k chybě,
  *          příp. nepodporuje daný formát GIF
  */
-int gif2bmp(tGIF2BMP *gif2bmp, FILE *inputFile, FILE *outputFile) {
+int gif2bmpContext(tGIF2BMPContext *context, tGIF2BMP *gif2bmp, FILE *inputFile, FILE *outputFile, const tGIF2BMPOptions *options) {
     // Testovací tisk pro správné připojení knihovny
     // fprintf(stderr, "INFO: gif2bmp library linked\n");
 
-    // Nastavení globálního vstupního souboru
-    inputGIFFile = inputFile;
-    // Nastavení globálního výstupního souboru
-    outputBMPFile = outputFile;
+    // Inicializace kontextu s nastavením převodu
+    initConversion(context, options);
 
-    // Kontrola signatury vstupního souboru
-    if(checkGIFSignature() != RETURN_SUCCESS) {
+    // Otevření vstupu nad vstupním souborem
+    if(openGIFInput(&context->input, inputFile) != RETURN_SUCCESS) {
         return RETURN_FAILURE;
     }
+    // Nastavení výstupního souboru
+    context->outputBMPFile = outputFile;
+
+    // Převod vstupu na výstup
+    return runConversion(context, gif2bmp);
+}
+
+/*
+ * Funkce pro převod GIF v paměti na BMP v paměti s explicitním kontextem
+ *
+ * Data GIF se čtou přímo z paměti volajícího bez kopírování. BMP se zapíše
+ * do bufferu volajícího (*bmpData není NULL, *bmpLength je jeho velikost),
+ * nebo do bufferu alokovaného knihovnou přesně pro celý BMP soubor
+ * (*bmpData je NULL, volající jej uvolní funkcí free).
+ *
+ * context   - kontext převodu (obsah se přepíše, nemusí být inicializován)
+ * gif2bmp   - záznam o převodu
+ * gifData   - data GIF souboru
+ * gifLength - délka dat GIF souboru
+ * bmpData   - buffer pro BMP soubor (po úspěšném převodu jeho začátek)
+ * bmpLength - velikost bufferu volajícího, po úspěšném převodu velikost
+ *             BMP souboru, při malém bufferu potřebná velikost
+ * options   - nastavení převodu (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě (buffer alokovaný knihovnou
+ *          se uvolní), příp. nepodporuje daný formát GIF
+ */
+int gif2bmpMemoryContext(tGIF2BMPContext *context, tGIF2BMP *gif2bmp, const uint8_t *gifData, size_t gifLength,
+                         uint8_t **bmpData, size_t *bmpLength, const tGIF2BMPOptions *options) {
+    // Proměnná pro výsledek převodu
+    int result;
+
+    // Inicializace kontextu s nastavením převodu
+    initConversion(context, options);
+    // Otevření vstupu nad daty v paměti
+    openGIFMemoryInput(&context->input, gifData, gifLength);
+    // Výstup do bufferu volajícího, příp. do bufferu alokovaného při zápisu
+    context->outputBuffer = *bmpData;
+    context->outputCapacity = (*bmpData != NULL) ? *bmpLength : 0;
+
+    // Převod vstupu na výstup
+    result = runConversion(context, gif2bmp);
+
+    // Předání zapsaného BMP souboru
+    if(result == RETURN_SUCCESS) {
+        *bmpData = context->outputBuffer;
+        *bmpLength = context->outputLength;
+        return RETURN_SUCCESS;
+    }
+    // Při chybě se uvolní buffer alokovaný knihovnou
+    if(context->outputAllocated == FLAG_TRUE) {
+        free(context->outputBuffer);
+    }
+    // Malý buffer volajícího - potřebná velikost
+    if(context->outputAllocated != FLAG_TRUE && context->outputRequired > context->outputCapacity) {
+        *bmpLength = context->outputRequired;
+    }
+    return RETURN_FAILURE;
+}
 
-    // Získání informací z hlavičky vstupního souboru
-    getGIFInfo();
+/*
+ * Funkce pro převod GIF na BMP s nastavením
+ *
+ * gif2bmp    - záznam o převodu
+ * inputFile  - vstupní soubor (GIF)
+ * outputFile - výstupní soubor (BMP)
+ * options    - nastavení převodu (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě,
+ *          příp. nepodporuje daný formát GIF
+ */
+int gif2bmpOptions(tGIF2BMP *gif2bmp, FILE *inputFile, FILE *outputFile, const tGIF2BMPOptions *options) {
+    // Kontext převodu (vlastní pro každé volání)
+    tGIF2BMPContext *context = (tGIF2BMPContext*)malloc(sizeof(tGIF2BMPContext));
+    // Proměnná pro výsledek převodu
+    int result = RETURN_FAILURE;
 
-    // Tisk informací z hlavičky vstupního souboru
-    // fprintf(stderr, "INFO: Image width: %d\n", info.imageWidth);
-    // fprintf(stderr, "INFO: Image height: %d\n", info.imageHeight);
-    // fprintf(stderr, "INFO: Global color table flag: %d\n", info.gctFlag);
-    // fprintf(stderr, "INFO: Bits per pixel: %d\n", info.bpp);
-    // fprintf(stderr, "INFO: Global color table sort flag: %d\n", info.gctSortFlag);
-    // fprintf(stderr, "INFO: Global color table size: %d\n", info.gctSize);
-    // fprintf(stderr, "INFO: Background color index: %d\n", info.bgColorIndex);
-    // fprintf(stderr, "INFO: Pixel aspect ratio: %d\n", info.paRatio);
+    // Kontrola alokace
+    if(context == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: context malloc failed.\n");
+        return RETURN_FAILURE;
+    }
 
-    // Pokud je v souboru globální tabulka barev
-    if(info.gctFlag == FLAG_TRUE) {
-        // Vytvoření globální tabulky barev
-        makeGCT();
+    // Převod s vlastním kontextem
+    result = gif2bmpContext(context, gif2bmp, inputFile, outputFile, options);
 
-        // Tisk nadpisu globální tabulky barev
-        // fprintf(stderr, "INFO: Global color table:\n");
+    // Uvolnění kontextu
+    free(context);
 
-        // Výpis barev v globální tabulce
-        for(uint16_t gctIndex = 0; gctIndex < info.gctSize; gctIndex++) {
-            // Tisk jedné barvy v tabulce
-            // fprintf(stderr, "INFO: %3d: %02x%02x%02x\n", gctIndex, globalColorTable[gctIndex].r, globalColorTable[gctIndex].g, globalColorTable[gctIndex].b);
-        }
+    // Návratová hodnota funkce
+    return result;
+}
+
+/*
+ * Funkce pro převod GIF v paměti na BMP v paměti
+ *
+ * gif2bmp   - záznam o převodu
+ * gifData   - data GIF souboru
+ * gifLength - délka dat GIF souboru
+ * bmpData   - buffer pro BMP soubor (NULL - alokuje knihovna)
+ * bmpLength - velikost bufferu volajícího, po převodu velikost BMP souboru
+ * options   - nastavení převodu (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě,
+ *          příp. nepodporuje daný formát GIF
+ */
+int gif2bmpMemory(tGIF2BMP *gif2bmp, const uint8_t *gifData, size_t gifLength,
+                  uint8_t **bmpData, size_t *bmpLength, const tGIF2BMPOptions *options) {
+    // Kontext převodu (vlastní pro každé volání)
+    tGIF2BMPContext *context = (tGIF2BMPContext*)malloc(sizeof(tGIF2BMPContext));
+    // Proměnná pro výsledek převodu
+    int result = RETURN_FAILURE;
+
+    // Kontrola alokace
+    if(context == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: context malloc failed.\n");
+        return RETURN_FAILURE;
     }
 
-    // Alokace tabulky výsledných barev výstupního souboru
-    allocBMPData();
+    // Převod s vlastním kontextem
+    result = gif2bmpMemoryContext(context, gif2bmp, gifData, gifLength, bmpData, bmpLength, options);
+
+    // Uvolnění kontextu
+    free(context);
 
-    // Zpracování bloků souboru
-    processBlocks();
+    // Návratová hodnota funkce
+    return result;
+}
+
+/*
+ * Funkce pro zjištění informací o GIF souboru bez dekódování s explicitním
+ * kontextem
+ *
+ * context   - kontext převodu (obsah se přepíše, nemusí být inicializován)
+ * probe     - zjištěné informace (obsah se přepíše)
+ * inputFile - vstupní soubor (GIF)
+ *
+ * Návratová hodnota:
+ *      0 - celý soubor byl zpracován
+ *     -1 - chybný nebo zkrácený soubor (probe obsahuje bloky před chybou)
+ */
+int gif2bmpProbeContext(tGIF2BMPContext *context, tGIFProbe *probe, FILE *inputFile) {
+    // Proměnná pro výsledek průchodu
+    int result = RETURN_FAILURE;
+
+    // Inicializace kontextu s výchozím nastavením a prázdných informací
+    initConversion(context, NULL);
+    memset(probe, 0, sizeof(tGIFProbe));
+    // Image bloky se budou jen popisovat
+    context->probe = probe;
+
+    // Otevření vstupu nad vstupním souborem
+    if(openGIFInput(&context->input, inputFile) != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
 
-    // Zápis získaných dat do výstupního souboru
-    writeBMPData(gif2bmp);
+    // Kontrola signatury a získání informací z hlavičky
+    if(checkGIFSignature(context) == RETURN_SUCCESS && getGIFInfo(context) == RETURN_SUCCESS) {
+        // Uložení informací z hlavičky
+        probe->width = context->info.imageWidth;
+        probe->height = context->info.imageHeight;
+        probe->gctSize = (context->info.gctFlag == FLAG_TRUE) ? context->info.gctSize : 0;
+        probe->bgColorIndex = context->info.bgColorIndex;
+        // Přeskočení globální tabulky barev a průchod bloky
+        if(skipBytes(context, (size_t)probe->gctSize * ONE_PIXEL_SIZE) == RETURN_SUCCESS) {
+            result = processBlocks(context);
+        }
+    }
 
-    // Uložení velikosti GIF souboru pro log
-    if(gif2bmp != NULL) gif2bmp->gifSize = gifSize;
+    // Příznak úspěšného průchodu a počet přečtených bajtů
+    probe->complete = (result == RETURN_SUCCESS && context->error == RETURN_SUCCESS) ? FLAG_TRUE : FLAG_FALSE;
+    probe->gifSize = context->input.offset;
 
-    // Tisk velikost BMP souboru
-    // fprintf(stderr, "INFO: %"PRIu64"\n", gif2bmp->bmpSize);
+    // Uzavření vstupu
+    closeGIFInput(&context->input);
 
-    // Uvolnění paměti po tabulce výsledných indexů výstupního souboru
-    freeBMPData();
+    // Návratová hodnota funkce
+    return (probe->complete == FLAG_TRUE) ? RETURN_SUCCESS : RETURN_FAILURE;
+}
 
-    // Pokud existuje globální tabulka barev
-    if(globalColorTable != NULL) {
-        // Uvolnění prostoru po globální tabulce barev,
-        free(globalColorTable);
+/*
+ * Funkce pro zjištění informací o GIF souboru bez dekódování
+ *
+ * probe     - zjištěné informace
+ * inputFile - vstupní soubor (GIF)
+ *
+ * Návratová hodnota:
+ *      0 - celý soubor byl zpracován
+ *     -1 - chybný nebo zkrácený soubor, příp. chyba alokace
+ */
+int gif2bmpProbe(tGIFProbe *probe, FILE *inputFile) {
+    // Kontext průchodu (vlastní pro každé volání)
+    tGIF2BMPContext *context = (tGIF2BMPContext*)malloc(sizeof(tGIF2BMPContext));
+    // Proměnná pro výsledek průchodu
+    int result = RETURN_FAILURE;
+
+    // Kontrola alokace
+    if(context == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: context malloc failed.\n");
+        // Informace zůstanou prázdné
+        memset(probe, 0, sizeof(tGIFProbe));
+        return RETURN_FAILURE;
     }
 
+    // Průchod s vlastním kontextem
+    result = gif2bmpProbeContext(context, probe, inputFile);
+
+    // Uvolnění kontextu
+    free(context);
+
     // Návratová hodnota funkce
-    return RETURN_SUCCESS;
+    return result;
+}
+
+/*
+ * Funkce pro uvolnění zjištěných informací o GIF souboru
+ *
+ * probe - zjištěné informace
+ */
+void freeGIFProbe(tGIFProbe *probe) {
+    // Uvolnění popisů bloků
+    free(probe->frames);
+    probe->frames = NULL;
+    probe->frameCount = 0;
+    probe->frameCapacity = 0;
+}
+
+/*
+ * Funkce pro převod GIF na BMP
+ *
+ * gif2bmp    - záznam o převodu
+ * inputFile  - vstupní soubor (GIF)
+ * outputFile - výstupní soubor (BMP)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě,
+ *          příp. nepodporuje daný formát GIF
+ */
+int gif2bmp(tGIF2BMP *gif2bmp, FILE *inputFile, FILE *outputFile) {
+    // Převod s výchozím nastavením
+    return gif2bmpOptions(gif2bmp, inputFile, outputFile, NULL);
 }
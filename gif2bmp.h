@@ -13,8 +13,17 @@
 *                                                                              *
 *******************************************************************************/
 
+#ifndef GIF2BMP_H
+#define GIF2BMP_H
+
 #include <stdio.h>
 #include <stdint.h>
+#include "gifinput.h"
+#include "expand.h"
+#include "gifscan.h"
+#include "lzwbits.h"
+#include "framedecode.h"
+#include "canvas.h"
 
 // Login autora
 #define LOGIN "xkubis03"
@@ -32,6 +41,14 @@
 #define GIF_SIGNATURE "GIF89a"
 // Délka podporované signatury knihovny
 #define GIF_SIGNATURE_LENGTH 6
+// Velikost popisu logické obrazovky za signaturou
+#define LOGICAL_SCREEN_DESCRIPTOR_SIZE 7
+// Velikost popisu image bloku za oddělovačem
+#define IMAGE_DESCRIPTOR_SIZE 9
+// Velikost bloku graphic control včetně velikosti a ukončujícího bajtu
+#define GRAPHIC_CONTROL_BLOCK_SIZE 6
+// Velikost hlavičky bloku plain text včetně bajtu velikosti
+#define PLAIN_TEXT_BLOCK_SIZE 13
 // AND hodnota pro získání příznaku tabulky barev
 #define AND_OF_COLOR_TABLE_FLAG 128
 // AND hodnota pro získání počtu bitů na pixel
@@ -74,10 +91,16 @@
 #define APPLICATION_CODE_LENGTH 3
 // Ukončovací bajt GIF souboru
 #define TRAILER 0x3b
-// Velikost, o kterou se zvětšuje pole indexů v položce tabulky barev
-#define ITEM_ALLOC_SIZE    8
-// Velikost, o kterou se zvětšuje pole položek tabulky barev
-#define TABLE_ALLOC_SIZE 256
+// Počet bitů v jednom bajtu (největší minimální velikost LZW kódu)
+#define BYTE_BITS 8
+// Maximální velikost LZW kódu v bitech
+#define LZW_MAX_CODE_SIZE 12
+// Počet položek slovníku LZW (2^12)
+#define LZW_TABLE_SIZE 4096
+// Výsledky dekódování LZW dat bloku
+#define LZW_DECODE_OK 0
+#define LZW_DECODE_INVALID_FIRST 1
+#define LZW_DECODE_INVALID_CODE 2
 // Násobek pro dorovnání řádku výstupního souboru
 #define ROW_MULT_SIZE 4
 // Identifikátor BMP souboru
@@ -86,14 +109,28 @@
 #define BITMAPFILEHEADER_SIZE 14
 // Velikost informační BMP hlavičky
 #define BITMAPINFOHEADER_SIZE 40
+// Celková velikost hlaviček BMP souboru
+#define BMP_HEADER_SIZE (BITMAPFILEHEADER_SIZE + BITMAPINFOHEADER_SIZE)
 // Velikost položky tabulky barev BMP souboru
 #define BMP_COLOR_SIZE 4
+// Největší velikost BMP souboru (velikost v hlavičce má 32 bitů)
+#define BMP_MAX_FILE_SIZE UINT32_MAX
 // Hodnota rezervovaných položek hlavičky
 #define RESERVED_VALUE 0x0
 // Hodnota bitový rovin výstupního zařízení
 #define BI_PLANES_VALUE 0x1
 // Počet bitů na pixel ve výstupním souboru
 #define BIT_COUNT 24
+// Počty bitů na pixel paletového výstupu
+#define PALETTE_BIT_COUNT_1 1
+#define PALETTE_BIT_COUNT_4 4
+#define PALETTE_BIT_COUNT_8 8
+// Největší počet barev palety (tabulky barev GIF)
+#define PALETTE_MAX_SIZE 256
+// Počáteční počet popisů bloků při zjišťování informací o souboru
+#define GIF_PROBE_ALLOC_SIZE 16
+// Velikost bloku řádků převáděných a zapisovaných najednou
+#define BMP_WRITE_BLOCK_SIZE (1024 * 1024)
 // Identifikátor metody komprese
 #define COMPRESSION_METHOD 0x0
 // Hodnota pro ANO při prvním bajtu nového bloku za clear kódem
@@ -110,6 +147,8 @@
 #define STATE2 2
 // Stav pro čtvrtý blok prokládání 2n+1
 #define STATE3 3
+// Největší počet řádků bloku (výška bloku je 16bitová)
+#define ROW_MAP_SIZE 65536
 
 /*
  * Struktura pro uložení jedné barvy v RGB
@@ -151,42 +190,471 @@ typedef struct {
     uint8_t paRatio;
 } tGIFInfo;
 
+/*
+ * Struktura pro sestavení hlavičky BMP souboru v paměti
+ *
+ * bytes - bajty hlavičky (BITMAPFILEHEADER + BITMAPINFOHEADER)
+ * used  - počet již sestavených bajtů
+ */
+typedef struct {
+    uint8_t bytes[BMP_HEADER_SIZE];
+    uint8_t used;
+} tBMPHeader;
+
 /*
  * Struktura pro uložení informací o převodu
  *
- * bmpSize - velikost dekódovaného souboru
- * gifSize - velikost kódovaného souboru
+ * Časy fází se měří monotónními hodinami v sekundách a při opakovaném
+ * převodu (bez přeskakování bloků) se sčítají, čítače popisují poslední
+ * průchod souborem.
+ *
+ * bmpSize          - velikost dekódovaného souboru
+ * gifSize          - velikost kódovaného souboru
+ * width            - šířka logické obrazovky
+ * height           - výška logické obrazovky
+ * gctSize          - počet barev globální tabulky (0 - bez tabulky)
+ * localTables      - počet image bloků s lokální tabulkou barev
+ * lctMaxSize       - počet barev největší lokální tabulky
+ * interlacedFrames - počet prokládaných image bloků
+ * headerTime       - čtení hlavičky, tabulky barev, předběžný průchod
+ *                    bloky a alokace obrazu
+ * decodeTime       - zpracování bloků bez skládání (při sekvenčním
+ *                    dekódování včetně ukládání pixelů do obrazu)
+ * composeTime      - skládání paralelně dekódovaných bloků do obrazu
+ *                    a slučování palet bloků
+ * writeTime        - převod obrazu na výstupní formát a zápis BMP
+ * codes            - počet načtených LZW kódů
+ * clearCodes       - počet clear kódů
+ * dictionaryResets - počet reinicializací slovníku LZW
+ * frames           - počet image bloků
+ * subBlocks        - počet dekódovaných sub-bloků obrazových dat
+ * skippedBytes     - počet přeskočených bajtů bloků rozšíření (komentář,
+ *                    prostý text, aplikace)
+ * canvasPeak       - největší počet současně alokovaných bajtů obrazových
+ *                    dat (pásy indexů a barev) ze všech průchodů souborem
+ * peakMemory       - nejvyšší paměť převodu v bajtech, součet nejvyššího
+ *                    obsazení obrazových dat (canvasPeak) a bufferů řádků
+ *                    a dekódovaných bloků, ze všech průchodů souborem
  */
 typedef struct {
   int64_t bmpSize;
   int64_t gifSize;
+  uint32_t width;
+  uint32_t height;
+  uint16_t gctSize;
+  uint32_t localTables;
+  uint16_t lctMaxSize;
+  uint32_t interlacedFrames;
+  double headerTime;
+  double decodeTime;
+  double composeTime;
+  double writeTime;
+  uint64_t codes;
+  uint64_t clearCodes;
+  uint64_t dictionaryResets;
+  uint32_t frames;
+  uint64_t subBlocks;
+  uint64_t skippedBytes;
+  uint64_t canvasPeak;
+  int64_t peakMemory;
 } tGIF2BMP;
 
 /*
- * Struktura pro uložení hodnot pixelů v tabulce barev od indexu 258
+ * Struktura slovníku LZW s pevnou velikostí 4096 položek
  *
- * allocated - počet alokovaných bajtů ve struktuře
- * used      - počet využitých bajtů ve struktuře
- * indexList - pole indexů do tabulky barev (0 - 255)
+ * Každý kód je uložen jako dvojice (prefix, suffix), tedy odkaz na kratší
+ * řetězec a jeden přidaný index barvy. Řetězec kódu se rozvine pozpátku
+ * do pole stack, takže dekódování nepotřebuje žádnou alokaci na kód.
+ *
+ * prefix - kód předchozího (kratšího) řetězce
+ * suffix - poslední index barvy řetězce
+ * first  - první index barvy řetězce
+ * length - délka řetězce v indexech barev
+ * stack  - pomocné pole pro rozvinutí řetězce (zápis pozpátku)
+ * used   - první volný kód ve slovníku
  */
 typedef struct {
-    uint32_t allocated;
+    uint16_t prefix[LZW_TABLE_SIZE];
+    uint8_t suffix[LZW_TABLE_SIZE];
+    uint8_t first[LZW_TABLE_SIZE];
+    uint16_t length[LZW_TABLE_SIZE];
+    uint8_t stack[LZW_TABLE_SIZE];
     uint32_t used;
-    uint8_t *indexList;
-} tItem;
+} tLZWTable;
+
+/*
+ * Typ výstupní funkce dekodéru LZW, které se předává každý rozvinutý
+ * řetězec indexů barev
+ *
+ * target - cíl předaný dekodéru
+ * colors - indexy barev řetězce
+ * count  - počet indexů barev řetězce
+ */
+typedef void (*tLZWOutputFunction)(void *target, const uint8_t *colors, uint32_t count);
 
 /*
- * Struktura pro uložení tabulky barev od indexu 258
+ * Struktura nastavení převodu
  *
- * allocated - počet alokovaných míst v tabulce
- * used      - počet využitých míst v tabulce
- * itemList  - pole položek tabulky
+ * palettized   - paletový výstup (8, 4 nebo 1 bit na pixel), pokud barvy
+ *                všech bloků tvoří nejvýše 256 barev, jinak 24 bitů
+ * frameThreads - počet vláken dekódování image bloků (0 nebo 1 - bloky
+ *                dekóduje převod sám)
+ * streaming    - průběžný zápis BMP s řádky shora dolů (záporná výška)
+ *                během dekódování, pokud soubor obsahuje jediný
+ *                neprokládaný blok přes celou logickou obrazovku (jinak
+ *                běžný zápis po dekódování); po chybě zápisu nebo
+ *                dekódování zůstanou ve výstupu již zapsané řádky
+ *                (neúplný soubor se nemaže ani nezkracuje)
+ * memoryLimit  - největší velikost obrazových dat v bajtech (0 - bez
+ *                omezení), při překročení převod skončí chybou
  */
 typedef struct {
-    uint32_t allocated;
-    uint32_t used;
-    tItem *itemList;
-} tTable;
+    uint8_t palettized;
+    unsigned frameThreads;
+    uint8_t streaming;
+    uint64_t memoryLimit;
+} tGIF2BMPOptions;
+
+/*
+ * Struktura popisu image bloku zjištěného bez dekódování
+ *
+ * left             - levá pozice bloku
+ * top              - horní pozice bloku
+ * width            - šířka bloku
+ * height           - výška bloku
+ * lctSize          - velikost lokální tabulky barev (0 - globální tabulka)
+ * interlaced       - příznak prokládaného bloku
+ * minimumCodeSize  - minimální velikost LZW kódu
+ * delay            - doba zobrazení bloku v setinách sekundy
+ * disposal         - způsob odstranění bloku (0 - bez bloku graphic control)
+ * transparentIndex - index průhledné barvy (-1 - bez průhledné barvy)
+ * dataSize         - počet bajtů LZW dat bloku (bez velikostí sub-bloků)
+ */
+typedef struct {
+    uint16_t left;
+    uint16_t top;
+    uint16_t width;
+    uint16_t height;
+    uint16_t lctSize;
+    uint8_t interlaced;
+    uint8_t minimumCodeSize;
+    uint16_t delay;
+    uint8_t disposal;
+    int16_t transparentIndex;
+    uint64_t dataSize;
+} tGIFProbeFrame;
+
+/*
+ * Struktura informací o GIF souboru zjištěných bez dekódování
+ *
+ * width         - šířka logické obrazovky
+ * height        - výška logické obrazovky
+ * gctSize       - velikost globální tabulky barev (0 - bez tabulky)
+ * bgColorIndex  - index barvy pozadí
+ * frames        - popisy image bloků v pořadí v souboru
+ * frameCount    - počet image bloků
+ * frameCapacity - počet bloků, pro které je alokováno místo
+ * gifSize       - počet přečtených bajtů souboru
+ * complete      - příznak úspěšného průchodu všemi bloky (průchod končí
+ *                 stejně jako převod ukončujícím bajtem nebo neznámým
+ *                 blokem)
+ */
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint16_t gctSize;
+    uint8_t bgColorIndex;
+    tGIFProbeFrame *frames;
+    uint32_t frameCount;
+    uint32_t frameCapacity;
+    uint64_t gifSize;
+    uint8_t complete;
+} tGIFProbe;
+
+/*
+ * Struktura kontextu jednoho převodu GIF na BMP
+ *
+ * Veškerý stav převodu je uložen v kontextu, takže lze současně provádět
+ * více převodů (např. v různých vláknech), každý s vlastním kontextem.
+ *
+ * options                  - nastavení převodu
+ * info                     - informace z hlavičky GIF souboru
+ * input                    - vstup knihovny nad vstupním souborem
+ * outputBMPFile            - výstupní soubor (NULL - výstup do bufferu)
+ * globalColorTable         - globální tabulka barev
+ * localColorTable          - lokální tabulka barev aktuálního bloku
+ * actualColorTable         - tabulka barev používaná aktuálním blokem
+ * actualColorTableSize     - velikost používané tabulky barev
+ * LZWMininumCodeSize       - minimální velikost LZW kódu aktuálního bloku
+ * lzwTable                 - slovník LZW
+ * dataBMP                  - jediný řádek barev BMP průběžného zápisu
+ * bmpRowWidth              - délka jednoho řádku 24bitového BMP včetně zarovnání
+ * bgrCanvas                - obrazová data BMP (řádky zdola nahoru, BGR),
+ *                            jen po převodu indexů na barvy
+ * indexCanvas              - indexy barev pixelů do palety obrazu
+ *                            (řádky shora dolů, bez pásů po převodu na barvy)
+ * canvasBudget             - rozpočet paměti obrazových dat
+ * bufferPeak               - největší počet bajtů současně alokovaných bufferů
+ *                            mimo obrazová data (řádek průběžného zápisu,
+ *                            buffery dekódovaných bloků, bloky řádků zápisu)
+ * expandKernels            - jádra převodu indexů na barvy vybraná podle
+ *                            schopností procesoru
+ * palette                  - paleta obrazu (tabulky barev všech bloků)
+ * paletteRemap             - převod indexů aktuálního bloku na indexy palety
+ * paletteSize              - počet barev palety (0 - zatím neurčena)
+ * paletteBlackIndex        - index černé barvy pro nevykreslené pixely
+ * paletteMaxIndex          - největší uložený index barvy
+ * paletteBlackMissing      - příznak palety bez černé barvy (první blok
+ *                            musí vykreslit celou logickou obrazovku)
+ * canvasCovered            - příznak vykreslení celé logické obrazovky
+ * nextPixelIndex           - index dalšího pixelu aktuálního bloku
+ * imageBlockNumber         - pořadí aktuálního image bloku
+ * blockTrasparentColorFlag - příznak průhledné barvy
+ * transparentColorIndex    - index průhledné barvy
+ * actualTop                - horní pozice aktuálního bloku
+ * actualLeft               - levá pozice aktuálního bloku
+ * actualWidth              - šířka aktuálního bloku
+ * actualHeight             - výška aktuálního bloku
+ * blockInterlaceFlag       - příznak prokládání aktuálního bloku
+ * blockColorTable          - tabulka barev bloku pro jádra převodu (jen
+ *                            při ukládání barev místo indexů)
+ * rowMap                   - řádky bloku v pořadí dekódování (podle
+ *                            průchodů prokládání nebo postupně)
+ * actualPixelCount         - počet pixelů aktuálního bloku
+ * actualVisibleWidth       - počet sloupců bloku uvnitř logické obrazovky
+ * actualRowNumber          - pořadí aktuálně dekódovaného řádku bloku
+ * actualColumn             - sloupec dalšího pixelu v aktuálním řádku
+ * actualRowData            - první pixel aktuálního řádku bloku v datech
+ *                            obrazu (NULL pro řádek mimo logickou obrazovku)
+ * subBlocksTerminated      - příznak načtení ukončujícího bajtu dat bloku
+ * scan                     - výsledek předběžného průchodu bloky
+ * scanOffset               - pozice vstupu, od které předběžný průchod četl
+ * skippedFrames            - počet přeskočených (překrytých) image bloků
+ * frameSkipDisabled        - příznak převodu bez přeskakování bloků
+ * frameSkipFailed          - příznak neúplného bloku, na jehož překrytí
+ *                            spoléhal přeskočený blok (převod se opakuje)
+ * frameDecoder             - paralelní dekodér image bloků (NULL - bloky
+ *                            se dekódují při převodu)
+ * actualFrame              - záznam aktuálního bloku z předběžného průchodu
+ *                            (NULL, pokud blok průchodu neodpovídá)
+ * stats                    - časy fází a čítače převodu pro záznam o převodu
+ * outputBuffer             - výstupní buffer v paměti (bez výstupního souboru)
+ * outputCapacity           - velikost výstupního bufferu
+ * outputLength             - počet zapsaných bajtů výstupního bufferu
+ * outputRequired           - velikost BMP souboru pro výstupní buffer
+ * outputAllocated          - příznak výstupního bufferu alokovaného knihovnou
+ * streaming                - příznak průběžného zápisu řádků (dataBMP je
+ *                            jediný řádek, hlavička je již zapsána)
+ * streamedRows             - počet již zapsaných řádků průběžného zápisu
+ * probe                    - informace o souboru zjišťované bez dekódování
+ *                            (NULL - převod)
+ * blockDelayTime           - doba zobrazení z posledního bloku graphic control
+ * blockDisposalMethod      - způsob odstranění z posledního bloku graphic
+ *                            control
+ * blockControlPending      - příznak bloku graphic control, který se ještě
+ *                            nevztáhl k žádnému image bloku
+ * error                    - stav převodu (0 - bez chyby, -1 - chyba)
+ */
+typedef struct {
+    tGIF2BMPOptions options;
+    tGIFInfo info;
+    tGIFInput input;
+    FILE *outputBMPFile;
+    tRGB *globalColorTable;
+    tRGB *localColorTable;
+    tRGB *actualColorTable;
+    uint16_t actualColorTableSize;
+    uint8_t LZWMininumCodeSize;
+    tLZWTable lzwTable;
+    uint8_t *dataBMP;
+    uint32_t bmpRowWidth;
+    tCanvas bgrCanvas;
+    tCanvas indexCanvas;
+    tCanvasBudget canvasBudget;
+    uint64_t bufferPeak;
+    tExpandKernels expandKernels;
+    tRGB palette[PALETTE_MAX_SIZE];
+    uint8_t paletteRemap[PALETTE_MAX_SIZE];
+    uint16_t paletteSize;
+    uint8_t paletteBlackIndex;
+    uint8_t paletteMaxIndex;
+    uint8_t paletteBlackMissing;
+    uint8_t canvasCovered;
+    uint32_t nextPixelIndex;
+    uint32_t imageBlockNumber;
+    uint8_t blockTrasparentColorFlag;
+    uint8_t transparentColorIndex;
+    uint32_t actualTop;
+    uint32_t actualLeft;
+    uint32_t actualWidth;
+    uint32_t actualHeight;
+    uint8_t blockInterlaceFlag;
+    uint32_t blockColorTable[PALETTE_MAX_SIZE];
+    uint16_t rowMap[ROW_MAP_SIZE];
+    uint32_t actualPixelCount;
+    uint32_t actualVisibleWidth;
+    uint32_t actualRowNumber;
+    uint32_t actualColumn;
+    uint8_t *actualRowData;
+    uint8_t subBlocksTerminated;
+    tGIFScan scan;
+    uint64_t scanOffset;
+    uint32_t skippedFrames;
+    uint8_t frameSkipDisabled;
+    uint8_t frameSkipFailed;
+    tFrameDecoder *frameDecoder;
+    tGIFFrame *actualFrame;
+    tGIF2BMP stats;
+    uint8_t *outputBuffer;
+    size_t outputCapacity;
+    size_t outputLength;
+    size_t outputRequired;
+    uint8_t outputAllocated;
+    uint8_t streaming;
+    uint32_t streamedRows;
+    tGIFProbe *probe;
+    uint16_t blockDelayTime;
+    uint8_t blockDisposalMethod;
+    uint8_t blockControlPending;
+    int error;
+} tGIF2BMPContext;
+
+
+/*
+ * Funkce pro dekódování LZW dat jednoho image bloku
+ *
+ * Dekóduje kódy až po kód EOI, konec dat nebo první neplatný kód.
+ * Funkce nepoužívá kontext převodu, takže ji lze volat i z více vláken
+ * současně (každé vlákno s vlastním slovníkem).
+ *
+ * table           - slovník LZW
+ * minimumCodeSize - minimální velikost LZW kódu (nejvýše 8)
+ * fill            - funkce pro získání dalšího úseku dat
+ * source          - zdroj dat předávaný funkci fill
+ * output          - výstupní funkce pro rozvinuté řetězce
+ * target          - cíl předávaný výstupní funkci
+ * invalidCode     - ukazatel pro uložení neplatného kódu
+ * stats           - čítače dekódování (hodnoty se přičítají)
+ *
+ * Návratová hodnota:
+ *     LZW_DECODE_OK, LZW_DECODE_INVALID_FIRST nebo LZW_DECODE_INVALID_CODE
+ */
+int decodeLZWData(tLZWTable *table, uint8_t minimumCodeSize, tLZWFillFunction fill, void *source,
+                  tLZWOutputFunction output, void *target, uint16_t *invalidCode, tLZWDecodeStats *stats);
+
+/*
+ * Funkce pro převod GIF na BMP s explicitním kontextem
+ *
+ * Funkce je reentrantní, pokud každé současně probíhající volání
+ * používá vlastní kontext.
+ *
+ * context    - kontext převodu (obsah se přepíše, nemusí být inicializován)
+ * gif2bmp    - záznam o převodu
+ * inputFile  - vstupní soubor (GIF)
+ * outputFile - výstupní soubor (BMP)
+ * options    - nastavení převodu (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě,
+ *          příp. nepodporuje daný formát GIF
+ */
+int gif2bmpContext(tGIF2BMPContext *context, tGIF2BMP *gif2bmp, FILE *inputFile, FILE *outputFile, const tGIF2BMPOptions *options);
+
+/*
+ * Funkce pro převod GIF v paměti na BMP v paměti s explicitním kontextem
+ *
+ * Data GIF se čtou přímo z paměti volajícího bez kopírování. BMP se zapíše
+ * do bufferu volajícího (*bmpData není NULL, *bmpLength je jeho velikost),
+ * nebo do bufferu alokovaného knihovnou přesně pro celý BMP soubor
+ * (*bmpData je NULL, volající jej uvolní funkcí free).
+ *
+ * context   - kontext převodu (obsah se přepíše, nemusí být inicializován)
+ * gif2bmp   - záznam o převodu
+ * gifData   - data GIF souboru
+ * gifLength - délka dat GIF souboru
+ * bmpData   - buffer pro BMP soubor (po úspěšném převodu jeho začátek)
+ * bmpLength - velikost bufferu volajícího, po úspěšném převodu velikost
+ *             BMP souboru, při malém bufferu potřebná velikost
+ * options   - nastavení převodu (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě (buffer alokovaný knihovnou
+ *          se uvolní), příp. nepodporuje daný formát GIF
+ */
+int gif2bmpMemoryContext(tGIF2BMPContext *context, tGIF2BMP *gif2bmp, const uint8_t *gifData, size_t gifLength,
+                         uint8_t **bmpData, size_t *bmpLength, const tGIF2BMPOptions *options);
+
+/*
+ * Funkce pro převod GIF v paměti na BMP v paměti
+ *
+ * gif2bmp   - záznam o převodu
+ * gifData   - data GIF souboru
+ * gifLength - délka dat GIF souboru
+ * bmpData   - buffer pro BMP soubor (NULL - alokuje knihovna)
+ * bmpLength - velikost bufferu volajícího, po převodu velikost BMP souboru
+ * options   - nastavení převodu (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě,
+ *          příp. nepodporuje daný formát GIF
+ */
+int gif2bmpMemory(tGIF2BMP *gif2bmp, const uint8_t *gifData, size_t gifLength,
+                  uint8_t **bmpData, size_t *bmpLength, const tGIF2BMPOptions *options);
+
+/*
+ * Funkce pro převod GIF na BMP s nastavením
+ *
+ * gif2bmp    - záznam o převodu
+ * inputFile  - vstupní soubor (GIF)
+ * outputFile - výstupní soubor (BMP)
+ * options    - nastavení převodu (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - při převodu došlo k chybě,
+ *          příp. nepodporuje daný formát GIF
+ */
+int gif2bmpOptions(tGIF2BMP *gif2bmp, FILE *inputFile, FILE *outputFile, const tGIF2BMPOptions *options);
+
+/*
+ * Funkce pro zjištění informací o GIF souboru bez dekódování
+ *
+ * Prochází hlavičku a bloky souboru stejně jako převod, ale tabulky barev
+ * a sub-bloky dat image bloků pouze přeskakuje podle jejich velikostí,
+ * nic nedekóduje a nealokuje obrazová data.
+ *
+ * context   - kontext převodu (obsah se přepíše, nemusí být inicializován)
+ * probe     - zjištěné informace (obsah se přepíše, uvolní freeGIFProbe
+ *             i při chybě)
+ * inputFile - vstupní soubor (GIF)
+ *
+ * Návratová hodnota:
+ *      0 - celý soubor byl zpracován
+ *     -1 - chybný nebo zkrácený soubor (probe obsahuje bloky před chybou)
+ */
+int gif2bmpProbeContext(tGIF2BMPContext *context, tGIFProbe *probe, FILE *inputFile);
+
+/*
+ * Funkce pro zjištění informací o GIF souboru bez dekódování
+ *
+ * probe     - zjištěné informace (uvolní freeGIFProbe i při chybě)
+ * inputFile - vstupní soubor (GIF)
+ *
+ * Návratová hodnota:
+ *      0 - celý soubor byl zpracován
+ *     -1 - chybný nebo zkrácený soubor, příp. chyba alokace
+ */
+int gif2bmpProbe(tGIFProbe *probe, FILE *inputFile);
+
+/*
+ * Funkce pro uvolnění zjištěných informací o GIF souboru
+ *
+ * probe - zjištěné informace
+ */
+void freeGIFProbe(tGIFProbe *probe);
 
 /*
  * Funkce pro převod GIF na BMP
@@ -201,3 +669,5 @@ typedef struct {
  *          příp. nepodporuje daný formát GIF
  */
 int gif2bmp(tGIF2BMP *gif2bmp, FILE *inputFile, FILE *outputFile);
+
+#endif
@@ -0,0 +1,337 @@
+/*******************************************************************************
+*  Soubor:   gifbench.c                                                        *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Benchmark  propustnosti  převodu. Vygeneruje reprodukovatelný syntetický   *
+*  korpus GIF souborů (velikosti 16x16 až 16384x16384, minimální velikost     *
+*  LZW kódu 2-8, prokládání, lokální tabulky barev, průhlednost, animace),    *
+*  každý soubor převede funkcí gif2bmp() a vypíše propustnost vstupu v MB/s,  *
+*  počet dekódovaných megapixelů za sekundu a dobu převodu souboru.           *
+*                                                                              *
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#include "gif2bmp.h"
+#include "gifencode.h"
+
+// Výchozí adresář korpusu
+#define BENCH_CORPUS_DIR "bench_corpus"
+// Největší počet opakování převodu jednoho souboru
+#define BENCH_MAX_REPEAT 5
+// Doba měření souboru, po které se další opakování již nespouští (s)
+#define BENCH_MIN_TIME 0.5
+// Největší délka cesty k souboru korpusu
+#define BENCH_PATH_SIZE 1024
+// Počet řádků, po kterých se mění vzor generovaných pixelů
+#define BENCH_BAND_HEIGHT 24
+// Podíl šumu v generovaných pixelech (každý N-tý pixel)
+#define BENCH_NOISE_PERIOD 7
+
+/*
+ * Struktura popisu jednoho souboru korpusu
+ *
+ * name        - název souboru
+ * width       - šířka logické obrazovky
+ * height      - výška logické obrazovky
+ * bits        - počet bitů na index barvy (1-8)
+ * interlace   - příznak prokládaných bloků
+ * localTable  - příznak lokálních tabulek barev místo globální
+ * transparent - příznak průhledné barvy v blocích za prvním
+ * frames      - počet image bloků
+ */
+typedef struct {
+    const char *name;
+    uint32_t width;
+    uint32_t height;
+    uint8_t bits;
+    uint8_t interlace;
+    uint8_t localTable;
+    uint8_t transparent;
+    uint32_t frames;
+} tBenchFile;
+
+// Popis korpusu
+static const tBenchFile benchCorpus[] = {
+    {"tiny_16x16_m8.gif",            16,    16, 8, 0, 0, 0,  1},
+    {"small_64x64_m2.gif",           64,    64, 2, 0, 0, 0,  1},
+    {"icon_256x256_m3_inter.gif",   256,   256, 3, 1, 0, 0,  1},
+    {"qvga_320x240_m4_local.gif",   320,   240, 4, 0, 1, 0,  1},
+    {"vga_640x480_m5.gif",          640,   480, 5, 0, 0, 0,  1},
+    {"xga_1024x768_m6_inter.gif",  1024,   768, 6, 1, 0, 0,  1},
+    {"hd_1920x1080_m7_local.gif",  1920,  1080, 7, 0, 1, 0,  1},
+    {"sq_2048x2048_m8.gif",        2048,  2048, 8, 0, 0, 0,  1},
+    {"uhd_4096x4096_m8_inter.gif", 4096,  4096, 8, 1, 0, 0,  1},
+    {"huge_16384x16384_m8.gif",   16384, 16384, 8, 0, 0, 0,  1},
+    {"anim_320x240x30_m8_tr.gif",   320,   240, 8, 0, 0, 1, 30},
+    {"anim_640x480x60_m6_lct.gif",  640,   480, 6, 0, 1, 1, 60},
+    {"anim_800x600x20_m8_int.gif",  800,   600, 8, 1, 1, 1, 20},
+};
+
+/*
+ * Funkce pro získání monotónního času v sekundách
+ */
+double getSeconds(void) {
+    // Aktuální čas
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    // Převod na sekundy
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/*
+ * Funkce pro vygenerování tabulky barev
+ *
+ * palette - výstupní tabulka barev
+ * bits    - počet bitů na index barvy
+ * seed    - počáteční hodnota generátoru barev
+ */
+void generatePalette(tRGB *palette, uint8_t bits, uint32_t seed) {
+    // Průchod všemi barvami tabulky
+    for(uint32_t index = 0; index < (1u << bits); index++) {
+        // Lineární kongruenční generátor
+        seed = seed * 1103515245u + 12345u;
+        palette[index].r = (uint8_t)(seed >> 8);
+        palette[index].g = (uint8_t)(seed >> 16);
+        palette[index].b = (uint8_t)(seed >> 24);
+    }
+}
+
+/*
+ * Funkce pro vygenerování indexů barev jednoho bloku
+ *
+ * Pixely tvoří pruhy a přechody (dobře komprimovatelné) s příměsí šumu,
+ * takže data obsahují dlouhé i krátké řetězce.
+ *
+ * pixels - výstupní indexy barev
+ * width  - šířka bloku
+ * height - výška bloku
+ * bits   - počet bitů na index barvy
+ * frame  - pořadí bloku
+ */
+void generatePixels(uint8_t *pixels, uint32_t width, uint32_t height, uint8_t bits, uint32_t frame) {
+    // Maska indexů barev
+    uint32_t mask = (1u << bits) - 1;
+    // Generátor šumu
+    uint32_t seed = 0x9E3779B9u ^ frame;
+
+    // Průchod řádky
+    for(uint32_t row = 0; row < height; row++) {
+        // Vzor pruhu, do kterého řádek patří
+        uint32_t band = row / BENCH_BAND_HEIGHT + frame;
+        for(uint32_t col = 0; col < width; col++) {
+            // Lineární kongruenční generátor
+            seed = seed * 1103515245u + 12345u;
+            // Šum nebo přechod podle pruhu
+            if((seed >> 16) % BENCH_NOISE_PERIOD == 0) {
+                *pixels++ = (uint8_t)((seed >> 24) & mask);
+            } else {
+                *pixels++ = (uint8_t)(((col >> (band % 4 + 2)) + band * 3) & mask);
+            }
+        }
+    }
+}
+
+/*
+ * Funkce pro vygenerování jednoho souboru korpusu
+ *
+ * file    - popis souboru
+ * path    - cesta k výstupnímu souboru
+ * encoder - kodér GIF
+ *
+ * Návratová hodnota:
+ *      0 - soubor byl vygenerován
+ *     -1 - chyba alokace nebo zápisu
+ */
+int generateFile(const tBenchFile *file, const char *path, tGIFEncoder *encoder) {
+    // Indexy barev bloku
+    uint8_t *pixels = (uint8_t*)malloc((size_t)file->width * file->height);
+    // Globální a lokální tabulka barev
+    tRGB globalPalette[PALETTE_MAX_SIZE];
+    tRGB localPalette[PALETTE_MAX_SIZE];
+    // Nastavení kodéru
+    tGIFEncodeOptions options = {0, 0, file->interlace, 1};
+    // Výstupní soubor
+    FILE *output = NULL;
+    // Výsledek zápisu
+    int result = RETURN_SUCCESS;
+
+    // Kontrola alokace a otevření souboru
+    if(pixels == NULL || (output = fopen(path, "wb")) == NULL) {
+        fprintf(stderr, "ERROR: Cannot create '%s'.\n", path);
+        free(pixels);
+        return RETURN_FAILURE;
+    }
+
+    // Hlavička s globální tabulkou barev (s lokálními tabulkami pro pozadí)
+    generatePalette(globalPalette, file->bits, 0x2014);
+    result = startGIFEncoder(encoder, output, (uint16_t)file->width, (uint16_t)file->height, globalPalette, (uint16_t)(1u << file->bits), &options);
+
+    // Zápis všech bloků
+    for(uint32_t frame = 0; frame < file->frames && result == RETURN_SUCCESS; frame++) {
+        // Blok přes celou obrazovku, bloky za prvním jsou menší a posunuté
+        tGIFEncodeFrame block = {0, 0, (uint16_t)file->width, (uint16_t)file->height, pixels, file->width, NULL, 0, -1, 0};
+        if(frame > 0) {
+            block.width = (uint16_t)(file->width * 3 / 4);
+            block.height = (uint16_t)(file->height * 3 / 4);
+            block.stride = block.width;
+            block.left = (uint16_t)((frame * 7) % (file->width - block.width + 1));
+            block.top = (uint16_t)((frame * 5) % (file->height - block.height + 1));
+        }
+        // Průhledná barva a doba zobrazení
+        if(file->transparent && frame > 0) {
+            block.transparentIndex = (int)(frame & ((1u << file->bits) - 1));
+            block.delay = 10;
+        }
+        // Lokální tabulka barev
+        if(file->localTable) {
+            generatePalette(localPalette, file->bits, 0x2014 + frame);
+            block.palette = localPalette;
+            block.paletteSize = (uint16_t)(1u << file->bits);
+        }
+
+        // Vygenerování a zakódování indexů barev bloku
+        generatePixels(pixels, block.width, block.height, file->bits, frame);
+        result = addGIFFrame(encoder, &block);
+    }
+
+    // Ukončení souboru
+    if(result == RETURN_SUCCESS) {
+        result = finishGIFEncoder(encoder);
+    }
+    free(pixels);
+    // Kontrola zápisu
+    if(fclose(output) != 0 || result != RETURN_SUCCESS) {
+        fprintf(stderr, "ERROR: Cannot write '%s'.\n", path);
+        return RETURN_FAILURE;
+    }
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro změření převodu jednoho souboru
+ *
+ * path    - cesta k souboru
+ * latency - nejkratší doba převodu (s)
+ * info    - záznam o převodu
+ *
+ * Návratová hodnota:
+ *      0 - všechny převody proběhly
+ *     -1 - chyba převodu
+ */
+int measureFile(const char *path, double *latency, tGIF2BMP *info) {
+    // Celková doba měření
+    double total = 0;
+
+    *latency = 0;
+    // Opakované převody, dokud neuplyne doba měření
+    for(int repeat = 0; repeat < BENCH_MAX_REPEAT && total < BENCH_MIN_TIME; repeat++) {
+        // Vstupní soubor a výstup bez zápisu na disk
+        FILE *input = fopen(path, "rb");
+        FILE *output = fopen("/dev/null", "wb");
+        if(input == NULL || output == NULL) {
+            fprintf(stderr, "ERROR: Cannot open '%s'.\n", path);
+            if(input != NULL) fclose(input);
+            if(output != NULL) fclose(output);
+            return RETURN_FAILURE;
+        }
+
+        // Převod
+        double start = getSeconds();
+        int result = gif2bmp(info, input, output);
+        double seconds = getSeconds() - start;
+        fclose(input);
+        fclose(output);
+        if(result != RETURN_SUCCESS) {
+            fprintf(stderr, "ERROR: Conversion of '%s' failed.\n", path);
+            return RETURN_FAILURE;
+        }
+
+        // Uložení nejkratší doby
+        if(repeat == 0 || seconds < *latency) {
+            *latency = seconds;
+        }
+        total += seconds;
+    }
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce main - vygenerování korpusu a měření převodu
+ *
+ * argv[1] - adresář korpusu (výchozí bench_corpus)
+ *
+ * Návratová hodnota:
+ *     EXIT_SUCCESS - všechny soubory byly převedeny
+ *     EXIT_FAILURE - chyba generování nebo převodu
+ */
+int main(int argc, char **argv) {
+    // Adresář korpusu
+    const char *directory = argc > 1 ? argv[1] : BENCH_CORPUS_DIR;
+    // Kodér GIF (slovník je příliš velký pro zásobník)
+    tGIFEncoder *encoder = (tGIFEncoder*)malloc(sizeof(tGIFEncoder));
+    // Součty přes celý korpus
+    double totalBytes = 0;
+    double totalPixels = 0;
+    double totalSeconds = 0;
+
+    // Kontrola alokace
+    if(encoder == NULL) {
+        fprintf(stderr, "ERROR: benchmark malloc failed.\n");
+        return EXIT_FAILURE;
+    }
+    // Vytvoření adresáře korpusu (může již existovat)
+    mkdir(directory, 0755);
+
+    // Hlavička výsledků
+    printf("%-30s %10s %10s %10s %10s %10s\n", "file", "GIF bytes", "Mpix", "ms", "MB/s", "Mpix/s");
+
+    // Průchod všemi soubory korpusu
+    for(size_t index = 0; index < sizeof(benchCorpus) / sizeof(benchCorpus[0]); index++) {
+        // Popis souboru a cesta k němu
+        const tBenchFile *file = &benchCorpus[index];
+        char path[BENCH_PATH_SIZE];
+        snprintf(path, sizeof(path), "%s/%s", directory, file->name);
+        // Výsledky měření
+        double latency = 0;
+        tGIF2BMP info = {0};
+
+        // Vygenerování a změření souboru
+        if(generateFile(file, path, encoder) != RETURN_SUCCESS || measureFile(path, &latency, &info) != RETURN_SUCCESS) {
+            free(encoder);
+            return EXIT_FAILURE;
+        }
+
+        // Počet dekódovaných pixelů (bloky za prvním mají 3/4 rozměrů)
+        double pixels = (double)file->width * file->height +
+                        (double)(file->frames - 1) * (file->width * 3 / 4) * (file->height * 3 / 4);
+        // Tisk výsledků souboru
+        printf("%-30s %10" PRId64 " %10.2f %10.3f %10.1f %10.1f\n", file->name, info.gifSize, pixels / 1e6,
+               latency * 1e3, latency > 0 ? info.gifSize / latency / 1e6 : 0.0, latency > 0 ? pixels / latency / 1e6 : 0.0);
+        // Započtení do součtů
+        totalBytes += (double)info.gifSize;
+        totalPixels += pixels;
+        totalSeconds += latency;
+    }
+
+    // Tisk součtů
+    printf("%-30s %10.0f %10.2f %10.3f %10.1f %10.1f\n", "total", totalBytes, totalPixels / 1e6, totalSeconds * 1e3,
+           totalSeconds > 0 ? totalBytes / totalSeconds / 1e6 : 0.0, totalSeconds > 0 ? totalPixels / totalSeconds / 1e6 : 0.0);
+
+    // Uvolnění kodéru
+    free(encoder);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,324 @@
+/*******************************************************************************
+*  Soubor:   gifcheck.c                                                        *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Regresní  testy  převodu. Vygeneruje malé GIF soubory s hraničními tvary   *
+*  bloků (nízké a úzké prokládané bloky, bloky překrývající přeskočené        *
+*  bloky), každý převede ze souboru (mapovaný vstup s přeskakováním bloků)    *
+*  i z paměti a výsledný BMP porovná s obrazem složeným přímo z indexů bloků. *
+*                                                                              *
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "gif2bmp.h"
+#include "gifencode.h"
+
+// Výchozí adresář regresních souborů
+#define CHECK_CORPUS_DIR "check_corpus"
+// Největší délka cesty k souboru
+#define CHECK_PATH_SIZE 1024
+// Největší počet bloků jednoho souboru
+#define CHECK_MAX_FRAMES 4
+// Počet bitů na index barvy generovaných souborů
+#define CHECK_BITS 4
+// Největší počet pixelů jednoho bloku
+#define CHECK_MAX_PIXELS 4096
+
+/*
+ * Struktura popisu jednoho neprůhledného bloku
+ *
+ * left      - levá pozice bloku
+ * top       - horní pozice bloku
+ * width     - šířka bloku
+ * height    - výška bloku
+ * interlace - příznak prokládaného bloku
+ */
+typedef struct {
+    uint16_t left;
+    uint16_t top;
+    uint16_t width;
+    uint16_t height;
+    uint8_t interlace;
+} tCheckFrame;
+
+/*
+ * Struktura popisu jednoho regresního souboru
+ *
+ * name   - název souboru
+ * width  - šířka logické obrazovky
+ * height - výška logické obrazovky
+ * count  - počet bloků
+ * frames - bloky (první pokrývá celou logickou obrazovku)
+ */
+typedef struct {
+    const char *name;
+    uint16_t width;
+    uint16_t height;
+    uint32_t count;
+    tCheckFrame frames[CHECK_MAX_FRAMES];
+} tCheckFile;
+
+// Popis regresních souborů
+static const tCheckFile checkCorpus[] = {
+    // Prokládaný blok výšky 3 překrývá (a přeskakuje) první blok
+    {"skip_inter_4x3.gif",     4,  3, 2, {{0, 0, 4,  3, 0}, {0, 0, 4,  3, 1}}},
+    {"skip_inter_5x2.gif",     5,  2, 2, {{0, 0, 5,  2, 0}, {0, 0, 5,  2, 1}}},
+    {"skip_inter_w1_1x37.gif", 1, 37, 2, {{0, 0, 1, 37, 0}, {0, 0, 1, 37, 1}}},
+    // Samostatné nízké a úzké prokládané bloky
+    {"inter_3x3.gif",          3,  3, 1, {{0, 0, 3,  3, 1}}},
+    {"inter_7x4.gif",          7,  4, 1, {{0, 0, 7,  4, 1}}},
+    {"inter_w1_1x37.gif",      1, 37, 1, {{0, 0, 1, 37, 1}}},
+    // Nízké prokládané bloky uvnitř logické obrazovky
+    {"inter_sub_8x12.gif",     8, 12, 3, {{0, 0, 8, 12, 0}, {1, 2, 6,  3, 1}, {2, 7, 1,  5, 1}}},
+};
+
+/*
+ * Funkce pro vygenerování tabulky barev (všechny barvy různé)
+ *
+ * palette - výstupní tabulka barev
+ */
+void generateCheckPalette(tRGB *palette) {
+    for(uint32_t index = 0; index < (1u << CHECK_BITS); index++) {
+        palette[index].r = (uint8_t)(index * 16 + 8);
+        palette[index].g = (uint8_t)(255 - index * 13);
+        palette[index].b = (uint8_t)(index * 29 + 3);
+    }
+}
+
+/*
+ * Funkce pro vygenerování indexů barev bloku (sousední řádky se liší)
+ *
+ * pixels - výstupní indexy barev
+ * frame  - popis bloku
+ * number - pořadí bloku
+ */
+void generateCheckPixels(uint8_t *pixels, const tCheckFrame *frame, uint32_t number) {
+    for(uint32_t y = 0; y < frame->height; y++) {
+        for(uint32_t x = 0; x < frame->width; x++) {
+            pixels[(size_t)y * frame->width + x] = (uint8_t)((x * 5 + y * 3 + number * 7 + 1) & ((1u << CHECK_BITS) - 1));
+        }
+    }
+}
+
+/*
+ * Funkce pro vygenerování souboru a očekávaného obrazu
+ *
+ * Očekávaný obraz jsou barvy BGR řádků shora dolů, každý blok přepíše
+ * svůj obdélník indexy v přirozeném pořadí řádků.
+ *
+ * file     - popis souboru
+ * path     - cesta k souboru
+ * encoder  - kodér
+ * expected - očekávaný obraz (width * height * 3 bajtů)
+ *
+ * Návratová hodnota:
+ *      0 - soubor byl vygenerován
+ *     -1 - chyba alokace nebo zápisu
+ */
+int generateCheckFile(const tCheckFile *file, const char *path, tGIFEncoder *encoder, uint8_t *expected) {
+    // Tabulka barev
+    tRGB palette[PALETTE_MAX_SIZE];
+    // Nastavení kodéru (prokládání se nastavuje pro každý blok)
+    tGIFEncodeOptions options = {0, 0, 0, 1};
+    // Výstupní soubor
+    FILE *output = fopen(path, "wb");
+    // Výsledek zápisu
+    int result = RETURN_SUCCESS;
+
+    // Kontrola otevření souboru
+    if(output == NULL) {
+        fprintf(stderr, "ERROR: Cannot create '%s'.\n", path);
+        return RETURN_FAILURE;
+    }
+
+    // Hlavička s globální tabulkou barev
+    generateCheckPalette(palette);
+    result = startGIFEncoder(encoder, output, file->width, file->height, palette, (uint16_t)(1u << CHECK_BITS), &options);
+
+    // Zápis bloků a jejich složení do očekávaného obrazu
+    for(uint32_t number = 0; number < file->count && result == RETURN_SUCCESS; number++) {
+        const tCheckFrame *frame = &file->frames[number];
+        uint8_t pixels[CHECK_MAX_PIXELS];
+        tGIFEncodeFrame block = {frame->left, frame->top, frame->width, frame->height, pixels, frame->width, NULL, 0, -1, 0};
+
+        generateCheckPixels(pixels, frame, number);
+        encoder->options.interlace = frame->interlace;
+        result = addGIFFrame(encoder, &block);
+
+        for(uint32_t y = 0; y < frame->height; y++) {
+            for(uint32_t x = 0; x < frame->width; x++) {
+                const tRGB *color = &palette[pixels[(size_t)y * frame->width + x]];
+                uint8_t *target = expected + (((size_t)(frame->top + y) * file->width) + frame->left + x) * ONE_PIXEL_SIZE;
+                target[0] = color->b;
+                target[1] = color->g;
+                target[2] = color->r;
+            }
+        }
+    }
+
+    // Ukončení souboru
+    if(result == RETURN_SUCCESS) {
+        result = finishGIFEncoder(encoder);
+    }
+    if(fclose(output) != 0 || result != RETURN_SUCCESS) {
+        fprintf(stderr, "ERROR: Cannot write '%s'.\n", path);
+        return RETURN_FAILURE;
+    }
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro porovnání BMP souboru (24 bitů, řádky zdola nahoru)
+ * s očekávaným obrazem
+ *
+ * file     - popis souboru
+ * bmp      - data BMP souboru
+ * length   - délka dat
+ * expected - očekávaný obraz
+ *
+ * Návratová hodnota:
+ *     -1 - BMP odpovídá, jinak první chybný řádek (shora), příp. výška
+ *          obrazu při chybné délce
+ */
+long compareCheckBMP(const tCheckFile *file, const uint8_t *bmp, size_t length, const uint8_t *expected) {
+    // Délka řádku BMP včetně zarovnání
+    size_t rowWidth = ((size_t)file->width * ONE_PIXEL_SIZE + ROW_MULT_SIZE - 1) / ROW_MULT_SIZE * ROW_MULT_SIZE;
+
+    // Kontrola délky
+    if(length != BMP_HEADER_SIZE + rowWidth * file->height) {
+        return file->height;
+    }
+    // Porovnání řádků
+    for(uint32_t row = 0; row < file->height; row++) {
+        const uint8_t *actual = bmp + BMP_HEADER_SIZE + (size_t)(file->height - 1 - row) * rowWidth;
+        if(memcmp(actual, expected + (size_t)row * file->width * ONE_PIXEL_SIZE, (size_t)file->width * ONE_PIXEL_SIZE) != 0) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Funkce pro převod souboru ze souboru i z paměti a kontrolu výsledků
+ *
+ * file     - popis souboru
+ * path     - cesta k souboru
+ * expected - očekávaný obraz
+ *
+ * Návratová hodnota:
+ *      0 - oba převody odpovídají očekávanému obrazu
+ *     -1 - chyba převodu nebo rozdílný obraz
+ */
+int checkFile(const tCheckFile *file, const char *path, const uint8_t *expected) {
+    // Záznam o převodu
+    tGIF2BMP info = {0};
+    // Data GIF a BMP souborů
+    uint8_t *gif = NULL;
+    uint8_t *bmp = NULL;
+    size_t gifLength = 0;
+    size_t bmpLength = 0;
+    // Vstupní a výstupní soubor
+    FILE *input = fopen(path, "rb");
+    FILE *output = tmpfile();
+    // Výsledek kontroly a první chybný řádek
+    int result = RETURN_FAILURE;
+    long fileRow = 0;
+    long memoryRow = 0;
+
+    // Převod ze souboru a načtení obou souborů
+    if(input != NULL && output != NULL && gif2bmp(&info, input, output) == RETURN_SUCCESS &&
+       fseek(output, 0, SEEK_END) == 0 && (bmpLength = (size_t)ftell(output)) > 0 &&
+       fseek(input, 0, SEEK_END) == 0 && (gifLength = (size_t)ftell(input)) > 0 &&
+       (bmp = (uint8_t*)malloc(bmpLength)) != NULL && (gif = (uint8_t*)malloc(gifLength)) != NULL) {
+        rewind(output);
+        rewind(input);
+        if(fread(bmp, 1, bmpLength, output) == bmpLength && fread(gif, 1, gifLength, input) == gifLength) {
+            // Porovnání převodu ze souboru
+            fileRow = compareCheckBMP(file, bmp, bmpLength, expected);
+            // Převod z paměti do bufferu alokovaného knihovnou
+            free(bmp);
+            bmp = NULL;
+            bmpLength = 0;
+            if(gif2bmpMemory(&info, gif, gifLength, &bmp, &bmpLength, NULL) == RETURN_SUCCESS) {
+                memoryRow = compareCheckBMP(file, bmp, bmpLength, expected);
+                result = RETURN_SUCCESS;
+            }
+        }
+    }
+
+    // Tisk výsledku
+    if(result != RETURN_SUCCESS) {
+        fprintf(stderr, "ERROR: Conversion of '%s' failed.\n", path);
+    } else if(fileRow >= 0 || memoryRow >= 0) {
+        fprintf(stderr, "ERROR: '%s' differs (file row %ld, memory row %ld).\n", path, fileRow, memoryRow);
+        result = RETURN_FAILURE;
+    }
+
+    // Úklid
+    if(input != NULL) fclose(input);
+    if(output != NULL) fclose(output);
+    free(gif);
+    free(bmp);
+    return result;
+}
+
+/*
+ * Funkce main - vygenerování regresních souborů a kontrola převodu
+ *
+ * argv[1] - adresář regresních souborů (výchozí check_corpus)
+ *
+ * Návratová hodnota:
+ *     EXIT_SUCCESS - všechny soubory byly převedeny správně
+ *     EXIT_FAILURE - chyba generování, převodu nebo rozdílný obraz
+ */
+int main(int argc, char **argv) {
+    // Adresář regresních souborů
+    const char *directory = argc > 1 ? argv[1] : CHECK_CORPUS_DIR;
+    // Kodér GIF (slovník je příliš velký pro zásobník)
+    tGIFEncoder *encoder = (tGIFEncoder*)malloc(sizeof(tGIFEncoder));
+    // Počet chybných souborů
+    uint32_t failures = 0;
+
+    // Kontrola alokace
+    if(encoder == NULL) {
+        fprintf(stderr, "ERROR: check malloc failed.\n");
+        return EXIT_FAILURE;
+    }
+    // Vytvoření adresáře (může již existovat)
+    mkdir(directory, 0755);
+
+    // Průchod všemi regresními soubory
+    for(size_t index = 0; index < sizeof(checkCorpus) / sizeof(checkCorpus[0]); index++) {
+        const tCheckFile *file = &checkCorpus[index];
+        char path[CHECK_PATH_SIZE];
+        // Očekávaný obraz (nevykreslené pixely jsou černé)
+        uint8_t *expected = (uint8_t*)calloc((size_t)file->width * file->height, ONE_PIXEL_SIZE);
+        snprintf(path, sizeof(path), "%s/%s", directory, file->name);
+
+        // Vygenerování a kontrola souboru
+        if(expected == NULL || generateCheckFile(file, path, encoder, expected) != RETURN_SUCCESS ||
+           checkFile(file, path, expected) != RETURN_SUCCESS) {
+            failures++;
+        } else {
+            printf("%-30s OK\n", file->name);
+        }
+        free(expected);
+    }
+
+    // Tisk souhrnu
+    printf("%u of %u files failed\n", (unsigned)failures, (unsigned)(sizeof(checkCorpus) / sizeof(checkCorpus[0])));
+
+    // Uvolnění kodéru
+    free(encoder);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
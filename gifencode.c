@@ -0,0 +1,679 @@
+/*******************************************************************************
+*  Soubor:   gifencode.c                                                       *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Kodér  GIF89a.  Řetězec  ve slovníku LZW je dvojice (předchozí kód, index  *
+*  barvy), slovník je hashovací tabulka s lineárním hledáním. Klíč obsahuje   *
+*  i generaci slovníku, takže clear kód slovník vyprázdní bez mazání celé     *
+*  tabulky. Kódy se skládají v 64bitovém akumulátoru a do bufferu se          *
+*  zapisují po 32 bitech, buffer se zapisuje po celých sub-blocích.           *
+*                                                                              *
+*******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include "gifencode.h"
+
+// Počet bitů indexu hashovací tabulky (GIF_ENCODE_HASH_SIZE = 2^13)
+#define GIF_ENCODE_HASH_BITS 13
+// Multiplikativní konstanta hashovací funkce (Knuth)
+#define GIF_ENCODE_HASH_MULTIPLIER 2654435761u
+// Počet bitů zapisovaných z akumulátoru najednou
+#define GIF_ENCODE_FLUSH_BITS 32
+// Velikost položky tabulky barev GIF
+#define GIF_COLOR_SIZE 3
+// Počet položek hashovací tabulky barev 24bitového BMP
+#define BMP_COLOR_HASH_BITS 10
+#define BMP_COLOR_HASH_SIZE (1 << BMP_COLOR_HASH_BITS)
+// Prázdná položka hashovací tabulky barev
+#define BMP_COLOR_EMPTY 0xFFFFFFFFu
+
+/*
+ * Funkce pro zápis 16bitové hodnoty (little endian)
+ */
+static void putGIFWord(FILE *file, uint16_t value) {
+    fputc(value & 0xFF, file);
+    fputc(value >> BYTE_BITS, file);
+}
+
+/*
+ * Funkce pro získání 16bitové hodnoty BMP hlavičky (little endian)
+ */
+static uint16_t getLE16(const uint8_t *bytes) {
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+/*
+ * Funkce pro získání 32bitové hodnoty BMP hlavičky (little endian)
+ */
+static uint32_t getLE32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+/*
+ * Funkce pro výpočet počtu bitů tabulky barev
+ *
+ * size - počet barev (1-256)
+ *
+ * Návratová hodnota:
+ *     nejmenší počet bitů (1-8), do kterého se všechny barvy vejdou
+ */
+static uint8_t getPaletteBits(uint16_t size) {
+    // Počet bitů tabulky
+    uint8_t bits = 1;
+    // Zvětšování, dokud se barvy nevejdou
+    while((1u << bits) < size) {
+        bits++;
+    }
+    return bits;
+}
+
+/*
+ * Funkce pro zápis tabulky barev doplněné na mocninu dvou
+ *
+ * file    - výstupní soubor
+ * palette - tabulka barev
+ * size    - počet barev
+ * bits    - počet bitů tabulky
+ */
+static void putColorTable(FILE *file, const tRGB *palette, uint16_t size, uint8_t bits) {
+    // Zápis barev tabulky
+    for(uint16_t index = 0; index < size; index++) {
+        fputc(palette[index].r, file);
+        fputc(palette[index].g, file);
+        fputc(palette[index].b, file);
+    }
+    // Doplnění černou barvou
+    for(uint32_t index = size; index < (1u << bits); index++) {
+        for(int component = 0; component < GIF_COLOR_SIZE; component++) {
+            fputc(0, file);
+        }
+    }
+}
+
+/*
+ * Funkce pro zápis celých sub-bloků z bufferu kódovaných dat
+ *
+ * encoder - kodér
+ * all     - příznak zápisu i posledního neúplného sub-bloku
+ */
+static void flushSubBlocks(tGIFEncoder *encoder, uint8_t all) {
+    // Pozice dalšího zapisovaného sub-bloku
+    size_t position = 0;
+
+    // Zápis celých sub-bloků
+    while(encoder->dataSize - position >= GIF_ENCODE_SUB_BLOCK_SIZE) {
+        fputc(GIF_ENCODE_SUB_BLOCK_SIZE, encoder->file);
+        fwrite(encoder->data + position, 1, GIF_ENCODE_SUB_BLOCK_SIZE, encoder->file);
+        position += GIF_ENCODE_SUB_BLOCK_SIZE;
+    }
+    // Zápis posledního neúplného sub-bloku
+    if(all == FLAG_TRUE && encoder->dataSize > position) {
+        fputc((int)(encoder->dataSize - position), encoder->file);
+        fwrite(encoder->data + position, 1, encoder->dataSize - position, encoder->file);
+        position = encoder->dataSize;
+    }
+    // Přesun zbytku na začátek bufferu
+    memmove(encoder->data, encoder->data + position, encoder->dataSize - position);
+    encoder->dataSize -= position;
+}
+
+/*
+ * Funkce pro zápis jednoho LZW kódu aktuální velikosti
+ *
+ * encoder - kodér
+ * code    - zapisovaný kód
+ */
+static inline void putLZWCode(tGIFEncoder *encoder, uint16_t code) {
+    // Přidání kódu za platné bity akumulátoru
+    encoder->bitBuffer |= (uint64_t)code << encoder->bitCount;
+    encoder->bitCount += encoder->codeSize;
+    // Zápis 32 bitů najednou
+    if(encoder->bitCount >= GIF_ENCODE_FLUSH_BITS) {
+        // Místo v bufferu
+        if(encoder->dataSize + sizeof(uint32_t) > GIF_ENCODE_BUFFER_SIZE) {
+            flushSubBlocks(encoder, FLAG_FALSE);
+        }
+        uint8_t *target = encoder->data + encoder->dataSize;
+        target[0] = (uint8_t)encoder->bitBuffer;
+        target[1] = (uint8_t)(encoder->bitBuffer >> 8);
+        target[2] = (uint8_t)(encoder->bitBuffer >> 16);
+        target[3] = (uint8_t)(encoder->bitBuffer >> 24);
+        encoder->dataSize += sizeof(uint32_t);
+        encoder->bitBuffer >>= GIF_ENCODE_FLUSH_BITS;
+        encoder->bitCount -= GIF_ENCODE_FLUSH_BITS;
+    }
+}
+
+/*
+ * Funkce pro vyprázdnění slovníku (po clear kódu)
+ *
+ * encoder - kodér
+ */
+static void resetEncoderDictionary(tGIFEncoder *encoder) {
+    // Nová generace zneplatní všechny klíče, po vyčerpání generací
+    // se tabulka smaže
+    encoder->generation++;
+    if(encoder->generation > GIF_ENCODE_MAX_GENERATION) {
+        memset(encoder->hashKeys, 0, sizeof(encoder->hashKeys));
+        encoder->generation = 1;
+    }
+    // Počáteční velikost kódu a první volný kód
+    encoder->codeSize = encoder->minimumCodeSize + 1;
+    encoder->nextCode = (uint16_t)((1u << encoder->minimumCodeSize) + 2);
+    encoder->codesSinceClear = 0;
+}
+
+/*
+ * Funkce pro zakódování úseku indexů barev
+ *
+ * encoder - kodér
+ * pixels  - indexy barev
+ * count   - počet indexů
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - index mimo tabulku barev
+ */
+static int encodePixels(tGIFEncoder *encoder, const uint8_t *pixels, uint32_t count) {
+    // Clear kód (zároveň první index mimo tabulku barev)
+    uint16_t clearCode = (uint16_t)(1u << encoder->minimumCodeSize);
+    // Kód dosud nezapsaného řetězce
+    int32_t prefix = encoder->prefix;
+
+    // Průchod indexy úseku
+    for(uint32_t index = 0; index < count; index++) {
+        // Aktuální index barvy
+        uint8_t color = pixels[index];
+        // Index mimo tabulku barev by se zapsal jako řídicí kód
+        if(color >= clearCode) {
+            fprintf(stderr, "ERROR: Color index %d outside of color table.\n", color);
+            encoder->prefix = prefix;
+            return RETURN_FAILURE;
+        }
+        // První index bloku začíná řetězec
+        if(prefix < 0) {
+            prefix = color;
+            continue;
+        }
+
+        // Klíč prodlouženého řetězce včetně generace slovníku
+        uint32_t key = (encoder->generation << GIF_ENCODE_KEY_BITS) | ((uint32_t)prefix << BYTE_BITS) | color;
+        // Hledání klíče od jeho pozice v tabulce
+        uint32_t slot = ((((uint32_t)prefix << BYTE_BITS) | color) * GIF_ENCODE_HASH_MULTIPLIER) >> (32 - GIF_ENCODE_HASH_BITS);
+        while(encoder->hashKeys[slot] != key && (encoder->hashKeys[slot] >> GIF_ENCODE_KEY_BITS) == encoder->generation) {
+            slot = (slot + 1) & (GIF_ENCODE_HASH_SIZE - 1);
+        }
+        // Prodloužený řetězec je ve slovníku
+        if(encoder->hashKeys[slot] == key) {
+            prefix = encoder->hashCodes[slot];
+            continue;
+        }
+
+        // Zápis kódu řetězce
+        putLZWCode(encoder, (uint16_t)prefix);
+        encoder->codesSinceClear++;
+        // Přidání prodlouženého řetězce do volné pozice
+        if(encoder->nextCode < LZW_TABLE_SIZE) {
+            encoder->hashKeys[slot] = key;
+            encoder->hashCodes[slot] = encoder->nextCode++;
+            // Dekodér zvětší kód o jeden kód později než kodér
+            if(encoder->nextCode > (1u << encoder->codeSize) && encoder->codeSize < LZW_MAX_CODE_SIZE) {
+                encoder->codeSize++;
+            }
+            // Clear kód po nastaveném počtu kódů
+            if(encoder->options.clearInterval > 0 && encoder->codesSinceClear >= encoder->options.clearInterval) {
+                putLZWCode(encoder, clearCode);
+                resetEncoderDictionary(encoder);
+            }
+        } else {
+            // Plný slovník - clear kód a nový slovník
+            putLZWCode(encoder, clearCode);
+            resetEncoderDictionary(encoder);
+        }
+        // Nový řetězec začíná aktuálním indexem
+        prefix = color;
+    }
+
+    // Uložení rozpracovaného řetězce
+    encoder->prefix = prefix;
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro zahájení zápisu GIF souboru
+ *
+ * Zapíše signaturu, popis logické obrazovky a globální tabulku barev.
+ *
+ * encoder     - kodér (obsah se přepíše)
+ * file        - výstupní soubor
+ * width       - šířka logické obrazovky
+ * height      - výška logické obrazovky
+ * palette     - globální tabulka barev (NULL - bez globální tabulky)
+ * paletteSize - počet barev globální tabulky (1-256)
+ * options     - nastavení kodéru (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - chybné nastavení nebo chyba zápisu
+ */
+int startGIFEncoder(tGIFEncoder *encoder, FILE *file, uint16_t width, uint16_t height,
+                    const tRGB *palette, uint16_t paletteSize, const tGIFEncodeOptions *options) {
+    // Vynulování kodéru
+    memset(encoder, 0, sizeof(tGIFEncoder));
+    encoder->file = file;
+    encoder->width = width;
+    encoder->height = height;
+    if(options != NULL) {
+        encoder->options = *options;
+    }
+
+    // Kontrola nastavení
+    if(encoder->options.minimumCodeSize == 1 || encoder->options.minimumCodeSize > BYTE_BITS ||
+       (palette != NULL && (paletteSize == 0 || paletteSize > PALETTE_MAX_SIZE))) {
+        fprintf(stderr, "ERROR: Invalid GIF encoder options.\n");
+        encoder->error = RETURN_FAILURE;
+        return RETURN_FAILURE;
+    }
+
+    // Signatura a popis logické obrazovky
+    fwrite(GIF_SIGNATURE, 1, GIF_SIGNATURE_LENGTH, file);
+    putGIFWord(file, width);
+    putGIFWord(file, height);
+    if(palette != NULL) {
+        encoder->globalBits = getPaletteBits(paletteSize);
+        fputc(AND_OF_COLOR_TABLE_FLAG | AND_OF_BPP | (encoder->globalBits - 1), file);
+    } else {
+        fputc(AND_OF_BPP, file);
+    }
+    // Index barvy pozadí a poměr stran pixelu
+    fputc(0, file);
+    fputc(0, file);
+    // Globální tabulka barev
+    if(palette != NULL) {
+        putColorTable(file, palette, paletteSize, encoder->globalBits);
+    }
+
+    // Kontrola zápisu
+    if(ferror(file)) {
+        encoder->error = RETURN_FAILURE;
+    }
+    return encoder->error;
+}
+
+/*
+ * Funkce pro zápis jednoho image bloku
+ *
+ * encoder - kodér
+ * frame   - popis bloku
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - chybný blok (bez tabulky barev) nebo chyba zápisu
+ */
+int addGIFFrame(tGIFEncoder *encoder, const tGIFEncodeFrame *frame) {
+    // Počáteční řádky a kroky průchodů prokládání
+    const uint16_t passStart[] = {0, 4, 2, 1};
+    const uint16_t passStep[] = {8, 8, 4, 2};
+    // Počet bitů tabulky barev bloku
+    uint8_t colorBits = encoder->globalBits;
+    // Počet průchodů řádky (neprokládaný blok má jeden průchod)
+    int passCount = encoder->options.interlace == FLAG_TRUE ? 4 : 1;
+
+    // Předchozí chyba ukončí zápis
+    if(encoder->error != RETURN_SUCCESS) {
+        return RETURN_FAILURE;
+    }
+    // Blok musí mít tabulku barev
+    if(frame->palette != NULL) {
+        if(frame->paletteSize == 0 || frame->paletteSize > PALETTE_MAX_SIZE) {
+            fprintf(stderr, "ERROR: Invalid local color table size: %d.\n", frame->paletteSize);
+            return encoder->error = RETURN_FAILURE;
+        }
+        colorBits = getPaletteBits(frame->paletteSize);
+    } else if(colorBits == 0) {
+        fprintf(stderr, "ERROR: Image block without color table.\n");
+        return encoder->error = RETURN_FAILURE;
+    }
+
+    // Blok graphic control (průhledná barva, doba zobrazení)
+    if(frame->transparentIndex >= 0 || frame->delay > 0) {
+        fputc(EXTENSION_BLOCK_ID, encoder->file);
+        fputc(GRAPHIC_CONTROL_BLOCK_ID, encoder->file);
+        fputc(GRAPHIC_CONTROL_BLOCK_SIZE - 2, encoder->file);
+        fputc(frame->transparentIndex >= 0 ? AND_OF_TRANSPARENT_FLAG : 0, encoder->file);
+        putGIFWord(encoder->file, frame->delay);
+        fputc(frame->transparentIndex >= 0 ? frame->transparentIndex : 0, encoder->file);
+        fputc(BLOCK_TERMINATOR, encoder->file);
+    }
+
+    // Popis bloku a lokální tabulka barev
+    fputc(IMAGE_BLOCK_ID, encoder->file);
+    putGIFWord(encoder->file, frame->left);
+    putGIFWord(encoder->file, frame->top);
+    putGIFWord(encoder->file, frame->width);
+    putGIFWord(encoder->file, frame->height);
+    fputc((frame->palette != NULL ? AND_OF_COLOR_TABLE_FLAG | (colorBits - 1) : 0) |
+          (encoder->options.interlace == FLAG_TRUE ? AND_OF_INTERLACE_FLAG : 0), encoder->file);
+    if(frame->palette != NULL) {
+        putColorTable(encoder->file, frame->palette, frame->paletteSize, colorBits);
+    }
+
+    // Minimální velikost LZW kódu (GIF vyžaduje alespoň 2 bity)
+    encoder->minimumCodeSize = colorBits < 2 ? 2 : colorBits;
+    if(encoder->options.minimumCodeSize > encoder->minimumCodeSize) {
+        encoder->minimumCodeSize = encoder->options.minimumCodeSize;
+    }
+    fputc(encoder->minimumCodeSize, encoder->file);
+
+    // Úvodní clear kód s prázdným slovníkem
+    resetEncoderDictionary(encoder);
+    putLZWCode(encoder, (uint16_t)(1u << encoder->minimumCodeSize));
+    encoder->prefix = -1;
+
+    // Kódování řádků v pořadí průchodů
+    for(int pass = 0; pass < passCount; pass++) {
+        uint32_t row = passCount > 1 ? passStart[pass] : 0;
+        uint32_t step = passCount > 1 ? passStep[pass] : 1;
+        for(; row < frame->height; row += step) {
+            if(encodePixels(encoder, frame->indexes + (size_t)row * frame->stride, frame->width) != RETURN_SUCCESS) {
+                return encoder->error = RETURN_FAILURE;
+            }
+        }
+    }
+
+    // Zápis posledního řetězce a kódu EOI
+    if(encoder->prefix >= 0) {
+        putLZWCode(encoder, (uint16_t)encoder->prefix);
+    }
+    putLZWCode(encoder, (uint16_t)((1u << encoder->minimumCodeSize) + 1));
+    // Zápis zbylých bitů akumulátoru (buffer má vždy místo na 4 bajty)
+    if(encoder->dataSize + sizeof(uint32_t) > GIF_ENCODE_BUFFER_SIZE) {
+        flushSubBlocks(encoder, FLAG_FALSE);
+    }
+    while(encoder->bitCount > 0) {
+        encoder->data[encoder->dataSize++] = (uint8_t)encoder->bitBuffer;
+        encoder->bitBuffer >>= BYTE_BITS;
+        encoder->bitCount = encoder->bitCount > BYTE_BITS ? encoder->bitCount - BYTE_BITS : 0;
+    }
+    // Zápis všech sub-bloků a ukončujícího bajtu
+    flushSubBlocks(encoder, FLAG_TRUE);
+    fputc(BLOCK_TERMINATOR, encoder->file);
+
+    // Kontrola zápisu
+    if(ferror(encoder->file)) {
+        encoder->error = RETURN_FAILURE;
+    }
+    return encoder->error;
+}
+
+/*
+ * Funkce pro ukončení zápisu GIF souboru (zapíše ukončovací bajt)
+ *
+ * encoder - kodér
+ *
+ * Návratová hodnota:
+ *      0 - celý soubor byl zapsán
+ *     -1 - při zápisu došlo k chybě
+ */
+int finishGIFEncoder(tGIFEncoder *encoder) {
+    // Ukončovací bajt souboru
+    fputc(TRAILER, encoder->file);
+    // Kontrola zápisu
+    if(fflush(encoder->file) != 0 || ferror(encoder->file)) {
+        encoder->error = RETURN_FAILURE;
+    }
+    if(encoder->error != RETURN_SUCCESS) {
+        fprintf(stderr, "ERROR: GIF output could not be written.\n");
+    }
+    return encoder->error;
+}
+
+/*
+ * Funkce pro zápis obrazu indexů barev jako GIF souboru
+ *
+ * Obraz se zapíše options->frameCount krát jako blok přes celou
+ * logickou obrazovku.
+ *
+ * file        - výstupní soubor
+ * indexes     - indexy barev (řádky shora dolů bez zarovnání)
+ * width       - šířka obrazu
+ * height      - výška obrazu
+ * palette     - tabulka barev
+ * paletteSize - počet barev (1-256)
+ * options     - nastavení kodéru (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - chyba alokace nebo zápisu
+ */
+int encodeGIFImage(FILE *file, const uint8_t *indexes, uint16_t width, uint16_t height,
+                   const tRGB *palette, uint16_t paletteSize, const tGIFEncodeOptions *options) {
+    // Kodér (slovník je příliš velký pro zásobník)
+    tGIFEncoder *encoder = (tGIFEncoder*)malloc(sizeof(tGIFEncoder));
+    // Blok přes celou logickou obrazovku
+    tGIFEncodeFrame frame = {0, 0, width, height, indexes, width, NULL, 0, -1, 0};
+    // Výsledek zápisu
+    int result = RETURN_FAILURE;
+
+    // Kontrola alokace
+    if(encoder == NULL) {
+        fprintf(stderr, "ERROR: GIF encoder malloc failed.\n");
+        return RETURN_FAILURE;
+    }
+
+    // Zápis hlavičky, všech bloků a ukončovacího bajtu
+    if(startGIFEncoder(encoder, file, width, height, palette, paletteSize, options) == RETURN_SUCCESS) {
+        // Počet zápisů obrazu
+        uint32_t frameCount = encoder->options.frameCount > 1 ? encoder->options.frameCount : 1;
+        for(uint32_t index = 0; index < frameCount && addGIFFrame(encoder, &frame) == RETURN_SUCCESS; index++);
+        result = finishGIFEncoder(encoder);
+    }
+
+    // Uvolnění kodéru
+    free(encoder);
+    return result;
+}
+
+/*
+ * Funkce pro nalezení nebo přidání barvy 24bitového BMP do palety
+ *
+ * keys    - hashovací tabulka barev (BMP_COLOR_EMPTY - volná položka)
+ * values  - indexy barev v paletě
+ * palette - paleta
+ * size    - počet barev palety
+ * color   - barva (0xRRGGBB)
+ *
+ * Návratová hodnota:
+ *     index barvy, -1 pro více než 256 barev
+ */
+static int getColorIndex(uint32_t *keys, uint8_t *values, tRGB *palette, uint16_t *size, uint32_t color) {
+    // Pozice barvy v tabulce
+    uint32_t slot = (color * GIF_ENCODE_HASH_MULTIPLIER) >> (32 - BMP_COLOR_HASH_BITS);
+
+    // Hledání barvy nebo volné položky
+    while(keys[slot] != BMP_COLOR_EMPTY && keys[slot] != color) {
+        slot = (slot + 1) & (BMP_COLOR_HASH_SIZE - 1);
+    }
+    // Známá barva
+    if(keys[slot] == color) {
+        return values[slot];
+    }
+    // Plná paleta
+    if(*size == PALETTE_MAX_SIZE) {
+        return RETURN_FAILURE;
+    }
+    // Přidání barvy do palety
+    keys[slot] = color;
+    values[slot] = (uint8_t)*size;
+    palette[*size].r = (uint8_t)(color >> 16);
+    palette[*size].g = (uint8_t)(color >> 8);
+    palette[*size].b = (uint8_t)color;
+    return (*size)++;
+}
+
+/*
+ * Funkce pro převod řádku BMP na indexy barev
+ *
+ * row      - data řádku BMP
+ * indexes  - výstupní indexy barev
+ * width    - šířka řádku
+ * bitCount - počet bitů na pixel BMP
+ * keys     - hashovací tabulka barev (jen 24 bitů)
+ * values   - indexy barev v hashovací tabulce (jen 24 bitů)
+ * palette  - paleta (doplňuje se jen pro 24 bitů)
+ * size     - počet barev palety
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - index mimo paletu nebo více než 256 barev
+ */
+static int convertBMPRow(const uint8_t *row, uint8_t *indexes, uint32_t width, uint16_t bitCount,
+                         uint32_t *keys, uint8_t *values, tRGB *palette, uint16_t *size) {
+    // Průchod pixely řádku
+    for(uint32_t col = 0; col < width; col++) {
+        // Index barvy pixelu
+        int colorIndex;
+        if(bitCount == BIT_COUNT) {
+            // Barva pixelu v pořadí B, G, R
+            const uint8_t *pixel = row + (size_t)col * ONE_PIXEL_SIZE;
+            colorIndex = getColorIndex(keys, values, palette, size, ((uint32_t)pixel[2] << 16) | ((uint32_t)pixel[1] << 8) | pixel[0]);
+        } else {
+            // Index v bajtu od nejvyšších bitů
+            uint32_t bitPosition = col * bitCount;
+            colorIndex = (row[bitPosition / BYTE_BITS] >> (BYTE_BITS - bitCount - bitPosition % BYTE_BITS)) & ((1u << bitCount) - 1);
+            if(colorIndex >= *size) {
+                colorIndex = RETURN_FAILURE;
+            }
+        }
+        // Kontrola indexu
+        if(colorIndex < 0) {
+            fprintf(stderr, "ERROR: BMP has more than 256 colors or an index outside its palette.\n");
+            return RETURN_FAILURE;
+        }
+        indexes[col] = (uint8_t)colorIndex;
+    }
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro převod BMP na GIF
+ *
+ * Podporuje nekomprimované BMP s 1, 4 nebo 8 bity na pixel (paleta)
+ * a 24bitové BMP s nejvýše 256 barvami, řádky zdola nahoru i shora dolů.
+ *
+ * inputFile  - vstupní soubor (BMP)
+ * outputFile - výstupní soubor (GIF)
+ * options    - nastavení kodéru (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - nepodporovaný BMP soubor, chyba alokace nebo zápisu
+ */
+int bmp2gif(FILE *inputFile, FILE *outputFile, const tGIFEncodeOptions *options) {
+    // Hlavičky BMP souboru
+    uint8_t header[BMP_HEADER_SIZE];
+    // Paleta a hashovací tabulka barev 24bitového BMP
+    tRGB palette[PALETTE_MAX_SIZE];
+    uint16_t paletteSize = 0;
+    uint32_t keys[BMP_COLOR_HASH_SIZE];
+    uint8_t values[BMP_COLOR_HASH_SIZE];
+    // Data řádku a indexy barev obrazu
+    uint8_t *row = NULL;
+    uint8_t *indexes = NULL;
+    // Výsledek převodu
+    int result = RETURN_FAILURE;
+
+    // Načtení a kontrola hlaviček
+    if(fread(header, 1, BMP_HEADER_SIZE, inputFile) != BMP_HEADER_SIZE || memcmp(header, BMP_IDENTIFICATOR, 2) != 0) {
+        fprintf(stderr, "ERROR: Input is not a BMP file.\n");
+        return RETURN_FAILURE;
+    }
+    uint32_t dataOffset = getLE32(&header[10]);
+    uint32_t infoSize = getLE32(&header[14]);
+    int32_t width = (int32_t)getLE32(&header[18]);
+    int32_t height = (int32_t)getLE32(&header[22]);
+    uint16_t bitCount = getLE16(&header[28]);
+    uint32_t compression = getLE32(&header[30]);
+    uint32_t colorsUsed = getLE32(&header[46]);
+    // Obraz zapsaný shora dolů má zápornou výšku
+    uint8_t topDown = height < 0 ? FLAG_TRUE : FLAG_FALSE;
+    uint32_t rows = topDown == FLAG_TRUE ? (uint32_t)-(int64_t)height : (uint32_t)height;
+    if(infoSize < BITMAPINFOHEADER_SIZE || compression != COMPRESSION_METHOD ||
+       width <= 0 || width > UINT16_MAX || rows == 0 || rows > UINT16_MAX ||
+       (bitCount != PALETTE_BIT_COUNT_1 && bitCount != PALETTE_BIT_COUNT_4 && bitCount != PALETTE_BIT_COUNT_8 && bitCount != BIT_COUNT) ||
+       (bitCount != BIT_COUNT && colorsUsed > (1u << bitCount))) {
+        fprintf(stderr, "ERROR: Unsupported BMP format.\n");
+        return RETURN_FAILURE;
+    }
+
+    // Přeskočení rozšíření informační hlavičky
+    for(uint32_t index = BITMAPINFOHEADER_SIZE; index < infoSize; index++) {
+        fgetc(inputFile);
+    }
+    // Načtení palety BMP
+    uint32_t consumed = BITMAPFILEHEADER_SIZE + infoSize;
+    if(bitCount != BIT_COUNT) {
+        paletteSize = (uint16_t)(colorsUsed > 0 ? colorsUsed : (1u << bitCount));
+        for(uint16_t index = 0; index < paletteSize; index++) {
+            uint8_t color[BMP_COLOR_SIZE];
+            if(fread(color, 1, BMP_COLOR_SIZE, inputFile) != BMP_COLOR_SIZE) {
+                fprintf(stderr, "ERROR: Unexpected end of BMP file.\n");
+                return RETURN_FAILURE;
+            }
+            palette[index].b = color[0];
+            palette[index].g = color[1];
+            palette[index].r = color[2];
+        }
+        consumed += (uint32_t)paletteSize * BMP_COLOR_SIZE;
+    }
+    // Přeskočení bajtů před obrazovými daty
+    if(dataOffset < consumed) {
+        fprintf(stderr, "ERROR: Unsupported BMP format.\n");
+        return RETURN_FAILURE;
+    }
+    for(; consumed < dataOffset; consumed++) {
+        fgetc(inputFile);
+    }
+
+    // Alokace řádku a indexů obrazu
+    size_t rowSize = (((size_t)width * bitCount + 31) / 32) * ROW_MULT_SIZE;
+    row = (uint8_t*)malloc(rowSize);
+    indexes = (uint8_t*)malloc((size_t)width * rows);
+    if(row == NULL || indexes == NULL) {
+        fprintf(stderr, "ERROR: BMP malloc failed.\n");
+        free(row);
+        free(indexes);
+        return RETURN_FAILURE;
+    }
+    memset(keys, 0xFF, sizeof(keys));
+
+    // Převod řádků na indexy barev (řádky shora dolů)
+    uint32_t rowIndex = 0;
+    for(; rowIndex < rows; rowIndex++) {
+        uint32_t target = topDown == FLAG_TRUE ? rowIndex : rows - 1 - rowIndex;
+        if(fread(row, 1, rowSize, inputFile) != rowSize) {
+            fprintf(stderr, "ERROR: Unexpected end of BMP file.\n");
+            break;
+        }
+        if(convertBMPRow(row, indexes + (size_t)target * width, (uint32_t)width, bitCount, keys, values, palette, &paletteSize) != RETURN_SUCCESS) {
+            break;
+        }
+    }
+
+    // Zápis GIF souboru po převodu všech řádků
+    if(rowIndex == rows) {
+        result = encodeGIFImage(outputFile, indexes, (uint16_t)width, (uint16_t)rows, palette, paletteSize > 0 ? paletteSize : 1, options);
+    }
+
+    // Uvolnění dat
+    free(row);
+    free(indexes);
+    return result;
+}
@@ -0,0 +1,207 @@
+/*******************************************************************************
+*  Soubor:   gifencode.h                                                       *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Hlavičkový  soubor  kodéru  GIF89a. Kodér zapisuje indexy barev (obraz     *
+*  převodu nebo BMP soubor) s paletou jako GIF soubor čitelný převodem        *
+*  gif2bmp. Slovník LZW je hashovací tabulka, kódy se skládají v 64bitovém    *
+*  akumulátoru. Slouží ke generování testovacích souborů a zpětným testům.    *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef GIFENCODE_H
+#define GIFENCODE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "gif2bmp.h"
+
+// Počet položek hashovací tabulky slovníku (mocnina dvou, nejvýše
+// polovina zaplněna)
+#define GIF_ENCODE_HASH_SIZE 8192
+// Počet bitů klíče slovníku (12 bitů předchozího kódu a 8 bitů indexu)
+#define GIF_ENCODE_KEY_BITS 20
+// Největší generace slovníku uložitelná v klíči
+#define GIF_ENCODE_MAX_GENERATION ((1u << (32 - GIF_ENCODE_KEY_BITS)) - 1)
+// Velikost sub-bloku dat GIF
+#define GIF_ENCODE_SUB_BLOCK_SIZE 255
+// Velikost bufferu kódovaných dat (celé sub-bloky)
+#define GIF_ENCODE_BUFFER_SIZE (GIF_ENCODE_SUB_BLOCK_SIZE * 64)
+
+/*
+ * Struktura nastavení kodéru
+ *
+ * minimumCodeSize - minimální velikost LZW kódu (0 - podle velikosti
+ *                   palety, jinak 2-8 a alespoň počet bitů palety)
+ * clearInterval   - počet kódů, po kterých se zapíše clear kód
+ *                   (0 - jen po zaplnění slovníku)
+ * interlace       - příznak prokládaných bloků
+ * frameCount      - počet zápisů obrazu jako image bloků (0 nebo 1 -
+ *                   jeden blok), jen pro encodeGIFImage a bmp2gif
+ */
+typedef struct {
+    uint8_t minimumCodeSize;
+    uint32_t clearInterval;
+    uint8_t interlace;
+    uint32_t frameCount;
+} tGIFEncodeOptions;
+
+/*
+ * Struktura popisu jednoho zapisovaného image bloku
+ *
+ * left             - levá pozice bloku
+ * top              - horní pozice bloku
+ * width            - šířka bloku
+ * height           - výška bloku
+ * indexes          - indexy barev bloku (řádky shora dolů)
+ * stride           - vzdálenost začátků řádků indexů v bajtech
+ * palette          - lokální tabulka barev (NULL - globální tabulka)
+ * paletteSize      - počet barev lokální tabulky (1-256)
+ * transparentIndex - index průhledné barvy (-1 - bez bloku graphic control)
+ * delay            - doba zobrazení bloku v setinách sekundy
+ */
+typedef struct {
+    uint16_t left;
+    uint16_t top;
+    uint16_t width;
+    uint16_t height;
+    const uint8_t *indexes;
+    size_t stride;
+    const tRGB *palette;
+    uint16_t paletteSize;
+    int transparentIndex;
+    uint16_t delay;
+} tGIFEncodeFrame;
+
+/*
+ * Struktura kodéru GIF
+ *
+ * file            - výstupní soubor
+ * options         - nastavení kodéru
+ * width           - šířka logické obrazovky
+ * height          - výška logické obrazovky
+ * globalBits      - počet bitů globální tabulky barev
+ * hashKeys        - klíče slovníku (generace, předchozí kód, index barvy)
+ * hashCodes       - kódy řetězců slovníku
+ * generation      - generace slovníku (clear kód slovník vyprázdní
+ *                   zvýšením generace)
+ * minimumCodeSize - minimální velikost LZW kódu aktuálního bloku
+ * codeSize        - aktuální velikost LZW kódu
+ * nextCode        - první volný kód slovníku
+ * prefix          - kód dosud nezapsaného řetězce (-1 - žádný)
+ * codesSinceClear - počet kódů zapsaných od posledního clear kódu
+ * bitBuffer       - akumulátor bitů (nejnižší bit se zapíše první)
+ * bitCount        - počet platných bitů v akumulátoru
+ * data            - buffer kódovaných dat před rozdělením do sub-bloků
+ * dataSize        - počet bajtů v bufferu
+ * error           - stav kodéru (0 - bez chyby, -1 - chyba)
+ */
+typedef struct {
+    FILE *file;
+    tGIFEncodeOptions options;
+    uint16_t width;
+    uint16_t height;
+    uint8_t globalBits;
+    uint32_t hashKeys[GIF_ENCODE_HASH_SIZE];
+    uint16_t hashCodes[GIF_ENCODE_HASH_SIZE];
+    uint32_t generation;
+    uint8_t minimumCodeSize;
+    uint8_t codeSize;
+    uint16_t nextCode;
+    int32_t prefix;
+    uint32_t codesSinceClear;
+    uint64_t bitBuffer;
+    uint8_t bitCount;
+    uint8_t data[GIF_ENCODE_BUFFER_SIZE];
+    size_t dataSize;
+    int error;
+} tGIFEncoder;
+
+/*
+ * Funkce pro zahájení zápisu GIF souboru
+ *
+ * Zapíše signaturu, popis logické obrazovky a globální tabulku barev.
+ *
+ * encoder     - kodér (obsah se přepíše)
+ * file        - výstupní soubor
+ * width       - šířka logické obrazovky
+ * height      - výška logické obrazovky
+ * palette     - globální tabulka barev (NULL - bez globální tabulky)
+ * paletteSize - počet barev globální tabulky (1-256)
+ * options     - nastavení kodéru (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - chybné nastavení nebo chyba zápisu
+ */
+int startGIFEncoder(tGIFEncoder *encoder, FILE *file, uint16_t width, uint16_t height,
+                    const tRGB *palette, uint16_t paletteSize, const tGIFEncodeOptions *options);
+
+/*
+ * Funkce pro zápis jednoho image bloku
+ *
+ * encoder - kodér
+ * frame   - popis bloku
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - chybný blok (bez tabulky barev) nebo chyba zápisu
+ */
+int addGIFFrame(tGIFEncoder *encoder, const tGIFEncodeFrame *frame);
+
+/*
+ * Funkce pro ukončení zápisu GIF souboru (zapíše ukončovací bajt)
+ *
+ * encoder - kodér
+ *
+ * Návratová hodnota:
+ *      0 - celý soubor byl zapsán
+ *     -1 - při zápisu došlo k chybě
+ */
+int finishGIFEncoder(tGIFEncoder *encoder);
+
+/*
+ * Funkce pro zápis obrazu indexů barev jako GIF souboru
+ *
+ * Obraz se zapíše options->frameCount krát jako blok přes celou
+ * logickou obrazovku.
+ *
+ * file        - výstupní soubor
+ * indexes     - indexy barev (řádky shora dolů bez zarovnání)
+ * width       - šířka obrazu
+ * height      - výška obrazu
+ * palette     - tabulka barev
+ * paletteSize - počet barev (1-256)
+ * options     - nastavení kodéru (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - bez chyby
+ *     -1 - chyba alokace nebo zápisu
+ */
+int encodeGIFImage(FILE *file, const uint8_t *indexes, uint16_t width, uint16_t height,
+                   const tRGB *palette, uint16_t paletteSize, const tGIFEncodeOptions *options);
+
+/*
+ * Funkce pro převod BMP na GIF
+ *
+ * Podporuje nekomprimované BMP s 1, 4 nebo 8 bity na pixel (paleta)
+ * a 24bitové BMP s nejvýše 256 barvami, řádky zdola nahoru i shora dolů.
+ *
+ * inputFile  - vstupní soubor (BMP)
+ * outputFile - výstupní soubor (GIF)
+ * options    - nastavení kodéru (NULL pro výchozí nastavení)
+ *
+ * Návratová hodnota:
+ *      0 - převod proběhl v pořádku
+ *     -1 - nepodporovaný BMP soubor, chyba alokace nebo zápisu
+ */
+int bmp2gif(FILE *inputFile, FILE *outputFile, const tGIFEncodeOptions *options);
+
+#endif
@@ -0,0 +1,253 @@
+/*******************************************************************************
+*  Soubor:   gifinput.c                                                        *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Vstupní vrstva knihovny gif2bmp. Běžný soubor se mapuje do paměti celý,    *
+*  takže čtení bajtů je jen posun ukazatele. Vstup, který mapovat nelze       *
+*  (roura, terminál), se načítá po blocích velikosti GIF_INPUT_BUFFER_SIZE.   *
+*                                                                              *
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "gif2bmp.h"
+#include "gifinput.h"
+
+/*
+ * Funkce pro otevření vstupu nad souborem
+ *
+ * input - struktura vstupu
+ * file  - vstupní soubor
+ *
+ * Návratová hodnota:
+ *      0 - vstup je připraven
+ *     -1 - nepodařilo se alokovat buffer
+ */
+int openGIFInput(tGIFInput *input, FILE *file) {
+    // Informace o vstupním souboru
+    struct stat fileStat;
+    // Aktuální pozice ve vstupním souboru
+    off_t start = ftello(file);
+
+    // Vynulování struktury vstupu
+    memset(input, 0, sizeof(tGIFInput));
+    // Uložení vstupního souboru
+    input->file = file;
+    // Uložení počáteční pozice (-1 pro neposuvný vstup)
+    input->startOffset = start;
+
+    // Pokud se jedná o neprázdný běžný soubor, mapuje se do paměti
+    if(start >= 0 && fstat(fileno(file), &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > start) {
+        // Mapování celého souboru (offset mapování musí být zarovnán na stránku)
+        void *mapping = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        // Pokud se mapování podařilo
+        if(mapping != MAP_FAILED) {
+            // Soubor se čte sekvenčně
+            posix_madvise(mapping, (size_t)fileStat.st_size, POSIX_MADV_SEQUENTIAL);
+            // Uložení mapované oblasti
+            input->mapping = mapping;
+            input->mappingLength = (size_t)fileStat.st_size;
+            // Data začínají na aktuální pozici souboru
+            input->data = (const uint8_t*)mapping + start;
+            input->length = (size_t)(fileStat.st_size - start);
+            // Vstup je připraven
+            return RETURN_SUCCESS;
+        }
+    }
+
+    // Alokace bufferu pro blokové čtení
+    input->buffer = (uint8_t*)malloc(GIF_INPUT_BUFFER_SIZE);
+    // Kontrola alokace
+    if(input->buffer == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: input->buffer malloc failed.\n");
+        // Ukončení funkce s chybou
+        return RETURN_FAILURE;
+    }
+    // Buffer je zatím prázdný
+    input->data = input->buffer;
+
+    // Vstup je připraven
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro otevření vstupu nad daty v paměti
+ *
+ * input  - struktura vstupu
+ * data   - data GIF souboru
+ * length - délka dat
+ */
+void openGIFMemoryInput(tGIFInput *input, const uint8_t *data, size_t length) {
+    // Vynulování struktury vstupu (bez souboru, mapování i bufferu)
+    memset(input, 0, sizeof(tGIFInput));
+    // Data se čtou přímo z paměti volajícího
+    input->data = data;
+    input->length = length;
+}
+
+/*
+ * Funkce pro uzavření vstupu (soubor samotný zůstává otevřený)
+ *
+ * input - struktura vstupu
+ */
+void closeGIFInput(tGIFInput *input) {
+    // Pokud byl soubor mapován
+    if(input->mapping != NULL) {
+        // Zrušení mapování
+        munmap(input->mapping, input->mappingLength);
+        // Posun pozice souboru za přečtená data
+        fseeko(input->file, (off_t)(input->startOffset + input->offset), SEEK_SET);
+    }
+    // Uvolnění bufferu blokového čtení
+    free(input->buffer);
+    // Vynulování struktury vstupu
+    memset(input, 0, sizeof(tGIFInput));
+}
+
+/*
+ * Funkce pro návrat vstupu na začátek
+ *
+ * input - struktura vstupu
+ *
+ * Návratová hodnota:
+ *      0 - vstup se čte znovu od začátku
+ *     -1 - vstup nelze vrátit
+ */
+int rewindGIFInput(tGIFInput *input) {
+    // Blokově čtený vstup již přečtená data nemá
+    if(input->buffer != NULL) {
+        return RETURN_FAILURE;
+    }
+    // Mapovaná data a data v paměti se čtou znovu od počáteční pozice
+    input->position = 0;
+    input->offset = 0;
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro doplnění bufferu blokového čtení
+ *
+ * Nepřečtené bajty se přesunou na začátek bufferu a zbytek se doplní
+ * ze souboru.
+ *
+ * input - struktura vstupu
+ * count - počet bajtů, které mají být v bufferu k dispozici
+ *
+ * Návratová hodnota:
+ *      0 - buffer obsahuje alespoň count bajtů
+ *     -1 - vstup skončil dříve
+ */
+static int fillInputBuffer(tGIFInput *input, size_t count) {
+    // Počet dosud nepřečtených bajtů
+    size_t remaining = input->length - input->position;
+
+    // Mapovaný soubor ani data v paměti již další data nemají
+    if(input->buffer == NULL) {
+        return RETURN_FAILURE;
+    }
+
+    // Přesun nepřečtených bajtů na začátek bufferu
+    memmove(input->buffer, input->buffer + input->position, remaining);
+    input->position = 0;
+    input->length = remaining;
+
+    // Čtení dalších bloků, dokud není k dispozici požadovaný počet bajtů
+    while(input->length < count) {
+        // Načtení co největšího bloku
+        size_t readBytes = fread(input->buffer + input->length, 1, GIF_INPUT_BUFFER_SIZE - input->length, input->file);
+        // Pokud již nelze nic načíst
+        if(readBytes == 0) {
+            return RETURN_FAILURE;
+        }
+        // Zvýšení počtu platných bajtů
+        input->length += readBytes;
+    }
+
+    // Buffer obsahuje požadovaná data
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro získání souvislého úseku bajtů vstupu
+ *
+ * input - struktura vstupu
+ * count - počet požadovaných bajtů (nejvýše GIF_INPUT_BUFFER_SIZE)
+ *
+ * Návratová hodnota:
+ *     ukazatel na bajty, NULL při předčasném konci vstupu
+ */
+const uint8_t *getInputBytes(tGIFInput *input, size_t count) {
+    // Ukazatel na vrácená data
+    const uint8_t *bytes = NULL;
+
+    // Pokud požadovaná data nejsou celá k dispozici, doplní se
+    if(input->length - input->position < count) {
+        // Požadavek větší než buffer nelze splnit
+        if(count > GIF_INPUT_BUFFER_SIZE && input->buffer != NULL) {
+            return NULL;
+        }
+        // Doplnění bufferu
+        if(fillInputBuffer(input, count) != RETURN_SUCCESS) {
+            return NULL;
+        }
+    }
+
+    // Úsek začíná na aktuální pozici
+    bytes = input->data + input->position;
+    // Posun za vrácený úsek
+    input->position += count;
+    input->offset += count;
+
+    // Navrácení úseku
+    return bytes;
+}
+
+/*
+ * Funkce pro přeskočení bajtů vstupu
+ *
+ * input - struktura vstupu
+ * count - počet přeskakovaných bajtů
+ *
+ * Návratová hodnota:
+ *      0 - bajty byly přeskočeny
+ *     -1 - předčasný konec vstupu
+ */
+int skipInputBytes(tGIFInput *input, size_t count) {
+    // Dokud zbývá něco k přeskočení
+    while(count > 0) {
+        // Počet bajtů dostupných bez čtení
+        size_t available = input->length - input->position;
+
+        // Pokud nejsou žádné bajty dostupné, doplní se buffer
+        if(available == 0) {
+            // Doplnění alespoň jednoho bajtu
+            if(fillInputBuffer(input, 1) != RETURN_SUCCESS) {
+                return RETURN_FAILURE;
+            }
+            available = input->length - input->position;
+        }
+        // Přeskočení dostupné části
+        if(available > count) {
+            available = count;
+        }
+        input->position += available;
+        input->offset += available;
+        count -= available;
+    }
+
+    // Všechny bajty byly přeskočeny
+    return RETURN_SUCCESS;
+}
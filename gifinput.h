@@ -0,0 +1,122 @@
+/*******************************************************************************
+*  Soubor:   gifinput.h                                                        *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Hlavičkový  soubor  vstupní  vrstvy  knihovny gif2bmp. Běžné soubory se    *
+*  mapují do paměti (mmap), ostatní vstupy (roury, terminál) se čtou po       *
+*  velkých blocích, data již uložená v paměti se čtou přímo bez kopírování.   *
+*  Knihovna pak čte vstup po souvislých úsecích bajtů.                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef GIFINPUT_H
+#define GIFINPUT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Velikost bloku pro čtení vstupu, který nelze mapovat do paměti
+#define GIF_INPUT_BUFFER_SIZE (64 * 1024)
+
+/*
+ * Struktura vstupu knihovny
+ *
+ * file          - vstupní soubor (NULL pro data v paměti)
+ * data          - dostupná data (mapovaný soubor, data v paměti nebo
+ *                 blokový buffer)
+ * length        - počet platných bajtů v data
+ * position      - index dalšího nepřečteného bajtu v data
+ * offset        - počet bajtů přečtených od začátku převodu
+ * startOffset   - pozice v souboru, od které se čte
+ * buffer        - blokový buffer (NULL pro mapovaný soubor a data v paměti)
+ * mapping       - začátek mapované oblasti (NULL bez mapování)
+ * mappingLength - délka mapované oblasti
+ */
+typedef struct {
+    FILE *file;
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+    uint64_t offset;
+    int64_t startOffset;
+    uint8_t *buffer;
+    void *mapping;
+    size_t mappingLength;
+} tGIFInput;
+
+/*
+ * Funkce pro otevření vstupu nad souborem
+ *
+ * input - struktura vstupu
+ * file  - vstupní soubor
+ *
+ * Návratová hodnota:
+ *      0 - vstup je připraven
+ *     -1 - nepodařilo se alokovat buffer
+ */
+int openGIFInput(tGIFInput *input, FILE *file);
+
+/*
+ * Funkce pro otevření vstupu nad daty v paměti
+ *
+ * Data se nekopírují a musí existovat až do uzavření vstupu.
+ *
+ * input  - struktura vstupu
+ * data   - data GIF souboru
+ * length - délka dat
+ */
+void openGIFMemoryInput(tGIFInput *input, const uint8_t *data, size_t length);
+
+/*
+ * Funkce pro uzavření vstupu (soubor samotný zůstává otevřený)
+ *
+ * input - struktura vstupu
+ */
+void closeGIFInput(tGIFInput *input);
+
+/*
+ * Funkce pro návrat vstupu na začátek
+ *
+ * Vrátit lze jen vstup mapovaný do paměti nebo data v paměti.
+ *
+ * input - struktura vstupu
+ *
+ * Návratová hodnota:
+ *      0 - vstup se čte znovu od začátku
+ *     -1 - vstup nelze vrátit
+ */
+int rewindGIFInput(tGIFInput *input);
+
+/*
+ * Funkce pro získání souvislého úseku bajtů vstupu
+ *
+ * Vrácený ukazatel je platný do dalšího volání funkcí vstupu.
+ *
+ * input - struktura vstupu
+ * count - počet požadovaných bajtů (nejvýše GIF_INPUT_BUFFER_SIZE)
+ *
+ * Návratová hodnota:
+ *     ukazatel na bajty, NULL při předčasném konci vstupu
+ */
+const uint8_t *getInputBytes(tGIFInput *input, size_t count);
+
+/*
+ * Funkce pro přeskočení bajtů vstupu
+ *
+ * input - struktura vstupu
+ * count - počet přeskakovaných bajtů
+ *
+ * Návratová hodnota:
+ *      0 - bajty byly přeskočeny
+ *     -1 - předčasný konec vstupu
+ */
+int skipInputBytes(tGIFInput *input, size_t count);
+
+#endif
@@ -0,0 +1,318 @@
+/*******************************************************************************
+*  Soubor:   gifscan.c                                                         *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Předběžný průchod bloky GIF souboru. Sub-bloky se pouze přeskakují podle   *
+*  jejich velikostí, takže průchod je mnohem rychlejší než dekódování. Bloky  *
+*  se pak procházejí od posledního a blok, jehož obdélník pokryjí pozdější    *
+*  neprůhledné bloky, se označí jako překrytý.                                *
+*                                                                              *
+*******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include "gif2bmp.h"
+#include "gifscan.h"
+
+/*
+ * Funkce pro přeskočení sub-bloků až po ukončující bajt
+ *
+ * data     - procházená data
+ * length   - délka dat
+ * position - pozice první velikosti sub-bloku, po návratu pozice za
+ *            ukončujícím bajtem
+ *
+ * Návratová hodnota:
+ *      0 - sub-bloky byly přeskočeny
+ *     -1 - data skončila dříve
+ */
+static int skipSubBlocks(const uint8_t *data, size_t length, size_t *position) {
+    // Dokud nejsou data u konce
+    while(*position < length) {
+        // Velikost sub-bloku
+        uint8_t blockSize = data[(*position)++];
+        // Ukončující bajt
+        if(blockSize == BLOCK_TERMINATOR) {
+            return RETURN_SUCCESS;
+        }
+        // Přeskočení dat sub-bloku
+        *position += blockSize;
+    }
+
+    // Data skončila před ukončujícím bajtem
+    return RETURN_FAILURE;
+}
+
+/*
+ * Funkce pro přidání image bloku do výsledku průchodu
+ *
+ * scan  - výsledek průchodu
+ * frame - přidávaný blok
+ *
+ * Návratová hodnota:
+ *      0 - blok byl přidán
+ *     -1 - chyba alokace
+ */
+static int addGIFFrame(tGIFScan *scan, const tGIFFrame *frame) {
+    // Pokud je pole plné, zvětší se na dvojnásobek
+    if(scan->count == scan->capacity) {
+        // Nová kapacita pole
+        uint32_t capacity = (scan->capacity == 0) ? GIF_SCAN_ALLOC_SIZE : scan->capacity * 2;
+        // Realokace pole
+        tGIFFrame *frames = (tGIFFrame*)realloc(scan->frames, sizeof(tGIFFrame) * capacity);
+        // Kontrola alokace
+        if(frames == NULL) {
+            return RETURN_FAILURE;
+        }
+        scan->frames = frames;
+        scan->capacity = capacity;
+    }
+
+    // Uložení bloku na konec pole
+    scan->frames[scan->count++] = *frame;
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro zjištění, zda obdélník pokrývají neprůhledné bloky
+ *
+ * Od obdélníku se postupně odečítají obdélníky neprůhledných bloků,
+ * zbytek se udržuje jako seznam nepřekrytých částí. Pokud by částí
+ * bylo více než GIF_SCAN_MAX_PIECES, obdélník se považuje za nepřekrytý.
+ *
+ * rect   - testovaný obdélník
+ * frames - bloky, které se mohou překrývat
+ * count  - počet bloků
+ *
+ * Návratová hodnota:
+ *     FLAG_TRUE - obdélník je zcela překryt, jinak FLAG_FALSE
+ */
+static uint8_t isRectCovered(tGIFRect rect, const tGIFFrame *frames, uint32_t count) {
+    // Nepřekryté části obdélníku (dvě pole pro střídání)
+    tGIFRect pieces[2][GIF_SCAN_MAX_PIECES];
+    // Počet nepřekrytých částí
+    uint32_t pieceCount = 1;
+    // Index aktuálního pole částí
+    uint8_t actual = 0;
+
+    // Na začátku je nepřekrytý celý obdélník
+    pieces[actual][0] = rect;
+
+    // Odečtení všech neprůhledných bloků
+    for(uint32_t index = 0; index < count && pieceCount > 0; index++) {
+        // Obdélník bloku
+        tGIFRect cover = frames[index].visible;
+        // Počet částí po odečtení bloku
+        uint32_t nextCount = 0;
+
+        // Průhledný blok nic nepřekrývá
+        if(frames[index].opaque != FLAG_TRUE) {
+            continue;
+        }
+        // Odečtení bloku od všech částí
+        for(uint32_t piece = 0; piece < pieceCount; piece++) {
+            // Aktuální část
+            tGIFRect part = pieces[actual][piece];
+            // Výsledné části (nad, pod, vlevo a vpravo od bloku)
+            tGIFRect rest[4];
+            // Počet výsledných částí
+            uint32_t restCount = 0;
+
+            // Část se s blokem nepřekrývá, zůstává celá
+            if(cover.right <= part.left || cover.left >= part.right || cover.bottom <= part.top || cover.top >= part.bottom) {
+                rest[restCount++] = part;
+            } else {
+                // Svislý rozsah překrytí
+                uint32_t top = (cover.top > part.top) ? cover.top : part.top;
+                uint32_t bottom = (cover.bottom < part.bottom) ? cover.bottom : part.bottom;
+                // Pás nad blokem
+                if(part.top < top) {
+                    rest[restCount++] = (tGIFRect){part.left, part.top, part.right, top};
+                }
+                // Pás pod blokem
+                if(bottom < part.bottom) {
+                    rest[restCount++] = (tGIFRect){part.left, bottom, part.right, part.bottom};
+                }
+                // Část vlevo od bloku
+                if(part.left < cover.left) {
+                    rest[restCount++] = (tGIFRect){part.left, top, cover.left, bottom};
+                }
+                // Část vpravo od bloku
+                if(cover.right < part.right) {
+                    rest[restCount++] = (tGIFRect){cover.right, top, part.right, bottom};
+                }
+            }
+            // Příliš mnoho částí - obdélník se považuje za nepřekrytý
+            if(nextCount + restCount > GIF_SCAN_MAX_PIECES) {
+                return FLAG_FALSE;
+            }
+            // Uložení výsledných částí
+            memcpy(&pieces[1 - actual][nextCount], rest, sizeof(tGIFRect) * restCount);
+            nextCount += restCount;
+        }
+        // Výsledné části se stávají aktuálními
+        actual = 1 - actual;
+        pieceCount = nextCount;
+    }
+
+    // Obdélník je překryt, pokud z něj nic nezbylo
+    return (pieceCount == 0) ? FLAG_TRUE : FLAG_FALSE;
+}
+
+/*
+ * Funkce pro předběžný průchod bloky GIF souboru
+ *
+ * scan            - výsledek průchodu (obsah se přepíše)
+ * data            - data souboru od prvního bloku (za tabulkou barev)
+ * length          - délka dat
+ * screenWidth     - šířka logické obrazovky
+ * screenHeight    - výška logické obrazovky
+ *
+ * Návratová hodnota:
+ *      0 - průchod proběhl (překryté bloky jsou označeny)
+ *     -1 - chyba alokace (žádný blok není označen)
+ */
+int scanGIFFrames(tGIFScan *scan, const uint8_t *data, size_t length, uint32_t screenWidth, uint32_t screenHeight) {
+    // Pozice v datech
+    size_t position = 0;
+    // Příznak průhlednosti z posledního bloku graphic control
+    uint8_t transparentFlag = FLAG_FALSE;
+    // Příznak pokračování průchodu
+    uint8_t scanning = FLAG_TRUE;
+
+    // Výsledek je zatím prázdný
+    memset(scan, 0, sizeof(tGIFScan));
+
+    // Průchod bloky až po konec souboru nebo neznámý blok
+    while(scanning == FLAG_TRUE && position < length) {
+        // Oddělovač bloku
+        uint8_t blockSeparator = data[position++];
+
+        // Blok s obrazovými daty
+        if(blockSeparator == IMAGE_BLOCK_ID) {
+            // Zaznamenávaný blok
+            tGIFFrame frame;
+            memset(&frame, 0, sizeof(tGIFFrame));
+            frame.offset = position - 1;
+            // Popis bloku musí být celý
+            if(length - position < IMAGE_DESCRIPTOR_SIZE) {
+                break;
+            }
+            const uint8_t *descriptor = data + position;
+            position += IMAGE_DESCRIPTOR_SIZE;
+            // Obdélník bloku
+            uint32_t left = (uint32_t)(descriptor[0] | (descriptor[1] << 8));
+            uint32_t top = (uint32_t)(descriptor[2] | (descriptor[3] << 8));
+            uint32_t width = (uint32_t)(descriptor[4] | (descriptor[5] << 8));
+            uint32_t height = (uint32_t)(descriptor[6] | (descriptor[7] << 8));
+            // Přeskočení lokální tabulky barev
+            if((descriptor[8] & AND_OF_COLOR_TABLE_FLAG) == AND_OF_COLOR_TABLE_FLAG) {
+                position += (size_t)3 * (2u << (descriptor[8] & AND_OF_COLOR_TABLE_SIZE));
+            }
+            // Přeskočení minimální velikosti LZW kódu a dat bloku
+            frame.dataOffset = position;
+            position++;
+            if(position > length || skipSubBlocks(data, length, &position) != RETURN_SUCCESS) {
+                break;
+            }
+            frame.endOffset = position;
+            frame.width = width;
+            frame.height = height;
+            // Obdélník oříznutý na logickou obrazovku
+            frame.visible.left = (left < screenWidth) ? left : screenWidth;
+            frame.visible.top = (top < screenHeight) ? top : screenHeight;
+            frame.visible.right = (left + width < screenWidth) ? left + width : screenWidth;
+            frame.visible.bottom = (top + height < screenHeight) ? top + height : screenHeight;
+            // První blok je vždy neprůhledný
+            frame.opaque = (scan->count == 0 || transparentFlag != FLAG_TRUE) ? FLAG_TRUE : FLAG_FALSE;
+            // Příznak prokládání
+            frame.interlaced = ((descriptor[8] & AND_OF_INTERLACE_FLAG) == AND_OF_INTERLACE_FLAG) ? FLAG_TRUE : FLAG_FALSE;
+            // Uložení bloku
+            if(addGIFFrame(scan, &frame) != RETURN_SUCCESS) {
+                freeGIFScan(scan);
+                return RETURN_FAILURE;
+            }
+        } else if(blockSeparator == EXTENSION_BLOCK_ID && position < length) {
+            // Blok rozšíření podle označení
+            switch(data[position++]) {
+                // Graphic control má pevnou velikost
+                case GRAPHIC_CONTROL_BLOCK_ID: {
+                    if(length - position < GRAPHIC_CONTROL_BLOCK_SIZE) {
+                        scanning = FLAG_FALSE;
+                        break;
+                    }
+                    transparentFlag = data[position + 1] & AND_OF_TRANSPARENT_FLAG;
+                    position += GRAPHIC_CONTROL_BLOCK_SIZE;
+                    break;
+                }
+                // Komentář obsahuje jen sub-bloky
+                case COMMENT_BLOCK_ID: {
+                    scanning = (skipSubBlocks(data, length, &position) == RETURN_SUCCESS) ? FLAG_TRUE : FLAG_FALSE;
+                    break;
+                }
+                // Prostý text má hlavičku a sub-bloky
+                case PLAIN_TEXT_BLOCK_ID: {
+                    position += PLAIN_TEXT_BLOCK_SIZE;
+                    scanning = (position <= length && skipSubBlocks(data, length, &position) == RETURN_SUCCESS) ? FLAG_TRUE : FLAG_FALSE;
+                    break;
+                }
+                // Aplikace má velikost, identifikátor, kód a sub-bloky
+                case APPLICATION_BLOCK_ID: {
+                    position += 1 + APPLICATION_IDENTIFIER_LENGTH + APPLICATION_CODE_LENGTH;
+                    scanning = (position <= length && skipSubBlocks(data, length, &position) == RETURN_SUCCESS) ? FLAG_TRUE : FLAG_FALSE;
+                    break;
+                }
+                // Převod na neznámém rozšíření končí
+                default: {
+                    scanning = FLAG_FALSE;
+                    break;
+                }
+            }
+        } else {
+            // Konec souboru nebo neznámý blok - převod zde končí
+            break;
+        }
+    }
+
+    // Označení překrytých bloků od předposledního
+    for(uint32_t index = scan->count; index-- > 0; ) {
+        // Obdélník bloku
+        tGIFRect rect = scan->frames[index].visible;
+        // Blok mimo logickou obrazovku nebo pokrytý pozdějšími bloky
+        if(rect.left >= rect.right || rect.top >= rect.bottom ||
+           isRectCovered(rect, scan->frames + index + 1, scan->count - index - 1) == FLAG_TRUE) {
+            scan->frames[index].skip = FLAG_TRUE;
+            scan->skipCount++;
+            // Pozdější bloky zasahující do obdélníku se označí jako
+            // překrývající (převod ověří, že je vykreslily celé)
+            for(uint32_t later = index + 1; later < scan->count; later++) {
+                tGIFRect cover = scan->frames[later].visible;
+                if(scan->frames[later].opaque == FLAG_TRUE &&
+                   cover.left < rect.right && cover.right > rect.left && cover.top < rect.bottom && cover.bottom > rect.top) {
+                    scan->frames[later].covering = FLAG_TRUE;
+                }
+            }
+        }
+    }
+
+    // Průchod proběhl
+    return RETURN_SUCCESS;
+}
+
+/*
+ * Funkce pro uvolnění výsledku předběžného průchodu
+ *
+ * scan - výsledek průchodu
+ */
+void freeGIFScan(tGIFScan *scan) {
+    // Uvolnění pole bloků
+    free(scan->frames);
+    // Vynulování výsledku
+    memset(scan, 0, sizeof(tGIFScan));
+}
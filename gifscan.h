@@ -0,0 +1,109 @@
+/*******************************************************************************
+*  Soubor:   gifscan.h                                                         *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Hlavičkový  soubor  předběžného  průchodu  bloky GIF souboru. Průchod bez  *
+*  dekódování zaznamená obdélník, průhlednost a pozici každého image bloku    *
+*  a označí bloky, které pozdější neprůhledné bloky zcela překryjí - ty se    *
+*  pak nemusí dekódovat.                                                      *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef GIFSCAN_H
+#define GIFSCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Počáteční počet bloků, pro které se alokuje místo
+#define GIF_SCAN_ALLOC_SIZE 16
+// Největší počet nepřekrytých částí bloku při výpočtu překrytí
+#define GIF_SCAN_MAX_PIECES 64
+
+/*
+ * Struktura obdélníku na logické obrazovce (pravý a dolní okraj nepatří
+ * do obdélníku)
+ */
+typedef struct {
+    uint32_t left;
+    uint32_t top;
+    uint32_t right;
+    uint32_t bottom;
+} tGIFRect;
+
+/*
+ * Struktura jednoho image bloku
+ *
+ * offset     - pozice oddělovače bloku od začátku procházených dat
+ * dataOffset - pozice minimální velikosti LZW kódu (za tabulkou barev)
+ * endOffset  - pozice za ukončujícím bajtem dat bloku
+ * width      - šířka bloku
+ * height     - výška bloku
+ * visible    - obdélník bloku oříznutý na logickou obrazovku
+ * opaque     - příznak neprůhledného bloku
+ * interlaced - příznak prokládaného bloku
+ * skip       - příznak bloku zcela překrytého pozdějšími bloky
+ * covering   - příznak bloku, na jehož překrytí spoléhá některý
+ *              přeskočený blok
+ */
+typedef struct {
+    uint64_t offset;
+    uint64_t dataOffset;
+    uint64_t endOffset;
+    uint32_t width;
+    uint32_t height;
+    tGIFRect visible;
+    uint8_t opaque;
+    uint8_t interlaced;
+    uint8_t skip;
+    uint8_t covering;
+} tGIFFrame;
+
+/*
+ * Struktura výsledku předběžného průchodu
+ *
+ * frames    - pole image bloků v pořadí v souboru
+ * count     - počet image bloků
+ * capacity  - počet bloků, pro které je alokováno místo
+ * skipCount - počet překrytých bloků
+ */
+typedef struct {
+    tGIFFrame *frames;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t skipCount;
+} tGIFScan;
+
+/*
+ * Funkce pro předběžný průchod bloky GIF souboru
+ *
+ * Bloky se procházejí stejně jako při převodu (včetně ukončení průchodu
+ * na neznámém bloku), průhlednost se řídí posledním blokem graphic
+ * control. Zkrácený soubor nevadí, zaznamenají se jen celé bloky.
+ *
+ * scan            - výsledek průchodu (obsah se přepíše)
+ * data            - data souboru od prvního bloku (za tabulkou barev)
+ * length          - délka dat
+ * screenWidth     - šířka logické obrazovky
+ * screenHeight    - výška logické obrazovky
+ *
+ * Návratová hodnota:
+ *      0 - průchod proběhl (překryté bloky jsou označeny)
+ *     -1 - chyba alokace (žádný blok není označen)
+ */
+int scanGIFFrames(tGIFScan *scan, const uint8_t *data, size_t length, uint32_t screenWidth, uint32_t screenHeight);
+
+/*
+ * Funkce pro uvolnění výsledku předběžného průchodu
+ *
+ * scan - výsledek průchodu
+ */
+void freeGIFScan(tGIFScan *scan);
+
+#endif
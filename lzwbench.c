@@ -0,0 +1,202 @@
+/*******************************************************************************
+*  Soubor:   lzwbench.c                                                        *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Mikrobenchmark  čtečky  LZW kódů (lzwbits.h). Porovnává čtení kódů po      *
+*  jednotlivých bitech s čtením přes 64bitový akumulátor pro všechny          *
+*  velikosti kódu 2-12 bitů a ověřuje, že obě metody vrací stejné kódy.        *
+*                                                                              *
+*******************************************************************************/
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include "lzwbits.h"
+
+// Velikost testovacích dat v bajtech (16 MiB)
+#define BENCH_DATA_SIZE (16 * 1024 * 1024)
+// Počet opakování měření pro každou velikost kódu
+#define BENCH_REPEAT 4
+// Nejmenší měřená velikost kódu
+#define BENCH_MIN_CODE_SIZE 2
+// Největší měřená velikost kódu
+#define BENCH_MAX_CODE_SIZE 12
+
+/*
+ * Funkce pro čtení kódů po jednotlivých bitech (původní metoda dekodéru)
+ *
+ * data     - testovací data
+ * length   - délka dat v bajtech
+ * codeSize - velikost kódu v bitech
+ *
+ * Návratová hodnota:
+ *     kontrolní součet přečtených kódů
+ */
+uint64_t readBitByBit(const uint8_t *data, size_t length, uint8_t codeSize) {
+    // Kontrolní součet kódů
+    uint64_t checksum = 0;
+    // Index aktuálně čteného bajtu
+    size_t actualIndex = 0;
+    // Bitová maska aktuálně čteného bitu
+    uint16_t actualBitMask = 0x1;
+    // Počet celých kódů v datech
+    size_t codeCount = (length * 8) / codeSize;
+
+    // Cyklus čtení všech celých kódů
+    for(size_t codeIndex = 0; codeIndex < codeCount; codeIndex++) {
+        // Aktuálně skládaný kód
+        uint32_t code = 0;
+        // Skládání kódu po bitech
+        for(uint8_t bitIndex = 0; bitIndex < codeSize; bitIndex++) {
+            // Pokud je aktuální bit nastaven
+            if((data[actualIndex] & actualBitMask) > 0) {
+                // Přidání bitu do kódu
+                code |= (1u << bitIndex);
+            }
+            // Posun masky na další bit
+            actualBitMask = actualBitMask << 1;
+            // Pokud byl přečten celý bajt
+            if(actualBitMask == 0x100) {
+                // Návrat masky na první bit a posun na další bajt
+                actualBitMask = 0x1;
+                actualIndex++;
+            }
+        }
+        // Započtení kódu do kontrolního součtu
+        checksum = checksum * 31 + code;
+    }
+
+    // Navrácení kontrolního součtu
+    return checksum;
+}
+
+/*
+ * Funkce pro čtení kódů čtečkou s 64bitovým akumulátorem
+ *
+ * data     - testovací data
+ * length   - délka dat v bajtech
+ * codeSize - velikost kódu v bitech
+ *
+ * Návratová hodnota:
+ *     kontrolní součet přečtených kódů
+ */
+uint64_t readWithReader(const uint8_t *data, size_t length, uint8_t codeSize) {
+    // Kontrolní součet kódů
+    uint64_t checksum = 0;
+    // Čtečka LZW kódů
+    tLZWBitReader reader;
+    // Aktuálně přečtený kód
+    uint16_t code = 0;
+
+    // Inicializace čtečky nad testovacími daty
+    initLZWBitReader(&reader, data, length, codeSize);
+    // Čtení všech celých kódů
+    while(readLZWCode(&reader, &code)) {
+        // Započtení kódu do kontrolního součtu
+        checksum = checksum * 31 + code;
+    }
+
+    // Navrácení kontrolního součtu
+    return checksum;
+}
+
+/*
+ * Funkce pro výpočet propustnosti v MB/s
+ *
+ * length - počet zpracovaných bajtů v jednom opakování
+ * ticks  - naměřený čas všech opakování (clock)
+ */
+double throughput(size_t length, clock_t ticks) {
+    // Naměřený čas v sekundách
+    double seconds = (double)ticks / CLOCKS_PER_SEC;
+    // Ochrana proti dělení nulou
+    if(seconds <= 0) {
+        return 0;
+    }
+    // Výpočet propustnosti
+    return ((double)length * BENCH_REPEAT) / (seconds * 1e6);
+}
+
+/*
+ * Funkce main - spuštění mikrobenchmarku
+ *
+ * Návratová hodnota:
+ *     EXIT_SUCCESS - obě metody vrátily stejné kódy
+ *     EXIT_FAILURE - chyba alokace nebo neshoda kódů
+ */
+int main(void) {
+    // Alokace testovacích dat
+    uint8_t *data = (uint8_t*)malloc(BENCH_DATA_SIZE);
+    // Kontrola alokace
+    if(data == NULL) {
+        // Tisk chyby
+        fprintf(stderr, "ERROR: data malloc failed.\n");
+        // Konec programu s chybou
+        return EXIT_FAILURE;
+    }
+
+    // Naplnění dat reprodukovatelnou pseudonáhodnou posloupností
+    uint32_t seed = 0x12345678;
+    for(size_t index = 0; index < BENCH_DATA_SIZE; index++) {
+        // Lineární kongruenční generátor
+        seed = seed * 1103515245u + 12345u;
+        data[index] = (uint8_t)(seed >> 16);
+    }
+
+    // Hlavička výsledků
+    printf("code size   bit-by-bit MB/s   64-bit reader MB/s   speedup\n");
+
+    // Měření pro všechny velikosti kódu
+    for(uint8_t codeSize = BENCH_MIN_CODE_SIZE; codeSize <= BENCH_MAX_CODE_SIZE; codeSize++) {
+        // Kontrolní součty obou metod
+        uint64_t bitChecksum = 0;
+        uint64_t readerChecksum = 0;
+
+        // Měření čtení po bitech
+        clock_t start = clock();
+        for(int repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+            // Změna prvního bajtu brání překladači sloučit opakování
+            data[0] = (uint8_t)repeat;
+            bitChecksum += readBitByBit(data, BENCH_DATA_SIZE, codeSize);
+        }
+        clock_t bitTicks = clock() - start;
+
+        // Měření čtení přes akumulátor
+        start = clock();
+        for(int repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+            // Změna prvního bajtu brání překladači sloučit opakování
+            data[0] = (uint8_t)repeat;
+            readerChecksum += readWithReader(data, BENCH_DATA_SIZE, codeSize);
+        }
+        clock_t readerTicks = clock() - start;
+
+        // Kontrola shody přečtených kódů
+        if(bitChecksum != readerChecksum) {
+            // Tisk chyby
+            fprintf(stderr, "ERROR: checksum mismatch for code size %d.\n", codeSize);
+            // Uvolnění dat a konec programu s chybou
+            free(data);
+            return EXIT_FAILURE;
+        }
+
+        // Tisk výsledků pro aktuální velikost kódu
+        printf("%9d   %15.1f   %18.1f   %6.2fx\n", codeSize,
+               throughput(BENCH_DATA_SIZE, bitTicks),
+               throughput(BENCH_DATA_SIZE, readerTicks),
+               readerTicks > 0 ? (double)bitTicks / readerTicks : 0.0);
+    }
+
+    // Uvolnění testovacích dat
+    free(data);
+
+    // Konec programu bez chyby
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/*******************************************************************************
+*  Soubor:   lzwbits.h                                                         *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Čtečka  LZW  kódů  proměnné  délky  z  bitového  proudu  GIF (LSB first).  *
+*  Bajty  se  doplňují  do  64bitového  akumulátoru  a  celý kód se získá     *
+*  jedním posunem a maskou, místo skládání kódu po jednotlivých bitech.        *
+*  Data  mohou  přicházet po úsecích (např. sub-blocích GIF), další úsek se   *
+*  vyžádá funkcí pro doplnění až po vyčerpání předchozího.                     *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef LZWBITS_H
+#define LZWBITS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Počet bitů akumulátoru čtečky
+#define LZW_BIT_BUFFER_SIZE 64
+// Počet bajtů načtených najednou rychlou cestou doplnění akumulátoru
+#define LZW_REFILL_BYTES 8
+
+/*
+ * Funkce pro získání dalšího úseku komprimovaných dat
+ *
+ * source - zdroj dat předaný při inicializaci čtečky
+ * data   - ukazatel pro uložení začátku dalšího úseku
+ *
+ * Návratová hodnota:
+ *     délka dalšího úseku v bajtech, 0 pro konec dat
+ */
+typedef size_t (*tLZWFillFunction)(void *source, const uint8_t **data);
+
+/*
+ * Struktura čítačů dekódování LZW dat (dekódování je jen zvyšuje)
+ *
+ * codes      - počet načtených kódů (včetně clear a EOI kódů)
+ * clearCodes - počet clear kódů
+ * resets     - počet reinicializací slovníku (začátek dat a clear kódy)
+ */
+typedef struct {
+    uint64_t codes;
+    uint64_t clearCodes;
+    uint64_t resets;
+} tLZWDecodeStats;
+
+/*
+ * Struktura čtečky LZW kódů
+ *
+ * data     - čtený souvislý úsek komprimovaných dat
+ * length   - délka úseku dat v bajtech
+ * position - index následujícího nenačteného bajtu úseku
+ * buffer   - akumulátor bitů (nejnižší bit je další bit proudu)
+ * bits     - počet platných bitů v akumulátoru
+ * codeSize - aktuální velikost LZW kódu v bitech
+ * codeMask - maska aktuální velikosti LZW kódu ((1 << codeSize) - 1)
+ * fill     - funkce pro získání dalšího úseku dat (NULL pro jediný úsek)
+ * source   - zdroj dat předávaný funkci fill
+ */
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+    uint64_t buffer;
+    uint8_t bits;
+    uint8_t codeSize;
+    uint16_t codeMask;
+    tLZWFillFunction fill;
+    void *source;
+} tLZWBitReader;
+
+/*
+ * Funkce pro nastavení velikosti čtených LZW kódů
+ *
+ * reader   - čtečka LZW kódů
+ * codeSize - nová velikost kódu v bitech (1-12)
+ */
+static inline void setLZWCodeSize(tLZWBitReader *reader, uint8_t codeSize) {
+    // Uložení velikosti kódu
+    reader->codeSize = codeSize;
+    // Výpočet masky pro získání kódu z akumulátoru
+    reader->codeMask = (uint16_t)((1u << codeSize) - 1);
+}
+
+/*
+ * Funkce pro inicializaci čtečky LZW kódů nad souvislým úsekem dat
+ *
+ * reader   - čtečka LZW kódů
+ * data     - komprimovaná data
+ * length   - délka dat v bajtech
+ * codeSize - počáteční velikost kódu v bitech
+ */
+static inline void initLZWBitReader(tLZWBitReader *reader, const uint8_t *data, size_t length, uint8_t codeSize) {
+    // Nastavení čteného úseku dat
+    reader->data = data;
+    reader->length = length;
+    reader->position = 0;
+    // Vyprázdnění akumulátoru
+    reader->buffer = 0;
+    reader->bits = 0;
+    // Nastavení velikosti kódu
+    setLZWCodeSize(reader, codeSize);
+    // Čtečka pracuje s jediným úsekem dat
+    reader->fill = NULL;
+    reader->source = NULL;
+}
+
+/*
+ * Funkce pro inicializaci čtečky LZW kódů nad daty dodávanými po úsecích
+ *
+ * reader   - čtečka LZW kódů
+ * fill     - funkce pro získání dalšího úseku dat
+ * source   - zdroj dat předávaný funkci fill
+ * codeSize - počáteční velikost kódu v bitech
+ */
+static inline void initLZWStreamReader(tLZWBitReader *reader, tLZWFillFunction fill, void *source, uint8_t codeSize) {
+    // Zatím není načten žádný úsek dat
+    initLZWBitReader(reader, NULL, 0, codeSize);
+    // Nastavení zdroje dalších úseků
+    reader->fill = fill;
+    reader->source = source;
+}
+
+/*
+ * Funkce pro doplnění akumulátoru čtečky bajty z aktuálního úseku dat
+ *
+ * reader - čtečka LZW kódů
+ */
+static inline void refillLZWBitReader(tLZWBitReader *reader) {
+    // Rychlá cesta - v úseku zbývá alespoň 8 bajtů
+    if(reader->length - reader->position >= LZW_REFILL_BYTES) {
+        // Načtení 8 bajtů najednou
+        uint64_t word;
+        memcpy(&word, reader->data + reader->position, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        // Bitový proud GIF je little-endian
+        word = __builtin_bswap64(word);
+#endif
+        // Přidání nových bitů nad platné bity akumulátoru
+        reader->buffer |= word << reader->bits;
+        // Posun v datech o celé bajty, které se do akumulátoru vešly
+        reader->position += (size_t)((LZW_BIT_BUFFER_SIZE - 1 - reader->bits) >> 3);
+        // Akumulátor nyní obsahuje alespoň 56 platných bitů
+        reader->bits |= (LZW_BIT_BUFFER_SIZE - LZW_REFILL_BYTES);
+        return;
+    }
+    // Pomalá cesta na konci úseku - doplňování po bajtech
+    while(reader->bits <= (LZW_BIT_BUFFER_SIZE - LZW_REFILL_BYTES)) {
+        // Pokud je aktuální úsek vyčerpán
+        if(reader->position >= reader->length) {
+            // Bez zdroje dalších úseků doplňování končí
+            if(reader->fill == NULL) {
+                break;
+            }
+            // Vyžádání dalšího úseku dat
+            reader->length = reader->fill(reader->source, &reader->data);
+            reader->position = 0;
+            // Pokud další úsek neexistuje, data skončila
+            if(reader->length == 0) {
+                reader->fill = NULL;
+                break;
+            }
+            // Pokračuje se doplňováním z nového úseku
+            continue;
+        }
+        // Přidání jednoho bajtu nad platné bity akumulátoru
+        reader->buffer |= (uint64_t)reader->data[reader->position] << reader->bits;
+        // Posun na další bajt
+        reader->position++;
+        // Zvýšení počtu platných bitů
+        reader->bits += 8;
+    }
+}
+
+/*
+ * Funkce pro přečtení jednoho LZW kódu
+ *
+ * reader - čtečka LZW kódů
+ * code   - ukazatel pro uložení přečteného kódu
+ *
+ * Návratová hodnota:
+ *     1 - kód byl přečten
+ *     0 - v datech již nezbývá celý kód
+ */
+static inline int readLZWCode(tLZWBitReader *reader, uint16_t *code) {
+    // Pokud akumulátor neobsahuje celý kód, doplní se
+    if(reader->bits < reader->codeSize) {
+        // Doplnění akumulátoru
+        refillLZWBitReader(reader);
+        // Pokud ani po doplnění není k dispozici celý kód
+        if(reader->bits < reader->codeSize) {
+            return 0;
+        }
+    }
+    // Získání kódu jedním maskováním
+    *code = (uint16_t)(reader->buffer & reader->codeMask);
+    // Odstranění přečtených bitů z akumulátoru
+    reader->buffer >>= reader->codeSize;
+    reader->bits -= reader->codeSize;
+    // Kód byl přečten
+    return 1;
+}
+
+#endif
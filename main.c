@@ -1,314 +1,786 @@
-/*******************************************************************************
-*  Soubor:   main.c                                                            *
-*  Autor:    Radim Kubiš, xkubis03                                             *
-*  Vytvořen: 8. března 2014                                                    *
-*                                                                              *
-*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
-*                                                                              *
-*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
-*                   ----------------------------------------                   *
-*                                                                              *
-*  Demonstrační  aplikace  pro  knihovnu  gif2bmp. Provádí převod formátu GIF  *
-*  na BMP, navíc umožňuje zápis logovacího souboru s informacemi o provedeném  *
-*  převodu (původní a nová velikost souboru + login řešitele projektu).        *
-*                                                                              *
-*******************************************************************************/
-
-#include <ctype.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <getopt.h>
-#include <stdint.h>
-#include <inttypes.h>
-#include "gif2bmp.h"
-
-/*
- * Struktura vstupních argumentů
- */
-typedef struct {
-    // Počet vstupních argumentů programu
-    int argc;
-    // Pole vstupních argumentů programu
-    char **argv;
-
-    // Příznak zadaného přepínače -h
-    uint8_t helpFlag;
-
-    // Ukazatel pro název vstupního souboru
-    char *inputFileName;
-    // Ukazatel pro název výstupního souboru
-    char *outputFileName;
-    // Ukazatel pro název logovacího souboru
-    char *logFileName;
-
-    // Ukazatel pro vstupní soubor
-    FILE *inputFile;
-    // Ukazatel pro výstupní soubor
-    FILE *outputFile;
-    // Ukazatel pro logovací soubor
-    FILE *logFile;
-} tArguments;
-
-/*
- * Funkce pro výpis způsobu použití programu
- *
- * programName - název spouštěného programu
- */
-void printHelp(char *programName) {
-    // Tisk způsobu použití programu
-    fprintf(stdout, "Usage: %s [-i input_file] [-o output_file] [-l log_file] [-h]\n\n", programName);
-    fprintf(stdout, "  -h print help\n");
-    fprintf(stdout, "  -i input file name (GIF), default: stdin\n");
-    fprintf(stdout, "  -o output file name (BMP), default: stdout\n");
-    fprintf(stdout, "  -l log file name, default: without log file\n");
-}
-
-/*
- * Funkce pro zpracování vstupních argumentů příkazové řádky
- *
- * args - struktura argumentů programu
- */
-void parseArguments(tArguments *args) {
-    // Index do pole argumentů
-    int argIndex = 0;
-    // Proměnná pro aktuálně načtený přepínač
-    int actualChar = 0;
-
-    // Nastavení chybového kódu zpracování argumentů na bezchybný stav
-    opterr = 0;
-
-    // Procházení vstupních argumentů programu
-    while((actualChar = getopt(args->argc, args->argv, "i:o:l:h")) != -1) {
-        // Rozvětvení podle právě získaného přepínače
-        switch(actualChar) {
-            // Větev přepínače názvu vstupního souboru
-            case 'i': {
-                // Uložení názvu vstupního souboru
-                args->inputFileName = optarg;
-                // Konec větve
-                break;
-            }
-            // Větev přepínače názvu výstupního souboru
-            case 'o': {
-                // Uložení názvu výstupního souboru
-                args->outputFileName = optarg;
-                // Konec větve
-                break;
-            }
-            // Větev přepínače názvu logovacího souboru
-            case 'l': {
-                // Uložení názvu logovacího souboru
-                args->logFileName = optarg;
-                // Konec větve
-                break;
-            }
-            // Větev přepínače výpisu způsobu použití programu
-            case 'h': {
-                // Uložení přítomnosti příznaku výpisu nápovědy
-                args->helpFlag = 1;
-                // Konec větve
-                break;
-            }
-            // Větev neočekávaného vstupního argumentu
-            case '?': {
-                // Pokud je očekáván argument některého prřepínače
-                if(optopt == 'i' || optopt == 'o' || optopt == 'l') {
-                    // Výpis chyby
-                    fprintf(stderr, "Option -%c requires an argument.\n", optopt);
-                    // Výpis nápovědy
-                    printHelp(args->argv[0]);
-                    // Konec programu s chybou
-                    exit(EXIT_FAILURE);
-                } else if(isprint(optopt)) {
-                    // Pokud je přepínač tisknutelný znak
-
-                    // Výpis chyby
-                    fprintf(stderr, "Unknown option '-%c'.\n", optopt);
-                    // Výpis nápovědy
-                    printHelp(args->argv[0]);
-                    // Konec programu s chybou
-                    exit(EXIT_FAILURE);
-                } else {
-                    // Pokud je přepínač jiný
-
-                    // Tisk chyby
-                    fprintf(stderr, "Unknown option character '\\x%x'.\n", optopt);
-                    // Výpis nápovědy
-                    printHelp(args->argv[0]);
-                    // Konec programu s chybou
-                    exit(EXIT_FAILURE);
-                }
-            }
-            // Větev pro další neočekávané chování zpracování argumentů
-            default: {
-                // Tisk chyby
-                fprintf(stderr, "Unknown program argument error.\n");
-                // Výpis nápovědy
-                printHelp(args->argv[0]);
-                // Ukončení programu s chybou
-                exit(EXIT_FAILURE);
-            }
-        }
-    }
-
-    // Výpis dalších nezpracovaných argumentů programu
-    for(argIndex = optind; argIndex < args->argc; argIndex++) {
-        // Tisk chyby nezpracovaného argumentu
-        fprintf(stderr, "Non-option argument '%s'.\n", args->argv[argIndex]);
-    }
-
-    // Kontrola zda existovaly další nezpracované argumenty programu
-    if(optind < args->argc) {
-        // Výpis nápovědy
-        printHelp(args->argv[0]);
-        // Konec programu s chybou
-        exit(EXIT_FAILURE);
-    }
-}
-
-/*
- * Funkce pro úklid na konci programu
- *
- * args - struktura argumentů programu
- */
-void cleanUp(tArguments *args) {
-    // Pokud existoval vstupní soubor
-    if(args->inputFile != NULL && args->inputFile != stdin) {
-        // Uzavření souboru
-        fclose(args->inputFile);
-    }
-    // Pokud existoval výstupní soubor
-    if(args->outputFile != NULL && args->outputFile != stdout) {
-        // Uzavření souboru
-        fclose(args->outputFile);
-    }
-    // Pokud existoval logovací soubor
-    if(args->logFile != NULL) {
-        // Uzavření souboru
-        fclose(args->logFile);
-    }
-}
-
-/*
- * Funkce pro kontrolu vstupních argumentů, přepínaču a nastavení jejich
- * defaultních hodnot
- *
- * args - struktura argumentů programu
- */
-void checkArguments(tArguments *args) {
-    // Pokud byl zadán přepínač výpisu nápovědy
-    if(args->helpFlag == 1) {
-        // Výpis nápovědy
-        printHelp(args->argv[0]);
-        // Ukončení funkce/programu bez chyby
-        exit(EXIT_SUCCESS);
-    }
-    // Pokud nebyl zadán název vstupního souboru
-    if(args->inputFileName == NULL) {
-        // Vstupem bude standardní vstup programu
-        args->inputFile = stdin;
-    } else {
-        // Pokud byl název vstupního souboru zadán
-
-        // Otevření vstupního souboru
-        args->inputFile = fopen(args->inputFileName, "r");
-        // Pokud se nepodařilo vstupní soubor otevřít
-        if(args->inputFile == NULL) {
-            // Tisk chyby
-            fprintf(stderr, "Cannot open input file '%s' for read\n", args->inputFileName);
-            // Konec programu s chybou
-            exit(EXIT_FAILURE);
-        }
-    }
-    // Pokud nebyl zadán název výstupního souboru
-    if(args->outputFileName == NULL) {
-        // Výstupem bude standardní výstup programu
-        args->outputFile = stdout;
-    } else {
-        // Pokud byl název výstupního souboru zadán
-
-        // Otevření výstupního souboru
-        args->outputFile = fopen(args->outputFileName, "w");
-        // Pokud se nepodařilo výstupní soubor otevřít
-        if(args->outputFile == NULL) {
-            // Tisk chyby
-            fprintf(stderr, "Cannot open output file '%s' for write\n", args->outputFileName);
-            // Úklid
-            cleanUp(args);
-            // Konec programu s chybou
-            exit(EXIT_FAILURE);
-        }
-    }
-    // Pokud nebyl zadán název logovacího souboru
-    if(args->logFileName == NULL) {
-        // Nic se neděje
-    } else {
-        // Pokud byl název logovacího souboru zadán
-
-        // Otevření logovacího souboru
-        args->logFile = fopen(args->logFileName, "w");
-        // Pokud se nepodařilo logovací soubor otevřít
-        if(args->logFile == NULL) {
-            // Tisk chyby
-            fprintf(stderr, "Cannot open log file '%s' for write\n", args->outputFileName);
-            // Úklid
-            cleanUp(args);
-            // Konec programu s chybou
-            exit(EXIT_FAILURE);
-        }
-    }
-}
-
-/*
- * Funkce pro zápis výstupní zprávy
- *
- * args - struktura argumentů programu
- * info - struktura s informacemi o převodu
- */
-void writeLog(tArguments args, tGIF2BMP info) {
-    // Pokud je požadován logovací soubor
-    if(args.logFile != NULL) {
-        // Zápis loginu
-        fprintf(args.logFile, "login = %s\n", LOGIN);
-        // Zápis nové velikosti BMP
-        fprintf(args.logFile, "uncodedSize = %"PRId64"\n", info.bmpSize);
-        // Zápis původní velikosti GIF
-        fprintf(args.logFile, "codedSize = %"PRId64"\n", info.gifSize);
-    }
-}
-
-/*
- * Funkce main - hlavní funkce testovacího programu
- *
- * argc - počet vstupních parametrů příkazové řádky
- * argv - pole vstupních parametrů příkazové řádky
- *
- * Návratová hodnota:
- *      RETURN_SUCCESS  (0) - program proběhl v pořádku
- *      RETURN_FAILURE (-1) - program proběhl s chybou
- */
-int main(int argc, char *argv[]) {
-    // Proměnná pro ukládání aktuálního/chybového stavu programu
-    int programState = RETURN_SUCCESS;
-    // Inicializace struktury argumentů
-    tArguments args = {argc, argv, 0, NULL, NULL, NULL, NULL, NULL, NULL};
-    // Struktura informací o převodu
-    tGIF2BMP infoStruct = {0, 0};
-
-    // Zpracování vstupních argumentů programu
-    parseArguments(&args);
-    // Kontrola vstupních argumentů programu
-    checkArguments(&args);
-
-    // Převod vstupního souboru GIF na výstupní soubor BMP
-    programState = gif2bmp(&infoStruct, args.inputFile, args.outputFile);
-
-    // Zápis logu do souboru
-    writeLog(args, infoStruct);
-
-    // Úklid na konci programu
-    cleanUp(&args);
-
-    // Návratová hodnota programu/převodu
-    return programState;
-}
+/*******************************************************************************
+*  Soubor:   main.c                                                            *
+*  Autor:    Radim Kubiš, xkubis03                                             *
+*  Vytvořen: 8. března 2014                                                    *
+*                                                                              *
+*  Projekt do předmětu Kódování a komprese (KKO) 2014                          *
+*                                                                              *
+*                    KONVERZE OBRAZOVÉHO FORMÁTU GIF NA BMP                    *
+*                   ----------------------------------------                   *
+*                                                                              *
+*  Demonstrační  aplikace  pro  knihovnu  gif2bmp. Provádí převod formátu GIF  *
+*  na BMP, navíc umožňuje zápis logovacího souboru s informacemi o provedeném  *
+*  převodu (původní a nová velikost souboru + login řešitele projektu).        *
+*  V dávkovém režimu převádí seznam souborů (manifest nebo adresář) na více   *
+*  vláknech a zapisuje log pro každý převedený soubor.                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include "gif2bmp.h"
+#include "batch.h"
+
+/*
+ * Struktura vstupních argumentů
+ */
+typedef struct {
+    // Počet vstupních argumentů programu
+    int argc;
+    // Pole vstupních argumentů programu
+    char **argv;
+
+    // Příznak zadaného přepínače -h
+    uint8_t helpFlag;
+
+    // Ukazatel pro název vstupního souboru
+    char *inputFileName;
+    // Ukazatel pro název výstupního souboru
+    char *outputFileName;
+    // Ukazatel pro název logovacího souboru
+    char *logFileName;
+    // Ukazatel pro název souboru manifestu dávky
+    char *manifestFileName;
+    // Ukazatel pro název vstupního adresáře dávky
+    char *inputDirectory;
+    // Ukazatel pro název výstupního adresáře dávky
+    char *outputDirectory;
+    // Počet vláken dávky (0 - podle počtu procesorů)
+    unsigned threadCount;
+    // Příznak logu ve formátu JSON Lines
+    uint8_t jsonLog;
+    // Příznak zjištění informací o souborech bez převodu
+    uint8_t probe;
+    // Index prvního dalšího vstupního souboru zjištění informací v argv
+    int probeFileIndex;
+    // Nastavení převodu
+    tGIF2BMPOptions options;
+
+    // Ukazatel pro vstupní soubor
+    FILE *inputFile;
+    // Ukazatel pro výstupní soubor
+    FILE *outputFile;
+    // Ukazatel pro logovací soubor
+    FILE *logFile;
+} tArguments;
+
+/*
+ * Funkce pro výpis způsobu použití programu
+ *
+ * programName - název spouštěného programu
+ */
+void printHelp(char *programName) {
+    // Tisk způsobu použití programu
+    fprintf(stdout, "Usage: %s [-i input_file] [-o output_file] [-l log_file [-j]] [-f threads] [-p] [-s] [-M megabytes] [-h]\n", programName);
+    fprintf(stdout, "       %s -m manifest_file [-t threads] [-l log_file [-j]] [-p] [-M megabytes]\n", programName);
+    fprintf(stdout, "       %s -I input_dir -O output_dir [-t threads] [-l log_file [-j]] [-p] [-M megabytes]\n", programName);
+    fprintf(stdout, "       %s -P [-i input_file] [-o output_file] [input_file ...]\n\n", programName);
+    fprintf(stdout, "  -h print help\n");
+    fprintf(stdout, "  -i input file name (GIF), default: stdin\n");
+    fprintf(stdout, "  -o output file name (BMP), default: stdout\n");
+    fprintf(stdout, "  -l log file name, default: without log file\n");
+    fprintf(stdout, "  -j write one JSON record per converted file to the log (JSON Lines),\n");
+    fprintf(stdout, "     appended to an existing log in batch mode, overwriting it for a single file\n");
+    fprintf(stdout, "  -f number of threads decoding animation frames, default: 1\n");
+    fprintf(stdout, "  -p palettized 8/4/1 bpp output when all frames share one color table\n");
+    fprintf(stdout, "  -s stream a top-down BMP while decoding a single full-screen non-interlaced frame\n");
+    fprintf(stdout, "     (a failed conversion leaves the rows written so far in the output file)\n");
+    fprintf(stdout, "  -M image memory budget of one conversion in MiB (fails when exceeded), default: unlimited\n");
+    fprintf(stdout, "  -m batch manifest file (one 'input<TAB>output' pair per line)\n");
+    fprintf(stdout, "  -I batch input directory (all *.gif files)\n");
+    fprintf(stdout, "  -O batch output directory (*.bmp files with the same names)\n");
+    fprintf(stdout, "  -t number of batch worker threads, default: number of CPUs\n");
+    fprintf(stdout, "  -P probe only: write one JSON line per input file with dimensions, color table sizes\n");
+    fprintf(stdout, "     and frame rectangles, delays and disposal methods, without decoding image data\n");
+}
+
+/*
+ * Funkce pro zpracování vstupních argumentů příkazové řádky
+ *
+ * args - struktura argumentů programu
+ */
+void parseArguments(tArguments *args) {
+    // Index do pole argumentů
+    int argIndex = 0;
+    // Proměnná pro aktuálně načtený přepínač
+    int actualChar = 0;
+
+    // Nastavení chybového kódu zpracování argumentů na bezchybný stav
+    opterr = 0;
+
+    // Procházení vstupních argumentů programu
+    while((actualChar = getopt(args->argc, args->argv, "i:o:l:m:I:O:t:f:M:jpPsh")) != -1) {
+        // Rozvětvení podle právě získaného přepínače
+        switch(actualChar) {
+            // Větev přepínače názvu vstupního souboru
+            case 'i': {
+                // Uložení názvu vstupního souboru
+                args->inputFileName = optarg;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače názvu výstupního souboru
+            case 'o': {
+                // Uložení názvu výstupního souboru
+                args->outputFileName = optarg;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače názvu logovacího souboru
+            case 'l': {
+                // Uložení názvu logovacího souboru
+                args->logFileName = optarg;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače souboru manifestu dávky
+            case 'm': {
+                // Uložení názvu souboru manifestu
+                args->manifestFileName = optarg;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače vstupního adresáře dávky
+            case 'I': {
+                // Uložení názvu vstupního adresáře
+                args->inputDirectory = optarg;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače výstupního adresáře dávky
+            case 'O': {
+                // Uložení názvu výstupního adresáře
+                args->outputDirectory = optarg;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače počtu vláken dávky
+            case 't': {
+                // Ukazatel za načtené číslo
+                char *end = NULL;
+                // Převod počtu vláken
+                long threadCount = strtol(optarg, &end, 10);
+                // Kontrola počtu vláken
+                if(*optarg == '\0' || *end != '\0' || threadCount < 1 || threadCount > BATCH_MAX_THREADS) {
+                    // Výpis chyby
+                    fprintf(stderr, "Invalid number of threads '%s'.\n", optarg);
+                    // Konec programu s chybou
+                    exit(EXIT_FAILURE);
+                }
+                // Uložení počtu vláken
+                args->threadCount = (unsigned)threadCount;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače počtu vláken dekódování bloků
+            case 'f': {
+                // Ukazatel za načtené číslo
+                char *end = NULL;
+                // Převod počtu vláken
+                long frameThreads = strtol(optarg, &end, 10);
+                // Kontrola počtu vláken
+                if(*optarg == '\0' || *end != '\0' || frameThreads < 1 || frameThreads > FRAME_DECODER_MAX_THREADS) {
+                    // Výpis chyby
+                    fprintf(stderr, "Invalid number of frame threads '%s'.\n", optarg);
+                    // Konec programu s chybou
+                    exit(EXIT_FAILURE);
+                }
+                // Uložení počtu vláken
+                args->options.frameThreads = (unsigned)frameThreads;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače rozpočtu paměti
+            case 'M': {
+                // Ukazatel za načtené číslo
+                char *end = NULL;
+                // Převod rozpočtu v MiB
+                unsigned long long megabytes = strtoull(optarg, &end, 10);
+                // Kontrola rozpočtu
+                if(*optarg == '\0' || *optarg == '-' || *end != '\0' || megabytes < 1 || megabytes > (UINT64_MAX >> 20)) {
+                    // Výpis chyby
+                    fprintf(stderr, "Invalid memory budget '%s'.\n", optarg);
+                    // Konec programu s chybou
+                    exit(EXIT_FAILURE);
+                }
+                // Uložení rozpočtu v bajtech
+                args->options.memoryLimit = (uint64_t)megabytes << 20;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače logu ve formátu JSON Lines
+            case 'j': {
+                // Uložení požadavku na log ve formátu JSON
+                args->jsonLog = FLAG_TRUE;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače paletového výstupu
+            case 'p': {
+                // Uložení požadavku na paletový výstup
+                args->options.palettized = FLAG_TRUE;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače zjištění informací bez převodu
+            case 'P': {
+                // Uložení požadavku na zjištění informací
+                args->probe = FLAG_TRUE;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače průběžného zápisu
+            case 's': {
+                // Uložení požadavku na průběžný zápis řádků shora dolů
+                args->options.streaming = FLAG_TRUE;
+                // Konec větve
+                break;
+            }
+            // Větev přepínače výpisu způsobu použití programu
+            case 'h': {
+                // Uložení přítomnosti příznaku výpisu nápovědy
+                args->helpFlag = 1;
+                // Konec větve
+                break;
+            }
+            // Větev neočekávaného vstupního argumentu
+            case '?': {
+                // Pokud je očekáván argument některého prřepínače
+                if(optopt == 'i' || optopt == 'o' || optopt == 'l' || optopt == 'm' || optopt == 'I' || optopt == 'O' || optopt == 't' || optopt == 'f' || optopt == 'M') {
+                    // Výpis chyby
+                    fprintf(stderr, "Option -%c requires an argument.\n", optopt);
+                    // Výpis nápovědy
+                    printHelp(args->argv[0]);
+                    // Konec programu s chybou
+                    exit(EXIT_FAILURE);
+                } else if(isprint(optopt)) {
+                    // Pokud je přepínač tisknutelný znak
+
+                    // Výpis chyby
+                    fprintf(stderr, "Unknown option '-%c'.\n", optopt);
+                    // Výpis nápovědy
+                    printHelp(args->argv[0]);
+                    // Konec programu s chybou
+                    exit(EXIT_FAILURE);
+                } else {
+                    // Pokud je přepínač jiný
+
+                    // Tisk chyby
+                    fprintf(stderr, "Unknown option character '\\x%x'.\n", optopt);
+                    // Výpis nápovědy
+                    printHelp(args->argv[0]);
+                    // Konec programu s chybou
+                    exit(EXIT_FAILURE);
+                }
+            }
+            // Větev pro další neočekávané chování zpracování argumentů
+            default: {
+                // Tisk chyby
+                fprintf(stderr, "Unknown program argument error.\n");
+                // Výpis nápovědy
+                printHelp(args->argv[0]);
+                // Ukončení programu s chybou
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    // Při zjištění informací jsou další argumenty vstupní soubory
+    args->probeFileIndex = optind;
+    if(args->probe == FLAG_TRUE) {
+        return;
+    }
+
+    // Výpis dalších nezpracovaných argumentů programu
+    for(argIndex = optind; argIndex < args->argc; argIndex++) {
+        // Tisk chyby nezpracovaného argumentu
+        fprintf(stderr, "Non-option argument '%s'.\n", args->argv[argIndex]);
+    }
+
+    // Kontrola zda existovaly další nezpracované argumenty programu
+    if(optind < args->argc) {
+        // Výpis nápovědy
+        printHelp(args->argv[0]);
+        // Konec programu s chybou
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Funkce pro zjištění, zda byl zadán dávkový režim
+ *
+ * args - struktura argumentů programu
+ *
+ * Návratová hodnota:
+ *     1 - dávkový režim
+ *     0 - převod jednoho souboru
+ */
+int isBatchMode(tArguments *args) {
+    // Dávkový režim určuje manifest nebo některý z adresářů
+    return args->manifestFileName != NULL || args->inputDirectory != NULL || args->outputDirectory != NULL;
+}
+
+/*
+ * Funkce pro úklid na konci programu
+ *
+ * args - struktura argumentů programu
+ */
+void cleanUp(tArguments *args) {
+    // Pokud existoval vstupní soubor
+    if(args->inputFile != NULL && args->inputFile != stdin) {
+        // Uzavření souboru
+        fclose(args->inputFile);
+    }
+    // Pokud existoval výstupní soubor
+    if(args->outputFile != NULL && args->outputFile != stdout) {
+        // Uzavření souboru
+        fclose(args->outputFile);
+    }
+    // Pokud existoval logovací soubor
+    if(args->logFile != NULL) {
+        // Uzavření souboru
+        fclose(args->logFile);
+    }
+}
+
+/*
+ * Funkce pro kontrolu vstupních argumentů, přepínaču a nastavení jejich
+ * defaultních hodnot
+ *
+ * args - struktura argumentů programu
+ */
+void checkArguments(tArguments *args) {
+    // Pokud byl zadán přepínač výpisu nápovědy
+    if(args->helpFlag == 1) {
+        // Výpis nápovědy
+        printHelp(args->argv[0]);
+        // Ukončení funkce/programu bez chyby
+        exit(EXIT_SUCCESS);
+    }
+    // Zjištění informací nelze kombinovat s dávkovým režimem
+    if(args->probe == FLAG_TRUE && isBatchMode(args)) {
+        // Tisk chyby
+        fprintf(stderr, "Probe mode cannot be combined with batch mode.\n");
+        // Výpis nápovědy
+        printHelp(args->argv[0]);
+        // Konec programu s chybou
+        exit(EXIT_FAILURE);
+    }
+    // Zjištění informací nelze kombinovat s přepínači převodu
+    if(args->probe == FLAG_TRUE &&
+       (args->options.streaming == FLAG_TRUE || args->options.palettized == FLAG_TRUE || args->options.memoryLimit > 0 ||
+        args->options.frameThreads > 0 || args->logFileName != NULL || args->jsonLog == FLAG_TRUE)) {
+        // Tisk chyby
+        fprintf(stderr, "Probe mode cannot be combined with conversion options (-s, -p, -M, -f, -l, -j).\n");
+        // Výpis nápovědy
+        printHelp(args->argv[0]);
+        // Konec programu s chybou
+        exit(EXIT_FAILURE);
+    }
+    // Pokud byl zadán dávkový režim
+    if(isBatchMode(args)) {
+        // Dávka se zadává buď manifestem, nebo dvojicí adresářů,
+        // a nelze ji kombinovat s převodem jednoho souboru
+        if(args->inputFileName != NULL || args->outputFileName != NULL ||
+           (args->manifestFileName != NULL && (args->inputDirectory != NULL || args->outputDirectory != NULL)) ||
+           (args->manifestFileName == NULL && (args->inputDirectory == NULL || args->outputDirectory == NULL))) {
+            // Tisk chyby
+            fprintf(stderr, "Batch mode requires either -m, or both -I and -O (without -i/-o).\n");
+            // Výpis nápovědy
+            printHelp(args->argv[0]);
+            // Konec programu s chybou
+            exit(EXIT_FAILURE);
+        }
+    }
+    // Pokud nebyl zadán název vstupního souboru
+    // (v dávkovém režimu zůstanou standardní vstup a výstup nevyužity)
+    if(args->inputFileName == NULL) {
+        // Vstupem bude standardní vstup programu
+        args->inputFile = stdin;
+    } else if(args->probe == FLAG_TRUE) {
+        // Při zjištění informací se soubor otevře až při jeho zpracování
+        // (soubor, který nelze otevřít, má vlastní záznam)
+    } else {
+        // Pokud byl název vstupního souboru zadán
+
+        // Otevření vstupního souboru
+        args->inputFile = fopen(args->inputFileName, "r");
+        // Pokud se nepodařilo vstupní soubor otevřít
+        if(args->inputFile == NULL) {
+            // Tisk chyby
+            fprintf(stderr, "Cannot open input file '%s' for read\n", args->inputFileName);
+            // Konec programu s chybou
+            exit(EXIT_FAILURE);
+        }
+    }
+    // Pokud nebyl zadán název výstupního souboru
+    if(args->outputFileName == NULL) {
+        // Výstupem bude standardní výstup programu
+        args->outputFile = stdout;
+    } else {
+        // Pokud byl název výstupního souboru zadán
+
+        // Otevření výstupního souboru
+        args->outputFile = fopen(args->outputFileName, "w");
+        // Pokud se nepodařilo výstupní soubor otevřít
+        if(args->outputFile == NULL) {
+            // Tisk chyby
+            fprintf(stderr, "Cannot open output file '%s' for write\n", args->outputFileName);
+            // Úklid
+            cleanUp(args);
+            // Konec programu s chybou
+            exit(EXIT_FAILURE);
+        }
+    }
+    // Pokud nebyl zadán název logovacího souboru
+    if(args->logFileName == NULL) {
+        // Nic se neděje
+    } else {
+        // Pokud byl název logovacího souboru zadán
+
+        // Otevření logovacího souboru (záznamy JSON Lines dávky se připojují
+        // za dříve zapsané záznamy, převod jednoho souboru log přepíše)
+        args->logFile = fopen(args->logFileName, (args->jsonLog == FLAG_TRUE && isBatchMode(args)) ? "a" : "w");
+        // Pokud se nepodařilo logovací soubor otevřít
+        if(args->logFile == NULL) {
+            // Tisk chyby
+            fprintf(stderr, "Cannot open log file '%s' for write\n", args->outputFileName);
+            // Úklid
+            cleanUp(args);
+            // Konec programu s chybou
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/*
+ * Funkce pro zápis výstupní zprávy
+ *
+ * args - struktura argumentů programu
+ * info - struktura s informacemi o převodu
+ */
+void writeLog(tArguments args, tGIF2BMP info) {
+    // Pokud je požadován logovací soubor
+    if(args.logFile != NULL) {
+        // Zápis loginu
+        fprintf(args.logFile, "login = %s\n", LOGIN);
+        // Zápis nové velikosti BMP
+        fprintf(args.logFile, "uncodedSize = %"PRId64"\n", info.bmpSize);
+        // Zápis původní velikosti GIF
+        fprintf(args.logFile, "codedSize = %"PRId64"\n", info.gifSize);
+        // Zápis časů fází převodu v sekundách
+        fprintf(args.logFile, "headerTime = %.6f\n", info.headerTime);
+        fprintf(args.logFile, "decodeTime = %.6f\n", info.decodeTime);
+        fprintf(args.logFile, "composeTime = %.6f\n", info.composeTime);
+        fprintf(args.logFile, "writeTime = %.6f\n", info.writeTime);
+        // Zápis čítačů dekodéru
+        fprintf(args.logFile, "codes = %"PRIu64"\n", info.codes);
+        fprintf(args.logFile, "clearCodes = %"PRIu64"\n", info.clearCodes);
+        fprintf(args.logFile, "dictionaryResets = %"PRIu64"\n", info.dictionaryResets);
+        fprintf(args.logFile, "frames = %"PRIu32"\n", info.frames);
+        fprintf(args.logFile, "subBlocks = %"PRIu64"\n", info.subBlocks);
+        fprintf(args.logFile, "skippedBytes = %"PRIu64"\n", info.skippedBytes);
+    }
+}
+
+/*
+ * Funkce pro zápis řetězce jako řetězcové hodnoty JSON
+ *
+ * file   - výstupní soubor
+ * string - zapisovaný řetězec (NULL se zapíše jako null)
+ */
+void writeJSONString(FILE *file, const char *string) {
+    // Chybějící řetězec
+    if(string == NULL) {
+        fputs("null", file);
+        return;
+    }
+    // Řetězec v uvozovkách s escapovanými znaky
+    fputc('"', file);
+    for(const unsigned char *actual = (const unsigned char*)string; *actual != '\0'; actual++) {
+        if(*actual == '"' || *actual == '\\') {
+            // Uvozovky a zpětné lomítko
+            fputc('\\', file);
+            fputc(*actual, file);
+        } else if(*actual < 0x20) {
+            // Řídicí znaky
+            fprintf(file, "\\u%04x", *actual);
+        } else {
+            // Ostatní znaky beze změny
+            fputc(*actual, file);
+        }
+    }
+    fputc('"', file);
+}
+
+/*
+ * Funkce pro zápis záznamu o převodu jako jednoho řádku JSON (JSON Lines)
+ *
+ * args     - struktura argumentů programu
+ * fileName - název vstupního souboru (NULL pro standardní vstup)
+ * info     - struktura s informacemi o převodu
+ * result   - výsledek převodu
+ */
+void writeJSONLog(tArguments args, const char *fileName, tGIF2BMP info, int result) {
+    // Pokud je požadován logovací soubor
+    if(args.logFile != NULL) {
+        // Login, vstupní soubor a výsledek převodu
+        fprintf(args.logFile, "{\"login\":\"%s\",\"file\":", LOGIN);
+        writeJSONString(args.logFile, fileName);
+        fprintf(args.logFile, ",\"ok\":%s", result == RETURN_SUCCESS ? "true" : "false");
+        // Velikosti souborů a rozměry obrazu
+        fprintf(args.logFile, ",\"uncodedSize\":%"PRId64",\"codedSize\":%"PRId64, info.bmpSize, info.gifSize);
+        fprintf(args.logFile, ",\"width\":%"PRIu32",\"height\":%"PRIu32, info.width, info.height);
+        // Bloky, tabulky barev a prokládání
+        fprintf(args.logFile, ",\"frames\":%"PRIu32",\"gctSize\":%u,\"localTables\":%"PRIu32",\"lctMaxSize\":%u,\"interlacedFrames\":%"PRIu32,
+                info.frames, (unsigned)info.gctSize, info.localTables, (unsigned)info.lctMaxSize, info.interlacedFrames);
+        // Časy fází převodu v sekundách
+        fprintf(args.logFile, ",\"headerTime\":%.6f,\"decodeTime\":%.6f,\"composeTime\":%.6f,\"writeTime\":%.6f",
+                info.headerTime, info.decodeTime, info.composeTime, info.writeTime);
+        // Čítače dekodéru
+        fprintf(args.logFile, ",\"codes\":%"PRIu64",\"clearCodes\":%"PRIu64",\"dictionaryResets\":%"PRIu64,
+                info.codes, info.clearCodes, info.dictionaryResets);
+        fprintf(args.logFile, ",\"subBlocks\":%"PRIu64",\"skippedBytes\":%"PRIu64, info.subBlocks, info.skippedBytes);
+        // Nejvyšší obsazená paměť obrazových dat a celého převodu
+        fprintf(args.logFile, ",\"canvasPeak\":%"PRIu64",\"peakMemory\":%"PRId64"}\n", info.canvasPeak, info.peakMemory);
+    }
+}
+
+/*
+ * Funkce pro zápis zjištěných informací o souboru jako jednoho řádku JSON
+ *
+ * file     - výstupní soubor
+ * fileName - název vstupního souboru (NULL pro standardní vstup)
+ * probe    - zjištěné informace
+ * result   - výsledek zjištění
+ */
+void writeJSONProbe(FILE *file, const char *fileName, const tGIFProbe *probe, int result) {
+    // Vstupní soubor a výsledek
+    fputs("{\"file\":", file);
+    writeJSONString(file, fileName);
+    fprintf(file, ",\"ok\":%s", result == RETURN_SUCCESS ? "true" : "false");
+    // Informace z hlavičky
+    fprintf(file, ",\"codedSize\":%"PRIu64",\"width\":%u,\"height\":%u,\"gctSize\":%u,\"bgColorIndex\":%u",
+            probe->gifSize, (unsigned)probe->width, (unsigned)probe->height, (unsigned)probe->gctSize, (unsigned)probe->bgColorIndex);
+    // Popisy image bloků
+    fprintf(file, ",\"frameCount\":%"PRIu32",\"frames\":[", probe->frameCount);
+    for(uint32_t index = 0; index < probe->frameCount; index++) {
+        const tGIFProbeFrame *frame = &probe->frames[index];
+        fprintf(file, "%s{\"left\":%u,\"top\":%u,\"width\":%u,\"height\":%u,\"lctSize\":%u,\"interlaced\":%s",
+                index > 0 ? "," : "", (unsigned)frame->left, (unsigned)frame->top, (unsigned)frame->width, (unsigned)frame->height,
+                (unsigned)frame->lctSize, frame->interlaced == FLAG_TRUE ? "true" : "false");
+        fprintf(file, ",\"minimumCodeSize\":%u,\"dataSize\":%"PRIu64",\"delay\":%u,\"disposal\":%u,\"transparentIndex\":%d}",
+                (unsigned)frame->minimumCodeSize, frame->dataSize, (unsigned)frame->delay, (unsigned)frame->disposal, (int)frame->transparentIndex);
+    }
+    fputs("]}\n", file);
+}
+
+/*
+ * Funkce pro zjištění informací o jednom souboru a jejich zápis
+ *
+ * args      - struktura argumentů programu
+ * fileName  - název vstupního souboru (NULL pro standardní vstup)
+ * inputFile - vstupní soubor (NULL - soubor nelze otevřít)
+ *
+ * Návratová hodnota:
+ *      RETURN_SUCCESS  (0) - informace byly zjištěny
+ *      RETURN_FAILURE (-1) - soubor nelze otevřít nebo je chybný
+ */
+int probeFile(tArguments args, const char *fileName, FILE *inputFile) {
+    // Zjištěné informace (prázdné pro neotevřený soubor)
+    tGIFProbe probe = {0, 0, 0, 0, NULL, 0, 0, 0, FLAG_FALSE};
+    // Proměnná pro výsledek zjištění
+    int result = RETURN_FAILURE;
+
+    // Zjištění informací o otevřeném souboru
+    if(inputFile != NULL) {
+        result = gif2bmpProbe(&probe, inputFile);
+    }
+    // Zápis záznamu (i pro chybný soubor)
+    writeJSONProbe(args.outputFile, fileName, &probe, result);
+    // Uvolnění zjištěných informací
+    freeGIFProbe(&probe);
+
+    // Navrácení výsledku zjištění
+    return result;
+}
+
+/*
+ * Funkce pro otevření pojmenovaného souboru, zjištění informací o něm
+ * a jejich zápis
+ *
+ * args     - struktura argumentů programu
+ * fileName - název vstupního souboru
+ *
+ * Návratová hodnota:
+ *      RETURN_SUCCESS  (0) - informace byly zjištěny
+ *      RETURN_FAILURE (-1) - soubor nelze otevřít nebo je chybný
+ */
+int probeNamedFile(tArguments args, const char *fileName) {
+    // Proměnná pro výsledek zjištění
+    int result = RETURN_FAILURE;
+    // Otevření souboru
+    FILE *inputFile = fopen(fileName, "rb");
+    if(inputFile == NULL) {
+        fprintf(stderr, "Cannot open input file '%s' for read\n", fileName);
+    }
+    // Zjištění informací (i pro neotevřený soubor)
+    result = probeFile(args, fileName, inputFile);
+    // Uzavření souboru
+    if(inputFile != NULL) {
+        fclose(inputFile);
+    }
+    return result;
+}
+
+/*
+ * Funkce pro zjištění informací o vstupních souborech bez převodu
+ *
+ * Zpracuje se soubor přepínače -i a všechny další argumenty, bez nich
+ * standardní vstup. Pro každý soubor se zapíše jeden řádek JSON.
+ *
+ * args - struktura argumentů programu
+ *
+ * Návratová hodnota:
+ *      RETURN_SUCCESS  (0) - informace o všech souborech byly zjištěny
+ *      RETURN_FAILURE (-1) - některý soubor nelze otevřít nebo je chybný
+ */
+int runProbeMode(tArguments args) {
+    // Proměnná pro výsledek všech souborů
+    int result = RETURN_SUCCESS;
+
+    // Soubor přepínače -i, bez dalších argumentů standardní vstup
+    if(args.inputFileName != NULL) {
+        result = probeNamedFile(args, args.inputFileName);
+    } else if(args.probeFileIndex >= args.argc) {
+        result = probeFile(args, NULL, args.inputFile);
+    }
+    // Další vstupní soubory
+    for(int argIndex = args.probeFileIndex; argIndex < args.argc; argIndex++) {
+        if(probeNamedFile(args, args.argv[argIndex]) != RETURN_SUCCESS) {
+            result = RETURN_FAILURE;
+        }
+    }
+
+    // Navrácení výsledku všech souborů
+    return result;
+}
+
+/*
+ * Funkce pro převod dávky souborů
+ *
+ * Log obsahuje pro každý soubor dávky (v pořadí manifestu, příp. podle
+ * názvu) řádek se vstupním souborem následovaný záznamem ve stejném
+ * formátu jako při převodu jednoho souboru, příp. jeden řádek JSON
+ * se vstupním souborem.
+ *
+ * args - struktura argumentů programu
+ *
+ * Návratová hodnota:
+ *      RETURN_SUCCESS  (0) - všechny převody proběhly v pořádku
+ *      RETURN_FAILURE (-1) - chyba načtení dávky nebo některého převodu
+ */
+int runBatchMode(tArguments args) {
+    // Dávka souborů
+    tBatch batch = {NULL, 0, 0};
+    // Proměnná pro výsledek dávky
+    int result = RETURN_SUCCESS;
+
+    // Načtení dávky z manifestu nebo z adresáře
+    if(args.manifestFileName != NULL) {
+        result = loadBatchManifest(&batch, args.manifestFileName);
+    } else {
+        result = loadBatchDirectory(&batch, args.inputDirectory, args.outputDirectory);
+    }
+
+    // Převod dávky
+    if(result == RETURN_SUCCESS) {
+        result = runBatch(&batch, args.threadCount, &args.options);
+
+        // Zápis logu pro každý soubor dávky
+        for(size_t job = 0; job < batch.count; job++) {
+            // Záznam ve formátu JSON Lines obsahuje i vstupní soubor
+            if(args.jsonLog == FLAG_TRUE) {
+                writeJSONLog(args, batch.jobs[job].inputFileName, batch.jobs[job].info, batch.jobs[job].result);
+                continue;
+            }
+            // Pokud je požadován logovací soubor
+            if(args.logFile != NULL) {
+                // Zápis vstupního souboru
+                fprintf(args.logFile, "file = %s\n", batch.jobs[job].inputFileName);
+            }
+            // Zápis záznamu o převodu
+            writeLog(args, batch.jobs[job].info);
+        }
+    }
+
+    // Uvolnění dávky
+    freeBatch(&batch);
+
+    // Navrácení výsledku dávky
+    return result;
+}
+
+/*
+ * Funkce main - hlavní funkce testovacího programu
+ *
+ * argc - počet vstupních parametrů příkazové řádky
+ * argv - pole vstupních parametrů příkazové řádky
+ *
+ * Návratová hodnota:
+ *      RETURN_SUCCESS  (0) - program proběhl v pořádku
+ *      RETURN_FAILURE (-1) - program proběhl s chybou
+ */
+int main(int argc, char *argv[]) {
+    // Proměnná pro ukládání aktuálního/chybového stavu programu
+    int programState = RETURN_SUCCESS;
+    // Inicializace struktury argumentů
+    tArguments args = {argc, argv, 0, NULL, NULL, NULL, NULL, NULL, NULL, 0, FLAG_FALSE, FLAG_FALSE, 0, {0}, NULL, NULL, NULL};
+    // Struktura informací o převodu
+    tGIF2BMP infoStruct = {0};
+
+    // Zpracování vstupních argumentů programu
+    parseArguments(&args);
+    // Kontrola vstupních argumentů programu
+    checkArguments(&args);
+
+    // Pokud bylo zadáno zjištění informací bez převodu
+    if(args.probe == FLAG_TRUE) {
+        // Zjištění informací o všech vstupních souborech
+        programState = runProbeMode(args);
+        // Úklid na konci programu
+        cleanUp(&args);
+        // Návratová hodnota programu
+        return programState;
+    }
+
+    // Pokud byl zadán dávkový režim
+    if(isBatchMode(&args)) {
+        // Převod celé dávky
+        programState = runBatchMode(args);
+        // Úklid na konci programu
+        cleanUp(&args);
+        // Návratová hodnota programu/dávky
+        return programState;
+    }
+
+    // Převod vstupního souboru GIF na výstupní soubor BMP
+    programState = gif2bmpOptions(&infoStruct, args.inputFile, args.outputFile, &args.options);
+
+    // Zápis logu do souboru
+    if(args.jsonLog == FLAG_TRUE) {
+        writeJSONLog(args, args.inputFileName, infoStruct, programState);
+    } else {
+        writeLog(args, infoStruct);
+    }
+
+    // Úklid na konci programu
+    cleanUp(&args);
+
+    // Návratová hodnota programu/převodu
+    return programState;
+}